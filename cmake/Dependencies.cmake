@@ -26,6 +26,10 @@ find_package( GLUT REQUIRED )
 include_directories(SYSTEM ${GLUT_INCLUDE_DIRS})
 list(APPEND ilqgames_LIBRARIES ${GLUT_LIBRARIES})
 
+# Find threads, for asynchronous solves.
+find_package( Threads REQUIRED )
+list(APPEND ilqgames_LIBRARIES ${CMAKE_THREAD_LIBS_INIT})
+
 # Find GLFW.
 #find_package(PkgConfig REQUIRED)
 #pkg_search_module(GLFW3 REQUIRED glfw)
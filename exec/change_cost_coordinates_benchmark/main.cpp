@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// Benchmark for changing cost coordinates in concatenated flat systems with
+// varying numbers of players.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/dynamics/concatenated_flat_system.h>
+#include <ilqgames/dynamics/single_player_flat_car_6d.h>
+#include <ilqgames/dynamics/single_player_flat_unicycle_4d.h>
+#include <ilqgames/utils/quadratic_cost_approximation.h>
+#include <ilqgames/utils/types.h>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Benchmark parameters.
+DEFINE_int32(min_players, 2, "Minimum number of players.");
+DEFINE_int32(max_players, 8, "Maximum number of players.");
+DEFINE_int32(num_trials, 1000, "Number of calls to time for each system.");
+
+namespace {
+using namespace ilqgames;
+
+// Time step (irrelevant to this benchmark, but required by the system).
+static constexpr Time kTimeStep = 0.1;
+
+// Create a concatenated flat system alternating unicycles and cars.
+ConcatenatedFlatSystem MakeSystem(PlayerIndex num_players) {
+  FlatSubsystemList subsystems;
+  for (PlayerIndex ii = 0; ii < num_players; ii++) {
+    if (ii % 2 == 0)
+      subsystems.push_back(std::make_shared<SinglePlayerFlatUnicycle4D>());
+    else
+      subsystems.push_back(std::make_shared<SinglePlayerFlatCar6D>(1.0));
+  }
+
+  return ConcatenatedFlatSystem(subsystems, kTimeStep);
+}
+
+// Time changing coordinates for the given system, and return mean time per
+// call in microseconds.
+double TimeChangeCostCoordinates(const ConcatenatedFlatSystem& system) {
+  // Pick a linear system state with nonzero velocities for each subsystem.
+  // NOTE: both flat subsystems store x-velocity at the same index.
+  VectorXf xi(VectorXf::Random(system.XDim()));
+  CHECK_EQ(SinglePlayerFlatUnicycle4D::kVxIdx, SinglePlayerFlatCar6D::kVxIdx);
+  for (PlayerIndex ii = 0; ii < system.NumPlayers(); ii++)
+    xi(system.SubsystemStartDim(ii) + SinglePlayerFlatUnicycle4D::kVxIdx) +=
+        2.0;
+
+  // Random quadratic costs for each player.
+  std::vector<QuadraticCostApproximation> original;
+  for (PlayerIndex ii = 0; ii < system.NumPlayers(); ii++) {
+    original.emplace_back(system.XDim());
+    const MatrixXf root(MatrixXf::Random(system.XDim(), system.XDim()));
+    original.back().state.hess = root.transpose() * root;
+    original.back().state.grad = VectorXf::Random(system.XDim());
+    original.back().control.emplace(
+        ii, SingleCostApproximation(system.UDim(ii), 1.0));
+  }
+
+  // Time only the coordinate change, not copying costs, reusing the same
+  // buffers each time.
+  CostCoordinateBuffers buffers;
+  std::vector<QuadraticCostApproximation> q(original);
+  std::chrono::duration<double> elapsed(0.0);
+  for (int kk = 0; kk < FLAGS_num_trials; kk++) {
+    q = original;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    system.ChangeCostCoordinates(xi, &q, &buffers);
+    elapsed += std::chrono::high_resolution_clock::now() - start;
+  }
+
+  return 1e6 * elapsed.count() / static_cast<double>(FLAGS_num_trials);
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  FLAGS_logtostderr = true;
+
+  CHECK_GT(FLAGS_min_players, 0);
+  CHECK_LE(FLAGS_min_players, FLAGS_max_players);
+  CHECK_GT(FLAGS_num_trials, 0);
+
+  for (int num_players = FLAGS_min_players; num_players <= FLAGS_max_players;
+       num_players++) {
+    const ConcatenatedFlatSystem system = MakeSystem(num_players);
+    std::cout << num_players << " players (" << system.XDim()
+              << " states): " << TimeChangeCostCoordinates(system)
+              << " us per call" << std::endl;
+  }
+
+  return 0;
+}
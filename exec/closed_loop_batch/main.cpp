@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Headless batch of closed-loop receding horizon simulations of the three
+// player intersection example, from randomly perturbed initial positions.
+// Runs concurrently, either on worker threads or in sharded worker processes,
+// and writes a single summary file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/dynamics/single_player_car_6d.h>
+#include <ilqgames/dynamics/single_player_unicycle_4d.h>
+#include <ilqgames/examples/closed_loop_batch_runner.h>
+#include <ilqgames/examples/receding_horizon_simulator.h>
+#include <ilqgames/examples/sharded_batch_runner.h>
+#include <ilqgames/examples/three_player_intersection_example.h>
+#include <ilqgames/solver/solver_params.h>
+#include <ilqgames/solver/top_down_renderable_problem.h>
+#include <ilqgames/utils/types.h>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Batch parameters.
+DEFINE_int32(num_scenarios, 100, "Number of scenarios to simulate.");
+DEFINE_int32(num_threads, 0, "Number of worker threads (0 for all cores).");
+DEFINE_int32(num_processes, 0,
+             "If positive, number of worker processes among which to shard "
+             "scenarios, isolating crashes, instead of worker threads.");
+DEFINE_int32(shard_size, 1, "Number of scenarios per worker process shard.");
+DEFINE_double(shard_timeout, 0.0,
+              "If positive, time (s) after which worker processes are killed "
+              "and their shard is treated as having crashed.");
+DEFINE_string(work_directory, ILQGAMES_LOG_DIR,
+              "Directory for shard results when using worker processes.");
+DEFINE_double(initial_position_noise, 0.5,
+              "Maximum perturbation of each player's initial position (m).");
+DEFINE_string(summary_file,
+              ILQGAMES_LOG_DIR + std::string("/closed_loop_summary.csv"),
+              "File to which to write the summary.");
+
+// Simulation parameters.
+DEFINE_double(final_time, 10.0, "Final time of each simulation (s).");
+DEFINE_double(planner_runtime, 0.25, "Planner runtime (s).");
+DEFINE_double(simulated_solve_time, 0.0,
+              "Time charged to each solve, for reproducible simulations.");
+
+// Event-triggered replanning parameters.
+DEFINE_bool(event_triggered, false,
+            "Only replan when the state deviates from the plan or the plan "
+            "runs out.");
+DEFINE_double(replanning_distance_threshold, 1.0,
+              "Deviation of any player from plan which triggers replanning, "
+              "as a distance (not squared) in the player's distance metric.");
+DEFINE_double(min_remaining_horizon, 2.0,
+              "Remaining plan horizon (s) below which to replan.");
+
+// Linesearch parameters.
+DEFINE_bool(linesearch, true, "Should the solver linesearch?");
+DEFINE_double(initial_alpha_scaling, 0.5, "Initial step size in linesearch.");
+DEFINE_double(trust_region_size, 10.0, "L_inf radius for trust region.");
+DEFINE_double(convergence_tolerance, 0.5, "L_inf tolerance for convergence.");
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  FLAGS_logtostderr = true;
+
+  CHECK_GE(FLAGS_num_scenarios, 0);
+  CHECK_GE(FLAGS_num_threads, 0);
+  CHECK_GE(FLAGS_num_processes, 0);
+  CHECK_GT(FLAGS_shard_size, 0);
+  CHECK_GE(FLAGS_initial_position_noise, 0.0);
+
+  // Set up solver parameters.
+  ilqgames::SolverParams params;
+  params.max_backtracking_steps = 100;
+  params.linesearch = FLAGS_linesearch;
+  params.trust_region_size = FLAGS_trust_region_size;
+  params.initial_alpha_scaling = FLAGS_initial_alpha_scaling;
+  params.convergence_tolerance = FLAGS_convergence_tolerance;
+
+  // Each scenario perturbs players' initial positions with noise seeded by its
+  // index, so that scenarios are reproducible. Players are two cars followed
+  // by a unicycle.
+  using P1 = ilqgames::SinglePlayerCar6D;
+  using P2 = ilqgames::SinglePlayerCar6D;
+  using P3 = ilqgames::SinglePlayerUnicycle4D;
+  const std::vector<std::pair<ilqgames::Dimension, ilqgames::Dimension>>
+      position_idxs = {
+          {P1::kPxIdx, P1::kPyIdx},
+          {P1::kNumXDims + P2::kPxIdx, P1::kNumXDims + P2::kPyIdx},
+          {P1::kNumXDims + P2::kNumXDims + P3::kPxIdx,
+           P1::kNumXDims + P2::kNumXDims + P3::kPyIdx}};
+
+  const ilqgames::ScenarioFactory factory = [&params,
+                                             &position_idxs](size_t scenario) {
+    std::unique_ptr<ilqgames::TopDownRenderableProblem> problem(
+        new ilqgames::ThreePlayerIntersectionExample(params));
+
+    std::mt19937 rng(scenario);
+    std::uniform_real_distribution<float> noise(-FLAGS_initial_position_noise,
+                                                FLAGS_initial_position_noise);
+    ilqgames::VectorXf x0 = problem->InitialState();
+    for (const auto& idxs : position_idxs) {
+      x0(idxs.first) += noise(rng);
+      x0(idxs.second) += noise(rng);
+    }
+    problem->ResetInitialState(x0);
+
+    return problem;
+  };  // factory
+
+  // Run all scenarios and write summary.
+  ilqgames::ClosedLoopBatchParams batch_params;
+  batch_params.final_time = FLAGS_final_time;
+  batch_params.planner_runtime = FLAGS_planner_runtime;
+  batch_params.num_threads = FLAGS_num_threads;
+  if (FLAGS_simulated_solve_time > 0.0)
+    batch_params.solve_time_model =
+        ilqgames::FixedSolveTimeModel(FLAGS_simulated_solve_time);
+  if (FLAGS_event_triggered) {
+    auto triggers = std::make_shared<ilqgames::ReplanningTriggers>();
+    triggers->player_distance_thresholds = {
+        static_cast<float>(FLAGS_replanning_distance_threshold)};
+    triggers->min_remaining_horizon = FLAGS_min_remaining_horizon;
+    batch_params.replanning_triggers = triggers;
+  }
+
+  std::vector<ilqgames::ClosedLoopRunStatistics> runs;
+  if (FLAGS_num_processes > 0) {
+    ilqgames::ShardedBatchParams sharded_params;
+    sharded_params.batch = batch_params;
+    sharded_params.shard_size = FLAGS_shard_size;
+    sharded_params.num_workers = FLAGS_num_processes;
+    sharded_params.work_directory = FLAGS_work_directory;
+    if (FLAGS_shard_timeout > 0.0)
+      sharded_params.shard_timeout = FLAGS_shard_timeout;
+
+    const ilqgames::ShardedBatchResults results =
+        ilqgames::RunShardedClosedLoopBatch(FLAGS_num_scenarios, factory,
+                                            sharded_params);
+    runs = results.runs;
+    for (size_t scenario : results.quarantined_scenarios)
+      std::cout << "Quarantined scenario " << scenario << std::endl;
+  } else {
+    runs = ilqgames::RunClosedLoopBatch(FLAGS_num_scenarios, factory,
+                                        batch_params);
+  }
+
+  if (!ilqgames::WriteClosedLoopSummary(runs, FLAGS_summary_file)) return 1;
+
+  std::cout << "Wrote summary of " << runs.size() << " runs to "
+            << FLAGS_summary_file << std::endl;
+  return 0;
+}
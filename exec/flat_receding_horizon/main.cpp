@@ -64,6 +64,10 @@ DEFINE_double(initial_alpha_scaling, 0.75, "Initial step size in linesearch.");
 DEFINE_double(trust_region_size, 10.0, "L_infradius for trust region.");
 DEFINE_double(convergence_tolerance, 0.5, "L_inf tolerance for convergence.");
 
+// Simulated time per solve. If zero, measured solve times are used instead.
+DEFINE_double(simulated_solve_time, 0.0,
+              "Time charged to each solve, for reproducible simulations.");
+
 // About OpenGL function loaders: modern OpenGL doesn't have a standard header
 // file and requires individual function pointers to be loaded manually. Helper
 // libraries are often used for this purpose! Here we are supporting a few
@@ -107,8 +111,13 @@ int main(int argc, char** argv) {
   // Solve the game in a receding horizon.
   constexpr ilqgames::Time kFinalTime = 10.0;       // s
   constexpr ilqgames::Time kPlannerRuntime = 0.25;  // s
+  ilqgames::SolveTimeModel solve_time_model;
+  if (FLAGS_simulated_solve_time > 0.0)
+    solve_time_model =
+        ilqgames::FixedSolveTimeModel(FLAGS_simulated_solve_time);
   const std::vector<std::shared_ptr<const ilqgames::SolverLog>> logs =
-      RecedingHorizonSimulator(kFinalTime, kPlannerRuntime, problem.get());
+      RecedingHorizonSimulator(kFinalTime, kPlannerRuntime, problem.get(),
+                               solve_time_model);
 
   // Create a top-down renderer, control sliders, and cost inspector.
   auto sliders = std::make_shared<ilqgames::ControlSliders>(logs);
@@ -64,6 +64,16 @@ DEFINE_double(initial_alpha_scaling, 0.5, "Initial step size in linesearch.");
 DEFINE_double(trust_region_size, 10.0, "L_infradius for trust region.");
 DEFINE_double(convergence_tolerance, 0.5, "L_inf tolerance for convergence.");
 
+// Simulated time per solve. If zero, measured solve times are used instead.
+DEFINE_double(simulated_solve_time, 0.0,
+              "Time charged to each solve, for reproducible simulations.");
+
+// Adaptive planner runtime budget. If zero, planner runtime is fixed instead.
+DEFINE_int32(planner_iterations, 0,
+             "Number of solver iterations to budget time for in each solve.");
+DEFINE_double(latency_quantile, 0.9,
+              "Quantile at which to predict iteration runtimes for budgeting.");
+
 // About OpenGL function loaders: modern OpenGL doesn't have a standard header
 // file and requires individual function pointers to be loaded manually. Helper
 // libraries are often used for this purpose! Here we are supporting a few
@@ -107,8 +117,20 @@ int main(int argc, char** argv) {
   // Solve the game in a receding horizon.
   constexpr ilqgames::Time kFinalTime = 10.0;       // s
   constexpr ilqgames::Time kPlannerRuntime = 0.25;  // s
+  ilqgames::SolveTimeModel solve_time_model;
+  if (FLAGS_simulated_solve_time > 0.0)
+    solve_time_model =
+        ilqgames::FixedSolveTimeModel(FLAGS_simulated_solve_time);
+  std::unique_ptr<ilqgames::PlannerRuntimeBudget> planner_runtime_budget;
+  if (FLAGS_planner_iterations > 0) {
+    planner_runtime_budget.reset(new ilqgames::PlannerRuntimeBudget);
+    planner_runtime_budget->num_iterations = FLAGS_planner_iterations;
+    planner_runtime_budget->latency_quantile = FLAGS_latency_quantile;
+  }
   const std::vector<std::shared_ptr<const ilqgames::SolverLog>> logs =
-      RecedingHorizonSimulator(kFinalTime, kPlannerRuntime, problem.get());
+      RecedingHorizonSimulator(kFinalTime, kPlannerRuntime, problem.get(),
+                               solve_time_model, nullptr,
+                               planner_runtime_budget.get());
 
   // Create a top-down renderer, control sliders, and cost inspector.
   auto sliders = std::make_shared<ilqgames::ControlSliders>(logs);
@@ -47,6 +47,7 @@
 
 #include <ilqgames/constraint/time_invariant_constraint.h>
 #include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
 #include <ilqgames/utils/types.h>
 
 #include <string>
@@ -68,15 +69,33 @@ class Polyline2SignedDistanceConstraint : public TimeInvariantConstraint {
         yidx_(position_idxs.second) {}
 
   // Check if this constraint is satisfied, and optionally return the value of a
-  // function whose zero sub-level set corresponds to the feasible set.
-  bool IsSatisfied(const VectorXf& input, float* level = nullptr) const;
+  // function whose zero sub-level set corresponds to the feasible set. Closest
+  // point queries are made through the query cache in scope (if any), indexed
+  // by time step. Without a time, queries are associated to the initial time.
+  bool IsSatisfied(Time t, const VectorXf& input,
+                   float* level = nullptr) const;
+  bool IsSatisfied(const VectorXf& input, float* level = nullptr) const {
+    return IsSatisfied(initial_time_, input, level);
+  }
 
   // Quadraticize this cost at the given time and input, and add to the running
   // sum of gradients and Hessians.
-  void Quadraticize(const VectorXf& input, MatrixXf* hess,
+  void Quadraticize(Time t, const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
+  void Quadraticize(const VectorXf& input, MatrixXf* hess,
+                    VectorXf* grad) const {
+    Quadraticize(initial_time_, input, hess, grad);
+  }
 
  private:
+  // Find the closest point on the polyline to the position in the given input.
+  Polyline2QueryCache::ClosestPointQuery ClosestPoint(
+      Time t, const VectorXf& input) const {
+    return Polyline2QueryCache::ClosestPointInScope(
+        polyline_, xidx_, yidx_, TimeIndex(t),
+        Point2(input(xidx_), input(yidx_)));
+  }
+
   // Polyline to compute distances from.
   const Polyline2 polyline_;
 
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// Base class for costs which depend upon a small, fixed number of input
+// dimensions, and whose derivatives are computed by forward-mode automatic
+// differentiation. Derived classes implement a single templated function
+//
+//   template <typename T>
+//   T Function(Time t, const std::array<T, N>& x) const;
+//
+// of the relevant input dimensions (in the order given at construction),
+// including the weight. It is evaluated with T = float for Evaluate, and with
+// T = SecondOrderDual<N> for Quadraticize, which computes value, gradient, and
+// Hessian in one fused pass and scatters them into the full-size gradient and
+// Hessian. See second_order_dual.h for how to write such functions.
+//
+// The dispatch to Function is static (curiously recurring template pattern),
+// so it may be inlined. Even so, hand-written derivatives of simple costs are
+// still much faster, so this base is intended for costs whose derivatives
+// are tedious to derive by hand, and as a reference for testing hand-written
+// derivatives.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_COST_AUTODIFF_COST_H
+#define ILQGAMES_COST_AUTODIFF_COST_H
+
+#include <ilqgames/cost/cost.h>
+#include <ilqgames/utils/second_order_dual.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <array>
+#include <string>
+
+namespace ilqgames {
+
+template <typename Derived, int N>
+class AutodiffCost : public Cost {
+ public:
+  virtual ~AutodiffCost() {}
+
+  // Evaluate this cost at the given time and input.
+  float Evaluate(Time t, const VectorXf& input) const {
+    std::array<float, N> x;
+    for (int ii = 0; ii < N; ii++) x[ii] = input(dims_[ii]);
+
+    return static_cast<const Derived*>(this)->Function(t, x);
+  }
+
+  // Quadraticize this cost at the given time and input, and add to the running
+  // sum of gradients and Hessians.
+  void Quadraticize(Time t, const VectorXf& input, MatrixXf* hess,
+                    VectorXf* grad = nullptr) const {
+    CHECK_NOTNULL(hess);
+
+    // Check dimensions.
+    CHECK_EQ(input.size(), hess->rows());
+    CHECK_EQ(input.size(), hess->cols());
+    if (grad) CHECK_EQ(input.size(), grad->size());
+
+    // Seed one dual variable per relevant dimension, in place.
+    std::array<SecondOrderDual<N>, N> x;
+    for (int ii = 0; ii < N; ii++) {
+      x[ii].v = input(dims_[ii]);
+      x[ii].g(ii) = 1.0;
+      x[ii].support = typename SecondOrderDual<N>::Support(1) << ii;
+    }
+
+    const SecondOrderDual<N> y =
+        static_cast<const Derived*>(this)->Function(t, x);
+
+    // Scatter into the full gradient and Hessian, mirroring the supported
+    // block of the packed lower triangle. Accumulating handles the case where a
+    // dimension appears more than once.
+    if (grad) {
+      for (int ii = 0; ii < N; ii++) (*grad)(dims_[ii]) += y.g(ii);
+    }
+
+    SecondOrderDual<N>::ForEachEntry(
+        y.hessian_support, [this, &y, hess](int ii, int jj, int kk) {
+          (*hess)(dims_[ii], dims_[jj]) += y.h(kk);
+          if (ii != jj) (*hess)(dims_[jj], dims_[ii]) += y.h(kk);
+        });
+  }
+
+ protected:
+  AutodiffCost(float weight, const std::array<Dimension, N>& dims,
+               const std::string& name = "")
+      : Cost(weight, name), dims_(dims) {
+    for (const Dimension dim : dims_) CHECK_GE(dim, 0);
+  }
+
+  // Input dimensions upon which this cost depends.
+  const std::array<Dimension, N> dims_;
+};  //\class AutodiffCost
+
+}  // namespace ilqgames
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// Costs flattened into contiguous arrays of parameters, grouped by type, so
+// that evaluation and quadraticization of the most common cost types run in
+// tight, non-virtual loops. Costs of any other type are kept as they are, and
+// called through the usual virtual interface.
+//
+// Costs place themselves into the appropriate group via Cost::Compile.
+// Proximity terms may optionally be shared with other players' costs (see
+// SharedProximityTerms).
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_COST_COMPILED_COSTS_H
+#define ILQGAMES_COST_COMPILED_COSTS_H
+
+#include <ilqgames/cost/shared_proximity_terms.h>
+#include <ilqgames/utils/types.h>
+
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ilqgames {
+
+class Cost;
+
+class CompiledCosts {
+ public:
+  ~CompiledCosts() {}
+  explicit CompiledCosts(const std::shared_ptr<SharedProximityTerms>&
+                             shared_proximity_terms = nullptr)
+      : shared_proximity_terms_(shared_proximity_terms) {}
+
+  // Index indicating that a cost is not a pairwise proximity cost registered
+  // with a broad-phase.
+  static constexpr size_t kNoProximityPair = std::numeric_limits<size_t>::max();
+
+  // Index indicating that a proximity term is not shared.
+  static constexpr size_t kNoSharedTerm = std::numeric_limits<size_t>::max();
+
+  // Parameters for QuadraticCost in a single dimension.
+  struct QuadraticTerm {
+    Dimension dim;
+    float weight;
+    float nominal;
+  };  //\struct QuadraticTerm
+
+  // Parameters for SemiquadraticCost.
+  struct SemiquadraticTerm {
+    Dimension dim;
+    float weight;
+    float threshold;
+    bool oriented_right;
+  };  //\struct SemiquadraticTerm
+
+  // Parameters for ProximityCost, along with the index of its pair in the
+  // broad-phase (if any) and of its shared term (if any).
+  struct ProximityTerm {
+    Dimension xidx1, yidx1;
+    Dimension xidx2, yidx2;
+    float weight;
+    float threshold, threshold_sq;
+    size_t proximity_pair;
+    size_t shared_term = kNoSharedTerm;
+  };  //\struct ProximityTerm
+
+  // Add a cost, along with the index of its pair in the broad-phase (if any).
+  // Costs which cannot be compiled are kept and called virtually.
+  void Add(const std::shared_ptr<Cost>& cost,
+           size_t proximity_pair = kNoProximityPair);
+
+  // Add terms to each group. Called from Cost::Compile.
+  void AddQuadraticTerm(const QuadraticTerm& term) {
+    quadratic_terms_.push_back(term);
+  }
+  void AddSemiquadraticTerm(const SemiquadraticTerm& term) {
+    semiquadratic_terms_.push_back(term);
+  }
+  void AddProximityTerm(const ProximityTerm& term);
+
+  // Evaluate all costs at the given time and input, skipping proximity costs
+  // whose pairs are inactive (if active pairs are given). Costs not associated
+  // to a proximity pair are always evaluated. If an activity mask is given,
+  // also record whether each piecewise term may be active within the given
+  // margin (see NumActivityTerms).
+  float Evaluate(Time t, const VectorXf& input,
+                 const std::vector<bool>* active_proximity_pairs = nullptr,
+                 float activity_margin = 0.0,
+                 std::vector<bool>* activity = nullptr) const;
+
+  // Quadraticize all costs at the given time and input, skipping proximity
+  // costs whose pairs are inactive (if active pairs are given), and add to the
+  // running sum of gradients and Hessians. If an activity mask recorded at this
+  // input is given, it takes the place of the active pairs and inactive terms
+  // are skipped.
+  void Quadraticize(Time t, const VectorXf& input,
+                    const std::vector<bool>* active_proximity_pairs,
+                    MatrixXf* hess, VectorXf* grad,
+                    const std::vector<bool>* activity = nullptr) const;
+
+  // Number of compiled terms and of costs which are called virtually.
+  size_t NumCompiledTerms() const {
+    return quadratic_terms_.size() + semiquadratic_terms_.size() +
+           proximity_terms_.size();
+  }
+  size_t NumVirtualCosts() const { return virtual_costs_.size(); }
+
+  // Number of piecewise terms whose activity is recorded in activity masks.
+  // Masks list semiquadratic terms, then proximity terms, then costs called
+  // virtually. Quadratic terms are always active.
+  size_t NumActivityTerms() const {
+    return semiquadratic_terms_.size() + proximity_terms_.size() +
+           virtual_costs_.size();
+  }
+
+ private:
+  // Check whether the given proximity pair might be active.
+  static bool IsActive(size_t proximity_pair,
+                       const std::vector<bool>* active_proximity_pairs) {
+    return proximity_pair == kNoProximityPair || !active_proximity_pairs ||
+           (*active_proximity_pairs)[proximity_pair];
+  }
+
+  // Compiled terms, grouped by type.
+  std::vector<QuadraticTerm> quadratic_terms_;
+  std::vector<SemiquadraticTerm> semiquadratic_terms_;
+  std::vector<ProximityTerm> proximity_terms_;
+
+  // All other costs, with the index of their proximity pair (if any).
+  std::vector<std::pair<std::shared_ptr<Cost>, size_t>> virtual_costs_;
+
+  // Proximity terms shared with other players' costs (may be null).
+  std::shared_ptr<SharedProximityTerms> shared_proximity_terms_;
+};  //\class CompiledCosts
+
+}  // namespace ilqgames
+
+#endif
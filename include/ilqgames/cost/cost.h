@@ -47,9 +47,12 @@
 #include <ilqgames/utils/types.h>
 
 #include <string>
+#include <utility>
 
 namespace ilqgames {
 
+class CompiledCosts;
+
 class Cost {
  public:
   virtual ~Cost() {}
@@ -65,21 +68,81 @@ class Cost {
   // Access the name of this cost.
   const std::string& Name() const { return name_; }
 
+  // Pairwise proximity costs report the input dimensions of the two positions
+  // they depend upon, and the distance between them beyond which the cost is
+  // identically zero. This allows inactive pairs to be culled before
+  // evaluation. All other costs return false.
+  virtual bool ProximityPair(std::pair<Dimension, Dimension>* position_idxs1,
+                             std::pair<Dimension, Dimension>* position_idxs2,
+                             float* radius) const {
+    return false;
+  }
+
+  // Costs of common types add their parameters to the corresponding group of
+  // compiled costs, along with the index of their pair in the broad-phase (if
+  // any), and return true. All other costs return false.
+  virtual bool Compile(size_t proximity_pair, CompiledCosts* compiled) const {
+    return false;
+  }
+
+  // Check whether this cost may be nonzero at the given time and input, or
+  // within the given margin of becoming so. Piecewise costs which vanish over
+  // part of their domain override this, so that they may be skipped where
+  // inactive. All other costs are always active.
+  virtual bool IsActive(Time t, const VectorXf& input, float margin) const {
+    return true;
+  }
+
+  // Precompute time-indexed terms at the given number of time steps, starting
+  // from the current initial time. Called once per solve, after the initial
+  // time has been set. By default, there is nothing to precompute.
+  virtual void Precompute(size_t num_time_steps) {}
+
   // Reset the initial time associated to this cost.
   static void ResetInitialTime(Time t0) { initial_time_ = t0; };
 
+  // Reset the time step associated to this cost.
+  static void ResetTimeStep(Time time_step) { time_step_ = time_step; };
+
  protected:
   explicit Cost(float weight, const std::string& name = "")
       : weight_(weight), name_(name) {}
 
+  // Compute the time index corresponding to the given time, relative to the
+  // initial time. Returns 0 if the time step has not been set.
+  static size_t TimeIndex(Time t) {
+    if (time_step_ <= 0.0 || t <= initial_time_) return 0;
+    return static_cast<size_t>(0.5 + (t - initial_time_) / time_step_);
+  }
+
+  // Record that time-indexed terms have been precomputed for the current
+  // initial time and time step.
+  void SetPrecomputedTimeGrid() {
+    precomputed_initial_time_ = initial_time_;
+    precomputed_time_step_ = time_step_;
+  }
+
+  // Find the index of the given time in a table of the given size which was
+  // precomputed for the current initial time and time step. Returns false if
+  // the table is stale or the time does not lie on the time grid.
+  bool PrecomputedTimeIndex(Time t, size_t table_size, size_t* kk) const;
+
   // Multiplicative weight associated to this cost.
   float weight_;
 
   // Name associated to every cost.
   const std::string name_;
 
-  // Initial time associated to this cost.
-  static Time initial_time_;
+  // Initial time and time step associated to this cost. These are kept per
+  // thread, so that independent problems may be solved concurrently, and are
+  // set by GameSolver::Solve for the thread it runs on.
+  static thread_local Time initial_time_;
+  static thread_local Time time_step_;
+
+ private:
+  // Initial time and time step for which time-indexed terms were precomputed.
+  Time precomputed_initial_time_ = constants::kInfinity;
+  Time precomputed_time_step_ = 0.0;
 };  //\class Cost
 
 }  // namespace ilqgames
@@ -55,7 +55,7 @@ namespace ilqgames {
 class FinalTimeCost : public Cost {
  public:
   ~FinalTimeCost() {}
-  FinalTimeCost(const std::shared_ptr<const Cost>& cost, Time threshold_time,
+  FinalTimeCost(const std::shared_ptr<Cost>& cost, Time threshold_time,
                 const std::string& name = "")
       : Cost(0.0, name), cost_(cost), threshold_time_(threshold_time) {
     CHECK_NOTNULL(cost.get());
@@ -75,9 +75,12 @@ class FinalTimeCost : public Cost {
     cost_->Quadraticize(t, input, hess, grad);
   }
 
+  // Precompute time-indexed terms of the wrapped cost.
+  void Precompute(size_t num_time_steps) { cost_->Precompute(num_time_steps); }
+
  private:
   // Cost function.
-  const std::shared_ptr<const Cost> cost_;
+  const std::shared_ptr<Cost> cost_;
 
   // Time threshold relative to initial time after which to apply cost.
   const Time threshold_time_;
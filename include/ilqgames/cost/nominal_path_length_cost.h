@@ -48,6 +48,7 @@
 #include <ilqgames/utils/types.h>
 
 #include <string>
+#include <vector>
 
 namespace ilqgames {
 
@@ -67,12 +68,21 @@ class NominalPathLengthCost : public Cost {
   void Quadraticize(Time t, const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
 
+  // Precompute nominal path lengths at each time step.
+  void Precompute(size_t num_time_steps);
+
  private:
+  // Compute the nominal path length at the given time.
+  float NominalPathLength(Time t) const;
+
   // Dimension in which to apply the quadratic cost.
   const Dimension dimension_;
 
   // Nominal speed.
   const float nominal_speed_;
+
+  // Nominal path lengths at each time step.
+  std::vector<float> nominal_path_lengths_;
 };  //\class NominalPathLengthCost
 
 }  // namespace ilqgames
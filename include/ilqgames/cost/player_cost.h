@@ -45,12 +45,19 @@
 #define ILQGAMES_COST_PLAYER_COST_H
 
 #include <ilqgames/constraint/constraint.h>
+#include <ilqgames/cost/compiled_costs.h>
 #include <ilqgames/cost/cost.h>
+#include <ilqgames/cost/shared_proximity_terms.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
+#include <ilqgames/geometry/proximity_broad_phase.h>
 #include <ilqgames/utils/operating_point.h>
 #include <ilqgames/utils/quadratic_cost_approximation.h>
 #include <ilqgames/utils/types.h>
 
+#include <memory>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace ilqgames {
 
@@ -71,20 +78,57 @@ class PlayerCost {
   void AddControlConstraint(PlayerIndex idx,
                             const std::shared_ptr<Constraint>& constraint);
 
+  // Flatten costs into type-grouped arrays of parameters, so that common cost
+  // types are evaluated and quadraticized in tight, non-virtual loops. Adding
+  // another cost reverts to calling every cost virtually until this is called
+  // again. Constraints are always called virtually, since their barrier
+  // weights change during each solve. Optionally, proximity costs may share
+  // their geometric core with other players' costs, and pairwise proximity
+  // costs may be registered with a broad-phase shared by all players, whose
+  // active pairs may then be passed to evaluate and quadraticize this cost.
+  void Compile(const std::shared_ptr<SharedProximityTerms>&
+                   shared_proximity_terms = nullptr,
+               ProximityBroadPhase* proximity_broad_phase = nullptr);
+  bool IsCompiled() const { return is_compiled_; }
+
   // Evaluate this cost at the current time, state, and controls, or integrate
   // over an entire trajectory. Does *not* incorporate cost barriers due to
   // inequality constraints. The "Offset" here indicates that state costs will
-  // be evaluated at the next time step.
-  float Evaluate(Time t, const VectorXf& x,
-                 const std::vector<VectorXf>& us) const;
+  // be evaluated at the next time step. If compiled with a broad-phase,
+  // optionally skips pairwise proximity costs which are inactive according to
+  // the broad-phase at the same state.
+  float Evaluate(
+      Time t, const VectorXf& x, const std::vector<VectorXf>& us,
+      const std::vector<bool>* active_proximity_pairs = nullptr) const;
   float Evaluate(const OperatingPoint& op, Time time_step) const;
-  float EvaluateOffset(Time t, Time next_t, const VectorXf& next_x,
-                       const std::vector<VectorXf>& us) const;
+  float EvaluateOffset(
+      Time t, Time next_t, const VectorXf& next_x,
+      const std::vector<VectorXf>& us,
+      const std::vector<bool>* active_proximity_pairs = nullptr) const;
+
+  // Evaluate this cost as above, and also record an activity mask for state
+  // costs, i.e., whether each piecewise term may be active within the given
+  // margin. Masks are only recorded for compiled costs, and are otherwise left
+  // empty.
+  float Evaluate(
+      Time t, const VectorXf& x, const std::vector<VectorXf>& us,
+      float activity_margin, std::vector<bool>* activity,
+      const std::vector<bool>* active_proximity_pairs = nullptr) const;
 
   // Quadraticize this cost at the given time, state, and controls.
   // *Does* account for cost barriers due to inequality constraints.
+  // Optionally skips state cost terms which are inactive in a (non-empty)
+  // activity mask recorded at the same time and state, or otherwise pairwise
+  // proximity costs which are inactive according to the broad-phase.
   QuadraticCostApproximation Quadraticize(
-      Time t, const VectorXf& x, const std::vector<VectorXf>& us) const;
+      Time t, const VectorXf& x, const std::vector<VectorXf>& us,
+      const std::vector<bool>* activity = nullptr,
+      const std::vector<bool>* active_proximity_pairs = nullptr) const;
+
+  // Number of state cost terms covered by activity masks.
+  size_t NumActivityTerms() const {
+    return (is_compiled_) ? compiled_state_costs_.NumActivityTerms() : 0;
+  }
 
   // Check whether constraints are satisfied at the given time and state.
   bool CheckConstraints(Time t, const VectorXf& x) const;
@@ -95,6 +139,10 @@ class PlayerCost {
   void ScaleConstraintBarrierWeights(float scale = 0.5);
   void ResetConstraintBarrierWeights();
 
+  // Precompute time-indexed terms in all costs and constraints at the given
+  // number of time steps from the current initial time.
+  void Precompute(size_t num_time_steps);
+
   // Accessors.
   const std::vector<std::shared_ptr<Cost>>& StateCosts() const {
     return state_costs_;
@@ -108,6 +156,13 @@ class PlayerCost {
   }
 
  private:
+  // Evaluate state and control costs, using the compiled costs if available.
+  float EvaluateStateCosts(Time t, const VectorXf& x,
+                           const std::vector<bool>* active_proximity_pairs,
+                           float activity_margin = 0.0,
+                           std::vector<bool>* activity = nullptr) const;
+  float EvaluateControlCosts(Time t, const std::vector<VectorXf>& us) const;
+
   // State costs and control costs.
   std::vector<std::shared_ptr<Cost>> state_costs_;
   CostMap<Cost> control_costs_;
@@ -120,6 +175,16 @@ class PlayerCost {
 
   // Regularization on costs.
   const float state_regularization_, control_regularization_;
+
+  // Closest point queries shared by all costs and constraints, which is put in
+  // scope while evaluating them. Each copy of this PlayerCost (e.g., in each
+  // solver) has its own. Evaluation is otherwise const, hence it is mutable.
+  mutable Polyline2QueryCache polyline2_query_cache_;
+
+  // Compiled state costs, and compiled control costs for each player.
+  bool is_compiled_ = false;
+  CompiledCosts compiled_state_costs_;
+  std::vector<std::pair<PlayerIndex, CompiledCosts>> compiled_control_costs_;
 };  //\class PlayerCost
 
 }  // namespace ilqgames
@@ -48,6 +48,7 @@
 #include <ilqgames/cost/time_invariant_cost.h>
 #include <ilqgames/utils/types.h>
 
+#include <glog/logging.h>
 #include <string>
 #include <utility>
 
@@ -65,7 +66,9 @@ class ProximityCost : public TimeInvariantCost {
         xidx1_(position_idxs1.first),
         yidx1_(position_idxs1.second),
         xidx2_(position_idxs2.first),
-        yidx2_(position_idxs2.second) {}
+        yidx2_(position_idxs2.second) {
+    CHECK_GE(threshold_, 0.0);
+  }
 
   // Evaluate this cost at the current input.
   float Evaluate(const VectorXf& input) const;
@@ -75,6 +78,19 @@ class ProximityCost : public TimeInvariantCost {
   void Quadraticize(const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
 
+  // Check whether this cost may be nonzero at the given input, or within the
+  // given margin of becoming so.
+  bool IsActive(const VectorXf& input, float margin) const;
+
+  // Add this cost to the corresponding group of compiled costs.
+  bool Compile(size_t proximity_pair, CompiledCosts* compiled) const;
+
+  // Report the positions whose proximity this cost penalizes. The cost is zero
+  // beyond the threshold distance.
+  bool ProximityPair(std::pair<Dimension, Dimension>* position_idxs1,
+                     std::pair<Dimension, Dimension>* position_idxs2,
+                     float* radius) const;
+
  private:
   // Threshold for minimum squared relative distance.
   const float threshold_, threshold_sq_;
@@ -67,6 +67,9 @@ class QuadraticCost : public TimeInvariantCost {
   void Quadraticize(const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
 
+  // Add this cost to the corresponding group of compiled costs.
+  bool Compile(size_t proximity_pair, CompiledCosts* compiled) const;
+
  private:
   // Dimension in which to apply the quadratic cost.
   const Dimension dimension_;
@@ -45,6 +45,7 @@
 
 #include <ilqgames/cost/time_invariant_cost.h>
 #include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
 #include <ilqgames/utils/types.h>
 
 #include <string>
@@ -64,15 +65,32 @@ class QuadraticPolyline2Cost : public TimeInvariantCost {
         xidx_(position_idxs.first),
         yidx_(position_idxs.second) {}
 
-  // Evaluate this cost at the current input.
-  float Evaluate(const VectorXf& input) const;
+  // Evaluate this cost at the current time and input. Closest point queries
+  // are made through the query cache in scope (if any), indexed by time step.
+  // Without a time, queries are associated to the initial time.
+  float Evaluate(Time t, const VectorXf& input) const;
+  float Evaluate(const VectorXf& input) const {
+    return Evaluate(initial_time_, input);
+  }
 
-  // Quadraticize this cost at the given input, and add to the running
+  // Quadraticize this cost at the given time and input, and add to the running
   // sum of gradients and Hessians.
-  void Quadraticize(const VectorXf& input, MatrixXf* hess,
+  void Quadraticize(Time t, const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
+  void Quadraticize(const VectorXf& input, MatrixXf* hess,
+                    VectorXf* grad) const {
+    Quadraticize(initial_time_, input, hess, grad);
+  }
 
  private:
+  // Find the closest point on the polyline to the position in the given input.
+  Polyline2QueryCache::ClosestPointQuery ClosestPoint(
+      Time t, const VectorXf& input) const {
+    return Polyline2QueryCache::ClosestPointInScope(
+        polyline_, xidx_, yidx_, TimeIndex(t),
+        Point2(input(xidx_), input(yidx_)));
+  }
+
   // Polyline to compute distances from.
   const Polyline2 polyline_;
 
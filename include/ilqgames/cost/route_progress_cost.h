@@ -77,7 +77,13 @@ class RouteProgressCost : public Cost {
   void Quadraticize(Time t, const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
 
+  // Precompute desired route points at each time step.
+  void Precompute(size_t num_time_steps);
+
  private:
+  // Find the point along the route where we should be at the given time.
+  Point2 DesiredRoutePoint(Time t) const;
+
   // Nominal speed.
   const float nominal_speed_;
 
@@ -90,6 +96,9 @@ class RouteProgressCost : public Cost {
 
   // Initial route position and time.
   const float initial_route_pos_;
+
+  // Desired route points at each time step.
+  PointList2 desired_route_points_;
 };  //\class RouteProgressCost
 
 }  // namespace ilqgames
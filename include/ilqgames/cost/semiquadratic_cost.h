@@ -73,6 +73,13 @@ class SemiquadraticCost : public TimeInvariantCost {
   void Quadraticize(const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
 
+  // Check whether this cost may be nonzero at the given input, or within the
+  // given margin of becoming so.
+  bool IsActive(const VectorXf& input, float margin) const;
+
+  // Add this cost to the corresponding group of compiled costs.
+  bool Compile(size_t proximity_pair, CompiledCosts* compiled) const;
+
  private:
   // Dimension in which to apply the quadratic cost.
   const Dimension dimension_;
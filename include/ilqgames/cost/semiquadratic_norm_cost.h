@@ -79,6 +79,10 @@ class SemiquadraticNormCost : public TimeInvariantCost {
   void Quadraticize(const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
 
+  // Check whether this cost may be nonzero at the given input, or within the
+  // given margin of becoming so.
+  bool IsActive(const VectorXf& input, float margin) const;
+
  private:
   // Dimensions in which to apply the quadratic cost.
   const Dimension dim1_, dim2_;
@@ -45,6 +45,7 @@
 
 #include <ilqgames/cost/time_invariant_cost.h>
 #include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
 #include <ilqgames/utils/types.h>
 
 #include <string>
@@ -68,15 +69,39 @@ class SemiquadraticPolyline2Cost : public TimeInvariantCost {
         signed_squared_threshold_(sgn(threshold) * threshold * threshold),
         oriented_right_(oriented_right) {}
 
-  // Evaluate this cost at the current input.
-  float Evaluate(const VectorXf& input) const;
+  // Evaluate this cost at the current time and input. Closest point queries
+  // are made through the query cache in scope (if any), indexed by time step.
+  // Without a time, queries are associated to the initial time.
+  float Evaluate(Time t, const VectorXf& input) const;
+  float Evaluate(const VectorXf& input) const {
+    return Evaluate(initial_time_, input);
+  }
 
-  // Quadraticize this cost at the given input, and add to the running
+  // Quadraticize this cost at the given time and input, and add to the running
   // sum of gradients and Hessians.
-  void Quadraticize(const VectorXf& input, MatrixXf* hess,
+  void Quadraticize(Time t, const VectorXf& input, MatrixXf* hess,
                     VectorXf* grad) const;
+  void Quadraticize(const VectorXf& input, MatrixXf* hess,
+                    VectorXf* grad) const {
+    Quadraticize(initial_time_, input, hess, grad);
+  }
+
+  // Check whether this cost may be nonzero at the given time and input, or
+  // within the given margin of becoming so.
+  bool IsActive(Time t, const VectorXf& input, float margin) const;
+  bool IsActive(const VectorXf& input, float margin) const {
+    return IsActive(initial_time_, input, margin);
+  }
 
  private:
+  // Find the closest point on the polyline to the position in the given input.
+  Polyline2QueryCache::ClosestPointQuery ClosestPoint(
+      Time t, const VectorXf& input) const {
+    return Polyline2QueryCache::ClosestPointInScope(
+        polyline_, xidx_, yidx_, TimeIndex(t),
+        Point2(input(xidx_), input(yidx_)));
+  }
+
   // Check if cost is active.
   bool IsActive(float signed_squared_distance) const {
     return (signed_squared_distance > signed_squared_threshold_ &&
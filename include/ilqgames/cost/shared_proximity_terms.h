@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// Proximity costs shared between players. In most games, each player in a
+// pair penalizes its proximity to the other with the same threshold, but a
+// different weight. The geometric core of such a term, i.e., its value,
+// gradient, and Hessian with unit weight in terms of the relative position
+// (dx, dy) = p1 - p2, is therefore the same for both players. This class
+// registers each distinct pair of positions and threshold once, and computes
+// its core once per relative position so that every player's cost only needs
+// to scale and scatter it.
+//
+// Cores are cached by the last relative position at which they were
+// computed, which suffices since all players' costs are quadraticized at the
+// same state before moving on to the next time step. Not thread-safe, so each
+// solver should own its own instance.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_COST_SHARED_PROXIMITY_TERMS_H
+#define ILQGAMES_COST_SHARED_PROXIMITY_TERMS_H
+
+#include <ilqgames/utils/types.h>
+
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ilqgames {
+
+class SharedProximityTerms {
+ public:
+  // Value, gradient, and Hessian of 0.5 * (threshold - |(dx, dy)|)^2 when the
+  // relative distance is less than the threshold, with respect to (dx, dy).
+  struct Core {
+    bool is_active = false;
+    float value = 0.0;
+    float grad_x = 0.0, grad_y = 0.0;
+    float hess_xx = 0.0, hess_yy = 0.0, hess_xy = 0.0;
+  };  //\struct Core
+
+  ~SharedProximityTerms() {}
+  SharedProximityTerms() {}
+
+  // Compute the core at the given relative position.
+  static Core ComputeCore(float dx, float dy, float threshold,
+                          float threshold_sq);
+
+  // Register the given pair of positions and threshold, and return the index of
+  // the corresponding shared term. Since the cost is symmetric in the two
+  // positions, they are first put in a canonical order, which is returned.
+  size_t Add(std::pair<Dimension, Dimension>* position_idxs1,
+             std::pair<Dimension, Dimension>* position_idxs2, float threshold);
+
+  // Find the core of the given term at the given input, reusing the last
+  // computation if it was at the same relative position. The returned
+  // reference is only valid until the next call.
+  const Core& Evaluate(size_t term_idx, const VectorXf& input);
+
+  // Number of distinct terms, and number of times any core has been computed.
+  size_t NumTerms() const { return terms_.size(); }
+  size_t NumComputations() const { return num_computations_; }
+
+ private:
+  // Canonical positions and threshold, along with the last computed core.
+  struct Term {
+    Dimension xidx1, yidx1;
+    Dimension xidx2, yidx2;
+    float threshold, threshold_sq;
+    bool is_valid = false;
+    float dx, dy;
+    Core core;
+  };  //\struct Term
+
+  // Registered terms, and their indices keyed by positions and threshold.
+  std::vector<Term> terms_;
+  std::map<std::tuple<Dimension, Dimension, Dimension, Dimension, float>,
+           size_t>
+      term_idxs_;
+
+  // Number of core computations.
+  size_t num_computations_ = 0;
+};  //\class SharedProximityTerms
+
+}  // namespace ilqgames
+
+#endif
@@ -69,6 +69,15 @@ class TimeInvariantCost : public Cost {
     Quadraticize(input, hess, grad);
   }
 
+  // Check whether this cost may be nonzero at the given input, or within the
+  // given margin of becoming so. By default, always active.
+  virtual bool IsActive(const VectorXf& input, float margin) const {
+    return true;
+  }
+  bool IsActive(Time t, const VectorXf& input, float margin) const {
+    return IsActive(input, margin);
+  }
+
  protected:
   explicit TimeInvariantCost(float weight, const std::string& name = "")
       : Cost(weight, name) {}
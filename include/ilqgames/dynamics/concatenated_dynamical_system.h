@@ -49,6 +49,7 @@
 #include <ilqgames/utils/types.h>
 
 #include <algorithm>
+#include <vector>
 
 namespace ilqgames {
 
@@ -65,9 +66,22 @@ class ConcatenatedDynamicalSystem : public MultiPlayerDynamicalSystem {
   LinearDynamicsApproximation Linearize(Time t, const VectorXf& x,
                                         const std::vector<VectorXf>& us) const;
 
+  // Compute discrete-time Jacobian linearizations at every time step of a
+  // trajectory, one subsystem at a time, so that each subsystem can linearize
+  // all time steps in a single batch.
+  void LinearizeBatch(
+      Time t0, const std::vector<VectorXf>& xs,
+      const std::vector<std::vector<VectorXf>>& us,
+      std::vector<LinearDynamicsApproximation>* linearizations) const;
+
   // Distance metric between two states.
   float DistanceBetween(const VectorXf& x0, const VectorXf& x1) const;
 
+  // Distance metric between the given player's components of two states,
+  // according to that player's subsystem.
+  float PlayerDistanceBetween(PlayerIndex player_idx, const VectorXf& x0,
+                              const VectorXf& x1) const;
+
   // Stitch between two states of the system. Interprets the first one as best
   // for ego and the second as best for other players.
   VectorXf Stitch(const VectorXf& x_ego, const VectorXf& x_others) const {
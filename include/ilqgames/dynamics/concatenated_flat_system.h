@@ -46,8 +46,11 @@
 #include <ilqgames/dynamics/multi_player_flat_system.h>
 #include <ilqgames/dynamics/single_player_flat_system.h>
 #include <ilqgames/utils/linear_dynamics_approximation.h>
+#include <ilqgames/utils/quadratic_cost_approximation.h>
 #include <ilqgames/utils/types.h>
 
+#include <vector>
+
 namespace ilqgames {
 
 class ConcatenatedFlatSystem : public MultiPlayerFlatSystem {
@@ -79,15 +82,21 @@ class ConcatenatedFlatSystem : public MultiPlayerFlatSystem {
   // Get the subset of this full state corresponding to the given subsystem.
   VectorXf SubsystemStates(const VectorXf& x, PlayerIndex subsystem_idx) const;
 
-  // Deprecated utilities for changing cost coordinates.
+  // Utilities for changing cost coordinates from x to xi.
   void ChangeCostCoordinates(const VectorXf& xi,
-                             std::vector<QuadraticCostApproximation>* q) const;
+                             std::vector<QuadraticCostApproximation>* q,
+                             CostCoordinateBuffers* buffers = nullptr) const;
   void ChangeControlCostCoordinates(
       const VectorXf& xi, std::vector<QuadraticCostApproximation>* q) const;
 
   // Distance metric between two states.
   float DistanceBetween(const VectorXf& x0, const VectorXf& x1) const;
 
+  // Distance metric between the given player's components of two states,
+  // according to that player's subsystem.
+  float PlayerDistanceBetween(PlayerIndex player_idx, const VectorXf& x0,
+                              const VectorXf& x1) const;
+
   // Getters.
   const FlatSubsystemList& Subsystems() const { return subsystems_; }
   PlayerIndex NumPlayers() const { return subsystems_.size(); }
@@ -107,6 +116,13 @@ class ConcatenatedFlatSystem : public MultiPlayerFlatSystem {
 
   // Cumulative sum of dimensions of each subsystem.
   std::vector<Dimension> subsystem_start_dims_;
+
+  // Size the given buffers for changing cost coordinates, unless they already
+  // are sized for this system.
+  void ResizeCostCoordinateBuffers(CostCoordinateBuffers* buffers) const;
+
+  // Largest state dimension of any subsystem.
+  Dimension max_subsystem_xdim_;
 };  // namespace ilqgames
 
 }  // namespace ilqgames
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Derivatives of SinglePlayerFlatCar6D, generated from a symbolic model.
+// NOTE: automatically generated by
+// python/generate_dynamics_derivatives.py. Edit the model there and
+// regenerate rather than editing this file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_DYNAMICS_GENERATED_SINGLE_PLAYER_FLAT_CAR_6D_DERIVATIVES_H
+#define ILQGAMES_DYNAMICS_GENERATED_SINGLE_PLAYER_FLAT_CAR_6D_DERIVATIVES_H
+
+#include <ilqgames/utils/types.h>
+
+#include <cmath>
+#include <vector>
+
+namespace ilqgames {
+namespace generated {
+
+// First and second partials of the map from xi to x for SinglePlayerFlatCar6D:
+//   grads[k] = dx_k/dxi and hesses[k] = d2x_k/dxi2.
+// NOTE: assumes grads, hesses already sized and zeroed and only writes
+// structurally nonzero entries.
+inline void PartialSinglePlayerFlatCar6D(float inter_axle_distance,
+    const VectorXf& xi, std::vector<VectorXf>* grads,
+    std::vector<MatrixXf>* hesses) {
+  const float vx = xi(2);
+  const float vy = xi(3);
+  const float ax = xi(4);
+  const float ay = xi(5);
+
+  const float tmp0 = vx * vx;
+  const float tmp1 = vy * vy;
+  const float tmp2 = tmp0 + tmp1;
+  const float tmp3 = 1.0f / tmp2;
+  const float tmp4 = 1.0f / (tmp2 * tmp2);
+  const float tmp5 = vx * vy;
+  const float tmp6 = 2.0f * tmp5;
+  const float tmp7 = tmp4 * tmp6;
+  const float tmp8 = -tmp1;
+  const float tmp9 = ax * vy;
+  const float tmp10 = ay * vx;
+  const float tmp11 = -tmp10;
+  const float tmp12 = tmp11 + tmp9;
+  const float tmp13 = ay * tmp2 + 3.0f * tmp12 * vx;
+  const float tmp14 = std::sqrt(tmp2);
+  const float tmp15 = inter_axle_distance * inter_axle_distance;
+  const float tmp16 = (tmp12 * tmp12) * tmp15 + (tmp2 * tmp2 * tmp2);
+  const float tmp17 = inter_axle_distance / tmp16;
+  const float tmp18 = tmp14 * tmp17;
+  const float tmp19 = ax * tmp2 - 3.0f * tmp12 * vy;
+  const float tmp20 = tmp2 * std::sqrt(tmp2);
+  const float tmp21 = tmp17 * tmp20;
+  const float tmp22 = 2.0f * tmp12 * tmp15;
+  const float tmp23 = 5.0f * tmp12;
+  const float tmp24 = 3.0f * tmp16;
+  const float tmp25 = 1.0f / tmp14;
+  const float tmp26 = 1.0f / (tmp16 * tmp16);
+  const float tmp27 = inter_axle_distance * tmp26;
+  const float tmp28 = tmp25 * tmp27;
+  const float tmp29 = ax * vx;
+  const float tmp30 = ay * vy;
+  const float tmp31 = tmp13 * tmp22;
+  const float tmp32 = tmp14 * tmp27;
+  const float tmp33 = 2.0f * tmp0;
+  const float tmp34 = tmp19 * tmp22;
+  const float tmp35 = (inter_axle_distance * inter_axle_distance
+      * inter_axle_distance) * tmp12 * tmp20 * tmp26;
+  const float tmp36 = tmp25 * vx;
+  const float tmp37 = tmp25 * vy;
+  const float tmp38 = 1.0f / tmp20;
+  const float tmp39 = tmp1 * tmp38;
+  const float tmp40 = tmp38 * vy;
+  const float tmp41 = -tmp40 * vx;
+  const float tmp42 = tmp0 * tmp38;
+  const float tmp43 = 1.0f / ((tmp2 * tmp2) * std::sqrt(tmp2));
+  const float tmp44 = 3.0f * tmp29 + 3.0f * tmp30;
+
+  (*grads)[0](0) = 1.0f;
+  (*grads)[1](1) = 1.0f;
+  (*grads)[2](2) = -tmp3 * vy;
+  (*grads)[2](3) = tmp3 * vx;
+  (*hesses)[2](2, 2) = tmp7;
+  (*hesses)[2](2, 3) = (*hesses)[2](3, 2) = tmp4 * (-tmp0 - tmp8);
+  (*hesses)[2](3, 3) = -tmp7;
+  (*grads)[3](2) = tmp13 * tmp18;
+  (*grads)[3](3) = -tmp18 * tmp19;
+  (*grads)[3](4) = -tmp21 * vy;
+  (*grads)[3](5) = tmp21 * vx;
+  (*hesses)[3](2, 2) = tmp28 * ((tmp13 * tmp13) * tmp22 + tmp24 * (-tmp0
+      * tmp23 + tmp2 * (-3.0f * tmp10 + tmp9)));
+  (*hesses)[3](2, 3) = (*hesses)[3](3, 2) = tmp28 * (3.0f * tmp16 * (tmp2
+      * (tmp29 - tmp30) - tmp23 * tmp5) - tmp19 * tmp31);
+  (*hesses)[3](2, 4) = (*hesses)[3](4, 2) = tmp32 * vy * (3.0f * tmp16 * vx
+      - tmp31);
+  (*hesses)[3](2, 5) = (*hesses)[3](5, 2) = tmp32 * (tmp16 * (-tmp33 - tmp8)
+      + tmp31 * vx);
+  (*hesses)[3](3, 3) = tmp28 * ((tmp19 * tmp19) * tmp22 + tmp24 * (-tmp1
+      * tmp23 + tmp2 * (tmp11 + 3.0f * tmp9)));
+  (*hesses)[3](3, 4) = (*hesses)[3](4, 3) = tmp32 * (tmp16 * (-tmp0 + 2.0f
+      * tmp1) + tmp34 * vy);
+  (*hesses)[3](3, 5) = (*hesses)[3](5, 3) = tmp32 * vx * (-tmp24 * vy - tmp34);
+  (*hesses)[3](4, 4) = 2.0f * tmp1 * tmp35;
+  (*hesses)[3](4, 5) = (*hesses)[3](5, 4) = -tmp35 * tmp6;
+  (*hesses)[3](5, 5) = tmp33 * tmp35;
+  (*grads)[4](2) = tmp36;
+  (*grads)[4](3) = tmp37;
+  (*hesses)[4](2, 2) = tmp39;
+  (*hesses)[4](2, 3) = (*hesses)[4](3, 2) = tmp41;
+  (*hesses)[4](3, 3) = tmp42;
+  (*grads)[5](2) = tmp12 * tmp40;
+  (*grads)[5](3) = -tmp12 * tmp38 * vx;
+  (*grads)[5](4) = tmp36;
+  (*grads)[5](5) = tmp37;
+  (*hesses)[5](2, 2) = tmp43 * (tmp0 * tmp44 - tmp2 * (3.0f * tmp29 + tmp30));
+  (*hesses)[5](2, 3) = (*hesses)[5](3, 2) = tmp43 * (-tmp2 * (tmp10 + tmp9)
+      + tmp44 * tmp5);
+  (*hesses)[5](2, 4) = (*hesses)[5](4, 2) = tmp39;
+  (*hesses)[5](2, 5) = (*hesses)[5](5, 2) = tmp41;
+  (*hesses)[5](3, 3) = tmp43 * (tmp1 * tmp44 - tmp2 * (tmp29 + 3.0f * tmp30));
+  (*hesses)[5](3, 4) = (*hesses)[5](4, 3) = tmp41;
+  (*hesses)[5](3, 5) = (*hesses)[5](5, 3) = tmp42;
+}
+
+}  // namespace generated
+}  // namespace ilqgames
+
+#endif
@@ -36,57 +36,59 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-// Keeps track of elapsed time (e.g., during loops) and provides an upper bound
-// on the runtime of the next loop. To reduce memory consumption and adapt to
-// changing processor activity, computes statistics based on a moving window of
-// specified length.
+// Derivatives of SinglePlayerFlatUnicycle4D, generated from a symbolic model.
+// NOTE: automatically generated by
+// python/generate_dynamics_derivatives.py. Edit the model there and
+// regenerate rather than editing this file.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <ilqgames/utils/loop_timer.h>
+#ifndef ILQGAMES_DYNAMICS_GENERATED_SINGLE_PLAYER_FLAT_UNICYCLE_4D_DERIVATIVES_H
+#define ILQGAMES_DYNAMICS_GENERATED_SINGLE_PLAYER_FLAT_UNICYCLE_4D_DERIVATIVES_H
+
 #include <ilqgames/utils/types.h>
 
-#include <glog/logging.h>
-#include <chrono>
-#include <list>
+#include <cmath>
+#include <vector>
 
 namespace ilqgames {
+namespace generated {
 
-void LoopTimer::Tic() { start_ = std::chrono::high_resolution_clock::now(); }
-
-void LoopTimer::Toc() {
-  // Elapsed time in seconds.
-  const Time elapsed = (std::chrono::duration<Time>(
-                            std::chrono::high_resolution_clock::now() - start_))
-                           .count();
-
-  // Add to queue and pop if queue is too long.
-  loop_times_.push_back(elapsed);
-  total_time_ += elapsed;
-
-  if (loop_times_.size() > max_samples_) {
-    total_time_ -= loop_times_.front();
-    loop_times_.pop_front();
-  }
-}
-
-Time LoopTimer::RuntimeUpperBound(float num_stddevs, Time initial_guess) const {
-  // Handle not enough data.
-  if (loop_times_.size() < 2) return initial_guess;
+// First and second partials of the map from xi to x for
+// SinglePlayerFlatUnicycle4D:
+//   grads[k] = dx_k/dxi and hesses[k] = d2x_k/dxi2.
+// NOTE: assumes grads, hesses already sized and zeroed and only writes
+// structurally nonzero entries.
+inline void PartialSinglePlayerFlatUnicycle4D(const VectorXf& xi,
+    std::vector<VectorXf>* grads, std::vector<MatrixXf>* hesses) {
+  const float vx = xi(2);
+  const float vy = xi(3);
 
-  // Compute mean and variance.
-  const Time mean = total_time_ / static_cast<Time>(loop_times_.size());
-  Time variance = 0.0;
-  for (const Time entry : loop_times_) {
-    const Time diff = entry - mean;
-    variance += diff * diff;
-  }
+  const float tmp0 = vx * vx;
+  const float tmp1 = vy * vy;
+  const float tmp2 = tmp0 + tmp1;
+  const float tmp3 = 1.0f / tmp2;
+  const float tmp4 = 1.0f / (tmp2 * tmp2);
+  const float tmp5 = vx * vy;
+  const float tmp6 = 2.0f * tmp4 * tmp5;
+  const float tmp7 = 1.0f / (std::sqrt(tmp2));
+  const float tmp8 = 1.0f / (tmp2 * std::sqrt(tmp2));
 
-  // Unbiased estimator of variance should divide by N - 1, not N.
-  variance /= static_cast<Time>(loop_times_.size() - 1);
-
-  // Compute upper bound.
-  return mean + num_stddevs * std::sqrt(variance);
+  (*grads)[0](0) = 1.0f;
+  (*grads)[1](1) = 1.0f;
+  (*grads)[2](2) = -tmp3 * vy;
+  (*grads)[2](3) = tmp3 * vx;
+  (*hesses)[2](2, 2) = tmp6;
+  (*hesses)[2](2, 3) = (*hesses)[2](3, 2) = tmp4 * (-tmp0 + tmp1);
+  (*hesses)[2](3, 3) = -tmp6;
+  (*grads)[3](2) = tmp7 * vx;
+  (*grads)[3](3) = tmp7 * vy;
+  (*hesses)[3](2, 2) = tmp1 * tmp8;
+  (*hesses)[3](2, 3) = (*hesses)[3](3, 2) = -tmp5 * tmp8;
+  (*hesses)[3](3, 3) = tmp0 * tmp8;
 }
 
+}  // namespace generated
 }  // namespace ilqgames
+
+#endif
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Derivatives of SinglePlayerUnicycle4D, generated from a symbolic model.
+// NOTE: automatically generated by
+// python/generate_dynamics_derivatives.py. Edit the model there and
+// regenerate rather than editing this file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_DYNAMICS_GENERATED_SINGLE_PLAYER_UNICYCLE_4D_DERIVATIVES_H
+#define ILQGAMES_DYNAMICS_GENERATED_SINGLE_PLAYER_UNICYCLE_4D_DERIVATIVES_H
+
+#include <ilqgames/utils/linear_dynamics_approximation.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <cmath>
+#include <vector>
+
+namespace ilqgames {
+namespace generated {
+
+// Discrete-time Jacobian linearization of SinglePlayerUnicycle4D dynamics:
+//   A += time_step * df/dx and B = time_step * df/du.
+// NOTE: assumes A, B already initialized (to I, 0 respectively) and only writes
+// structurally nonzero entries.
+inline void LinearizeSinglePlayerUnicycle4D(Time time_step, const VectorXf& x,
+    const VectorXf& u, Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) {
+  const float dt = static_cast<float>(time_step);
+  const float theta = x(2);
+  const float v = x(3);
+
+  const float tmp0 = dt * std::sin(theta);
+  const float tmp1 = dt * std::cos(theta);
+
+  A(0, 2) += -tmp0 * v;
+  A(0, 3) += tmp1;
+  A(1, 2) += tmp1 * v;
+  A(1, 3) += tmp0;
+  B(2, 0) = dt;
+  B(3, 1) = dt;
+}
+
+// Batched discrete-time Jacobian linearization of SinglePlayerUnicycle4D
+// dynamics at each time step:
+//   A += time_step * df/dx and B = time_step * df/du.
+// Row kk of xs (us) holds the state (control) at time step kk, and results are
+// written into the kk-th linearization at the given state offset and player's
+// B.
+// NOTE: assumes A, B already initialized (to I, 0 respectively) and only writes
+// structurally nonzero entries.
+inline void LinearizeBatchSinglePlayerUnicycle4D(Time time_step,
+    const MatrixXf& xs, const MatrixXf& us, Dimension x_offset,
+    PlayerIndex player_idx,
+    std::vector<LinearDynamicsApproximation>* linearizations) {
+  CHECK_NOTNULL(linearizations);
+  CHECK_EQ(static_cast<size_t>(xs.rows()), linearizations->size());
+  CHECK_EQ(static_cast<size_t>(us.rows()), linearizations->size());
+
+  const float dt = static_cast<float>(time_step);
+  const auto theta = xs.col(2).array();
+  const auto v = xs.col(3).array();
+
+  const Eigen::ArrayXf tmp0 = dt * Eigen::sin(theta);
+  const Eigen::ArrayXf tmp1 = dt * Eigen::cos(theta);
+
+  const Eigen::ArrayXf entry0 = -tmp0 * v;
+  const Eigen::ArrayXf entry2 = tmp1 * v;
+
+  for (size_t kk = 0; kk < linearizations->size(); kk++) {
+    LinearDynamicsApproximation& lin = (*linearizations)[kk];
+    lin.A(x_offset + 0, x_offset + 2) += entry0(kk);
+    lin.A(x_offset + 0, x_offset + 3) += tmp1(kk);
+    lin.A(x_offset + 1, x_offset + 2) += entry2(kk);
+    lin.A(x_offset + 1, x_offset + 3) += tmp0(kk);
+    lin.Bs[player_idx](x_offset + 2, 0) = dt;
+    lin.Bs[player_idx](x_offset + 3, 1) = dt;
+  }
+}
+
+}  // namespace generated
+}  // namespace ilqgames
+
+#endif
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Explicit integrators for ODEs of the form dx/dt = f(t, x). Supports forward
+// Euler, Heun's method (RK2), classical RK4, and adaptive Dormand-Prince RK45
+// with error control. Fixed-step methods take the given number of substeps per
+// call; RK45 starts from that many substeps and adapts the step size to meet
+// its error tolerances. All intermediate stages are stored in buffers which
+// are reused across calls, so each caller (e.g., each solver) should own its
+// own integrator, and an integrator must not be shared across threads.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_DYNAMICS_INTEGRATOR_H
+#define ILQGAMES_DYNAMICS_INTEGRATOR_H
+
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ilqgames {
+
+enum class IntegrationMethod { EULER, HEUN, RK4, RK45 };
+
+class Integrator {
+ public:
+  ~Integrator() {}
+  explicit Integrator(IntegrationMethod method = IntegrationMethod::RK4,
+                      size_t num_substeps = 2)
+      : method_(method), num_substeps_(num_substeps) {
+    CHECK_GT(num_substeps_, 0);
+  }
+
+  // Integrate dx/dt = f(t, x) forward from time t0 for the given time
+  // interval, overwriting x. The derivative f must have signature
+  // void(Time t, const VectorXf& x, VectorXf* x_dot).
+  template <typename Derivative>
+  void Integrate(const Derivative& f, Time t0, Time time_interval,
+                 VectorXf* x);
+
+  // Set error tolerances for adaptive integration. The error in each
+  // dimension is scaled by the absolute tolerance plus the relative tolerance
+  // times the magnitude of the state.
+  void SetTolerances(float absolute_tolerance, float relative_tolerance) {
+    CHECK_GT(absolute_tolerance, 0.0);
+    CHECK_GE(relative_tolerance, 0.0);
+    absolute_tolerance_ = absolute_tolerance;
+    relative_tolerance_ = relative_tolerance;
+  }
+
+  // Accessors.
+  IntegrationMethod Method() const { return method_; }
+  size_t NumSubsteps() const { return num_substeps_; }
+
+ private:
+  // Take a single step of the given fixed-step method.
+  template <typename Derivative>
+  void EulerStep(const Derivative& f, Time t, Time dt, VectorXf* x);
+  template <typename Derivative>
+  void HeunStep(const Derivative& f, Time t, Time dt, VectorXf* x);
+  template <typename Derivative>
+  void RK4Step(const Derivative& f, Time t, Time dt, VectorXf* x);
+
+  // Integrate adaptively with the Dormand-Prince RK45 method. Checks that the
+  // final time is reached within a bounded number of steps.
+  template <typename Derivative>
+  void IntegrateRK45(const Derivative& f, Time t0, Time time_interval,
+                     VectorXf* x);
+
+  // Integration method and number of substeps per call.
+  IntegrationMethod method_;
+  size_t num_substeps_;
+
+  // Error tolerances for adaptive integration.
+  float absolute_tolerance_ = 1e-4;
+  float relative_tolerance_ = 1e-4;
+
+  // Buffers for intermediate stages.
+  VectorXf k1_, k2_, k3_, k4_, k5_, k6_, k7_;
+  VectorXf x_stage_, x_next_;
+};  //\class Integrator
+
+// ----------------------------- IMPLEMENTATION ----------------------------- //
+
+template <typename Derivative>
+void Integrator::Integrate(const Derivative& f, Time t0, Time time_interval,
+                           VectorXf* x) {
+  CHECK_NOTNULL(x);
+  if (time_interval <= 0.0) return;
+
+  if (method_ == IntegrationMethod::RK45) {
+    IntegrateRK45(f, t0, time_interval, x);
+    return;
+  }
+
+  const Time dt = time_interval / static_cast<Time>(num_substeps_);
+  for (size_t kk = 0; kk < num_substeps_; kk++) {
+    const Time t = t0 + dt * static_cast<Time>(kk);
+    switch (method_) {
+      case IntegrationMethod::EULER:
+        EulerStep(f, t, dt, x);
+        break;
+      case IntegrationMethod::HEUN:
+        HeunStep(f, t, dt, x);
+        break;
+      default:
+        RK4Step(f, t, dt, x);
+    }
+  }
+}
+
+template <typename Derivative>
+void Integrator::EulerStep(const Derivative& f, Time t, Time dt,
+                           VectorXf* x) {
+  f(t, *x, &k1_);
+  *x += dt * k1_;
+}
+
+template <typename Derivative>
+void Integrator::HeunStep(const Derivative& f, Time t, Time dt,
+                          VectorXf* x) {
+  f(t, *x, &k1_);
+  k1_ *= dt;
+
+  x_stage_ = *x + k1_;
+  f(t + dt, x_stage_, &k2_);
+  k2_ *= dt;
+
+  *x += 0.5 * (k1_ + k2_);
+}
+
+template <typename Derivative>
+void Integrator::RK4Step(const Derivative& f, Time t, Time dt,
+                         VectorXf* x) {
+  // See https://en.wikipedia.org/wiki/Runge-Kutta_methods for further details.
+  f(t, *x, &k1_);
+  k1_ *= dt;
+
+  x_stage_ = *x + 0.5 * k1_;
+  f(t + 0.5 * dt, x_stage_, &k2_);
+  k2_ *= dt;
+
+  x_stage_ = *x + 0.5 * k2_;
+  f(t + 0.5 * dt, x_stage_, &k3_);
+  k3_ *= dt;
+
+  x_stage_ = *x + k3_;
+  f(t + dt, x_stage_, &k4_);
+  k4_ *= dt;
+
+  *x += (k1_ + 2.0 * (k2_ + k3_) + k4_) / 6.0;
+}
+
+template <typename Derivative>
+void Integrator::IntegrateRK45(const Derivative& f, Time t0,
+                               Time time_interval, VectorXf* x) {
+  // Dormand-Prince coefficients. See
+  // https://en.wikipedia.org/wiki/Dormand%E2%80%93Prince_method for details.
+  constexpr float a21 = 1.0 / 5.0;
+  constexpr float a31 = 3.0 / 40.0, a32 = 9.0 / 40.0;
+  constexpr float a41 = 44.0 / 45.0, a42 = -56.0 / 15.0, a43 = 32.0 / 9.0;
+  constexpr float a51 = 19372.0 / 6561.0, a52 = -25360.0 / 2187.0,
+                  a53 = 64448.0 / 6561.0, a54 = -212.0 / 729.0;
+  constexpr float a61 = 9017.0 / 3168.0, a62 = -355.0 / 33.0,
+                  a63 = 46732.0 / 5247.0, a64 = 49.0 / 176.0,
+                  a65 = -5103.0 / 18656.0;
+  constexpr float b1 = 35.0 / 384.0, b3 = 500.0 / 1113.0, b4 = 125.0 / 192.0,
+                  b5 = -2187.0 / 6784.0, b6 = 11.0 / 84.0;
+
+  // Differences between fifth- and fourth-order weights, for error estimates.
+  constexpr float e1 = 71.0 / 57600.0, e3 = -71.0 / 16695.0,
+                  e4 = 71.0 / 1920.0, e5 = -17253.0 / 339200.0,
+                  e6 = 22.0 / 525.0, e7 = -1.0 / 40.0;
+
+  // Step size adaptation parameters.
+  constexpr float kSafetyFactor = 0.9;
+  constexpr float kMinScaling = 0.2;
+  constexpr float kMaxScaling = 5.0;
+  constexpr size_t kMaxNumSteps = 1000;
+
+  const Time t_final = t0 + time_interval;
+  const Time min_dt = constants::kSmallNumber * time_interval;
+  Time dt = time_interval / static_cast<Time>(num_substeps_);
+  Time t = t0;
+
+  // The last stage of each step is the derivative at the next point (first
+  // same as last), so the first stage is only evaluated once up front.
+  f(t, *x, &k1_);
+  for (size_t num_steps = 0; num_steps < kMaxNumSteps && t < t_final;
+       num_steps++) {
+    const bool is_last_step = dt >= t_final - t;
+    if (is_last_step) dt = t_final - t;
+
+    x_stage_ = *x + dt * (a21 * k1_);
+    f(t + 0.2 * dt, x_stage_, &k2_);
+    x_stage_ = *x + dt * (a31 * k1_ + a32 * k2_);
+    f(t + 0.3 * dt, x_stage_, &k3_);
+    x_stage_ = *x + dt * (a41 * k1_ + a42 * k2_ + a43 * k3_);
+    f(t + 0.8 * dt, x_stage_, &k4_);
+    x_stage_ = *x + dt * (a51 * k1_ + a52 * k2_ + a53 * k3_ + a54 * k4_);
+    f(t + (8.0 / 9.0) * dt, x_stage_, &k5_);
+    x_stage_ = *x + dt * (a61 * k1_ + a62 * k2_ + a63 * k3_ + a64 * k4_ +
+                          a65 * k5_);
+    f(t + dt, x_stage_, &k6_);
+    x_next_ = *x + dt * (b1 * k1_ + b3 * k3_ + b4 * k4_ + b5 * k5_ + b6 * k6_);
+    f(t + dt, x_next_, &k7_);
+
+    // Scaled error estimate (infinity norm). Reuse the stage buffer.
+    x_stage_ = dt * (e1 * k1_ + e3 * k3_ + e4 * k4_ + e5 * k5_ + e6 * k6_ +
+                     e7 * k7_);
+    float error = 0.0;
+    for (int ii = 0; ii < x->size(); ii++) {
+      const float scale =
+          absolute_tolerance_ +
+          relative_tolerance_ *
+              std::max(std::abs((*x)(ii)), std::abs(x_next_(ii)));
+      error = std::max(error, std::abs(x_stage_(ii)) / scale);
+    }
+
+    // Accept the step if the error is within tolerance, or if the step size
+    // cannot shrink any further. Otherwise, the first stage is still valid.
+    if (error <= 1.0 || dt <= min_dt) {
+      t = (is_last_step) ? t_final : t + dt;
+      x->swap(x_next_);
+      k1_.swap(k7_);
+    }
+
+    // Adapt step size for the next step.
+    const float scaling =
+        (error > 0.0) ? kSafetyFactor * std::pow(error, -0.2f) : kMaxScaling;
+    dt = std::max(min_dt, dt * std::min(kMaxScaling,
+                                        std::max(kMinScaling, scaling)));
+  }
+
+  CHECK_GE(t, t_final) << "RK45 integration did not reach final time within "
+                       << kMaxNumSteps << " steps.";
+}
+
+}  // namespace ilqgames
+
+#endif
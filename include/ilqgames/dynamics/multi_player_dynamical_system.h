@@ -66,9 +66,19 @@ class MultiPlayerDynamicalSystem : public MultiPlayerIntegrableSystem {
   virtual LinearDynamicsApproximation Linearize(
       Time t, const VectorXf& x, const std::vector<VectorXf>& us) const = 0;
 
-  // Integrate these dynamics forward in time.
+  // Compute discrete-time Jacobian linearizations at every time step of a
+  // trajectory starting at time t0. By default, linearizes one time step at a
+  // time.
+  virtual void LinearizeBatch(
+      Time t0, const std::vector<VectorXf>& xs,
+      const std::vector<std::vector<VectorXf>>& us,
+      std::vector<LinearDynamicsApproximation>* linearizations) const;
+
+  // Integrate these dynamics forward in time, with the given integrator (if
+  // any) or else a default integrator kept per thread.
   VectorXf Integrate(Time t0, Time time_interval, const VectorXf& x0,
-                     const std::vector<VectorXf>& us) const;
+                     const std::vector<VectorXf>& us,
+                     Integrator* integrator = nullptr) const;
 
   // Getters.
   virtual Dimension UDim(PlayerIndex player_idx) const = 0;
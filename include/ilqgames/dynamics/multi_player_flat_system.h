@@ -55,6 +55,23 @@
 
 namespace ilqgames {
 
+// Buffers for changing cost coordinates from x to xi, which are reused across
+// calls. Each caller (e.g., each solver) should own its own buffers, and
+// buffers must not be shared across threads.
+struct CostCoordinateBuffers {
+  // First and second partials of the map from xi to x and corresponding
+  // Jacobian for each subsystem.
+  std::vector<std::vector<VectorXf>> first_partials;
+  std::vector<std::vector<MatrixXf>> second_partials;
+  std::vector<MatrixXf> jacobians;
+
+  // Product of a single block of a cost Hessian with a Jacobian, and
+  // transformed cost Hessian and gradient.
+  MatrixXf block_product;
+  MatrixXf hess;
+  VectorXf grad;
+};  // struct CostCoordinateBuffers
+
 class MultiPlayerFlatSystem : public MultiPlayerIntegrableSystem {
  public:
   virtual ~MultiPlayerFlatSystem() {}
@@ -73,9 +90,11 @@ class MultiPlayerFlatSystem : public MultiPlayerIntegrableSystem {
   virtual VectorXf ToLinearSystemState(const VectorXf& x) const = 0;
   virtual VectorXf FromLinearSystemState(const VectorXf& xi) const = 0;
 
-  // Gradient and hessian of map from xi to x.
+  // Gradient and hessian of map from xi to x. Uses the given buffers (if any),
+  // or else buffers local to the call, so that concurrent calls are safe.
   virtual void ChangeCostCoordinates(
-      const VectorXf& xi, std::vector<QuadraticCostApproximation>* q) const = 0;
+      const VectorXf& xi, std::vector<QuadraticCostApproximation>* q,
+      CostCoordinateBuffers* buffers = nullptr) const = 0;
   virtual void ChangeControlCostCoordinates(
       const VectorXf& xi, std::vector<QuadraticCostApproximation>* q) const = 0;
 
@@ -84,12 +103,16 @@ class MultiPlayerFlatSystem : public MultiPlayerIntegrableSystem {
 
   // Integrate these dynamics forward in time.
   // Options include integration for a single timestep, between arbitrary times,
-  // and within a single timestep.
+  // and within a single timestep. Single timesteps use the exact discrete time
+  // system, and otherwise integrates with the given integrator (if any) or else
+  // a default integrator kept per thread.
   VectorXf Integrate(Time time_interval, const VectorXf& xi0,
-                     const std::vector<VectorXf>& vs) const;
+                     const std::vector<VectorXf>& vs,
+                     Integrator* integrator = nullptr) const;
   VectorXf Integrate(Time t0, Time time_interval, const VectorXf& xi0,
-                     const std::vector<VectorXf>& vs) const {
-    return Integrate(time_interval, xi0, vs);
+                     const std::vector<VectorXf>& vs,
+                     Integrator* integrator = nullptr) const {
+    return Integrate(time_interval, xi0, vs, integrator);
   }
 
   // Can this system be treated as linear for the purposes of LQ solves?
@@ -110,7 +133,9 @@ class MultiPlayerFlatSystem : public MultiPlayerIntegrableSystem {
   MultiPlayerFlatSystem(Dimension xdim, Time time_step)
       : MultiPlayerIntegrableSystem(xdim, time_step) {}
 
-  // Discrete time approximation of the underlying linearized system.
+  // Compute the underlying linearized system in continuous time, and its exact
+  // (zero-order hold) discretization. Derived classes must call this from
+  // their constructors, since Integrate expects both to be populated.
   virtual void ComputeLinearizedSystem() const = 0;
 
   // Linearized system (discrete and continuous time).
@@ -44,6 +44,7 @@
 #ifndef ILQGAMES_DYNAMICS_MULTI_PLAYER_INTEGRABLE_SYSTEM_H
 #define ILQGAMES_DYNAMICS_MULTI_PLAYER_INTEGRABLE_SYSTEM_H
 
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/utils/operating_point.h>
 #include <ilqgames/utils/strategy.h>
 #include <ilqgames/utils/types.h>
@@ -58,21 +59,30 @@ class MultiPlayerIntegrableSystem {
 
   // Integrate these dynamics forward in time.
   // Options include integration for a single timestep, between arbitrary times,
-  // and within a single timestep.
+  // and within a single timestep. Integration fidelity is a caller's setting
+  // rather than part of the system itself, so callers may pass their own
+  // integrator (whose buffers are reused across calls). Otherwise, calls
+  // integrate with a default integrator kept per thread, so that concurrent
+  // calls are safe.
   virtual VectorXf Integrate(Time t0, Time time_interval, const VectorXf& x0,
-                             const std::vector<VectorXf>& us) const = 0;
+                             const std::vector<VectorXf>& us,
+                             Integrator* integrator = nullptr) const = 0;
   VectorXf Integrate(Time t0, Time t, const VectorXf& x0,
                      const OperatingPoint& operating_point,
-                     const std::vector<Strategy>& strategies) const;
+                     const std::vector<Strategy>& strategies,
+                     Integrator* integrator = nullptr) const;
   VectorXf Integrate(size_t initial_timestep, size_t final_timestep,
                      const VectorXf& x0, const OperatingPoint& operating_point,
-                     const std::vector<Strategy>& strategies) const;
-  VectorXf IntegrateToNextTimeStep(
-      Time t0, const VectorXf& x0, const OperatingPoint& operating_point,
-      const std::vector<Strategy>& strategies) const;
-  VectorXf IntegrateFromPriorTimeStep(
-      Time t, const VectorXf& x0, const OperatingPoint& operating_point,
-      const std::vector<Strategy>& strategies) const;
+                     const std::vector<Strategy>& strategies,
+                     Integrator* integrator = nullptr) const;
+  VectorXf IntegrateToNextTimeStep(Time t0, const VectorXf& x0,
+                                   const OperatingPoint& operating_point,
+                                   const std::vector<Strategy>& strategies,
+                                   Integrator* integrator = nullptr) const;
+  VectorXf IntegrateFromPriorTimeStep(Time t, const VectorXf& x0,
+                                      const OperatingPoint& operating_point,
+                                      const std::vector<Strategy>& strategies,
+                                      Integrator* integrator = nullptr) const;
 
   // Can this system be treated as linear for the purposes of LQ solves?
   // For example, linear systems and feedback linearizable systems should return
@@ -104,6 +114,14 @@ class MultiPlayerIntegrableSystem {
     return (x0 - x1).squaredNorm();
   }
 
+  // Distance metric between the given player's components of two states, which
+  // is also *squared*. By default, just the distance between full states.
+  virtual float PlayerDistanceBetween(PlayerIndex player_idx,
+                                      const VectorXf& x0,
+                                      const VectorXf& x1) const {
+    return DistanceBetween(x0, x1);
+  }
+
  protected:
   MultiPlayerIntegrableSystem(Dimension xdim, Time time_step)
       : xdim_(xdim), time_step_(time_step) {}
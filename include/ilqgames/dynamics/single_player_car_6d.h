@@ -53,9 +53,13 @@
 #ifndef ILQGAMES_DYNAMICS_SINGLE_PLAYER_CAR_6D_H
 #define ILQGAMES_DYNAMICS_SINGLE_PLAYER_CAR_6D_H
 
+#include <ilqgames/dynamics/generated/single_player_car_6d_derivatives.h>
 #include <ilqgames/dynamics/single_player_dynamical_system.h>
+#include <ilqgames/utils/linear_dynamics_approximation.h>
 #include <ilqgames/utils/types.h>
 
+#include <vector>
+
 namespace ilqgames {
 
 class SinglePlayerCar6D : public SinglePlayerDynamicalSystem {
@@ -72,6 +76,12 @@ class SinglePlayerCar6D : public SinglePlayerDynamicalSystem {
   void Linearize(Time t, Time time_step, const VectorXf& x, const VectorXf& u,
                  Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) const;
 
+  // Compute discrete-time Jacobian linearizations at a batch of time steps.
+  void LinearizeBatch(
+      Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+      Dimension x_offset, PlayerIndex player_idx,
+      std::vector<LinearDynamicsApproximation>* linearizations) const;
+
   // Distance metric between two states.
   float DistanceBetween(const VectorXf& x0, const VectorXf& x1) const;
 
@@ -113,25 +123,17 @@ inline void SinglePlayerCar6D::Linearize(Time t, Time time_step,
                                          const VectorXf& x, const VectorXf& u,
                                          Eigen::Ref<MatrixXf> A,
                                          Eigen::Ref<MatrixXf> B) const {
-  const float ctheta = std::cos(x(kThetaIdx)) * time_step;
-  const float stheta = std::sin(x(kThetaIdx)) * time_step;
-  const float cphi = std::cos(x(kPhiIdx));
-  const float tphi = std::tan(x(kPhiIdx));
-
-  A(kPxIdx, kThetaIdx) += -x(kVIdx) * stheta;
-  A(kPxIdx, kVIdx) += ctheta;
-
-  A(kPyIdx, kThetaIdx) += x(kVIdx) * ctheta;
-  A(kPyIdx, kVIdx) += stheta;
-
-  A(kThetaIdx, kPhiIdx) +=
-      x(kVIdx) * time_step / (inter_axle_distance_ * cphi * cphi);
-  A(kThetaIdx, kVIdx) += tphi * time_step / inter_axle_distance_;
-
-  A(kVIdx, kAIdx) += time_step;
+  generated::LinearizeSinglePlayerCar6D(inter_axle_distance_, time_step, x, u,
+                                        A, B);
+}
 
-  B(kPhiIdx, kOmegaIdx) = time_step;
-  B(kAIdx, kJerkIdx) = time_step;
+inline void SinglePlayerCar6D::LinearizeBatch(
+    Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+    Dimension x_offset, PlayerIndex player_idx,
+    std::vector<LinearDynamicsApproximation>* linearizations) const {
+  generated::LinearizeBatchSinglePlayerCar6D(inter_axle_distance_, time_step,
+                                             xs, us, x_offset, player_idx,
+                                             linearizations);
 }
 
 inline float SinglePlayerCar6D::DistanceBetween(const VectorXf& x0,
@@ -48,9 +48,13 @@
 #ifndef ILQGAMES_DYNAMICS_SINGLE_PLAYER_DUBINS_CAR_H
 #define ILQGAMES_DYNAMICS_SINGLE_PLAYER_DUBINS_CAR_H
 
+#include <ilqgames/dynamics/generated/single_player_dubins_car_derivatives.h>
 #include <ilqgames/dynamics/single_player_dynamical_system.h>
+#include <ilqgames/utils/linear_dynamics_approximation.h>
 #include <ilqgames/utils/types.h>
 
+#include <vector>
+
 #include <glog/logging.h>
 
 namespace ilqgames {
@@ -70,6 +74,12 @@ class SinglePlayerDubinsCar : public SinglePlayerDynamicalSystem {
   void Linearize(Time t, Time time_step, const VectorXf& x, const VectorXf& u,
                  Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) const;
 
+  // Compute discrete-time Jacobian linearizations at a batch of time steps.
+  void LinearizeBatch(
+      Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+      Dimension x_offset, PlayerIndex player_idx,
+      std::vector<LinearDynamicsApproximation>* linearizations) const;
+
   // Constexprs for state indices.
   static const Dimension kNumXDims;
   static const Dimension kPxIdx;
@@ -102,13 +112,16 @@ inline void SinglePlayerDubinsCar::Linearize(Time t, Time time_step,
                                              const VectorXf& u,
                                              Eigen::Ref<MatrixXf> A,
                                              Eigen::Ref<MatrixXf> B) const {
-  const float ctheta = std::cos(x(kThetaIdx)) * time_step;
-  const float stheta = std::sin(x(kThetaIdx)) * time_step;
-
-  A(kPxIdx, kThetaIdx) += -v_ * stheta;
-  A(kPyIdx, kThetaIdx) += v_ * ctheta;
+  generated::LinearizeSinglePlayerDubinsCar(v_, time_step, x, u, A, B);
+}
 
-  B(kThetaIdx, kOmegaIdx) = time_step;
+inline void SinglePlayerDubinsCar::LinearizeBatch(
+    Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+    Dimension x_offset, PlayerIndex player_idx,
+    std::vector<LinearDynamicsApproximation>* linearizations) const {
+  generated::LinearizeBatchSinglePlayerDubinsCar(v_, time_step, xs, us,
+                                                 x_offset, player_idx,
+                                                 linearizations);
 }
 
 }  // namespace ilqgames
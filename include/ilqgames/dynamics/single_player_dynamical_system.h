@@ -44,8 +44,12 @@
 #ifndef ILQGAMES_DYNAMICS_SINGLE_PLAYER_DYNAMICAL_SYSTEM_H
 #define ILQGAMES_DYNAMICS_SINGLE_PLAYER_DYNAMICAL_SYSTEM_H
 
+#include <ilqgames/utils/linear_dynamics_approximation.h>
 #include <ilqgames/utils/types.h>
 
+#include <glog/logging.h>
+#include <vector>
+
 namespace ilqgames {
 
 class SinglePlayerDynamicalSystem {
@@ -65,6 +69,18 @@ class SinglePlayerDynamicalSystem {
                          const VectorXf& u, Eigen::Ref<MatrixXf> A,
                          Eigen::Ref<MatrixXf> B) const = 0;
 
+  // Compute discrete-time Jacobian linearizations at a batch of time steps
+  // starting at t0. States and controls are stored struct-of-arrays, i.e., row
+  // kk of xs (us) is the state (control) at time step kk, so each dimension is
+  // contiguous across time. Results are written into the kk-th linearization,
+  // in the blocks starting at the given state offset and in the given player's
+  // B. By default, linearizes one time step at a time.
+  // NOTE: assumes A, B already initialized (to I, 0 respectively) for speed.
+  virtual void LinearizeBatch(
+      Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+      Dimension x_offset, PlayerIndex player_idx,
+      std::vector<LinearDynamicsApproximation>* linearizations) const;
+
   // Distance metric on the state space. By default, just the *squared* 2-norm.
   virtual float DistanceBetween(const VectorXf& x0, const VectorXf& x1) const {
     return (x0 - x1).squaredNorm();
@@ -83,6 +99,25 @@ class SinglePlayerDynamicalSystem {
   const Dimension udim_;
 };  //\class SinglePlayerDynamicalSystem
 
+// ----------------------------- IMPLEMENTATION ----------------------------- //
+
+inline void SinglePlayerDynamicalSystem::LinearizeBatch(
+    Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+    Dimension x_offset, PlayerIndex player_idx,
+    std::vector<LinearDynamicsApproximation>* linearizations) const {
+  CHECK_NOTNULL(linearizations);
+  CHECK_EQ(static_cast<size_t>(xs.rows()), linearizations->size());
+  CHECK_EQ(static_cast<size_t>(us.rows()), linearizations->size());
+
+  for (size_t kk = 0; kk < linearizations->size(); kk++) {
+    auto& lin = (*linearizations)[kk];
+    Linearize(t0 + time_step * static_cast<Time>(kk), time_step,
+              xs.row(kk).transpose(), us.row(kk).transpose(),
+              lin.A.block(x_offset, x_offset, xdim_, xdim_),
+              lin.Bs[player_idx].block(x_offset, 0, xdim_, udim_));
+  }
+}
+
 }  // namespace ilqgames
 
 #endif
@@ -70,9 +70,11 @@ class SinglePlayerFlatCar6D : public SinglePlayerFlatSystem {
   // Compute time derivative of state.
   VectorXf Evaluate(const VectorXf& x, const VectorXf& u) const;
 
-  // Discrete time approximation of the underlying linearized system.
+  // Exact discrete and continuous time underlying linearized systems.
   void LinearizedSystem(Time time_step, Eigen::Ref<MatrixXf> A,
                         Eigen::Ref<MatrixXf> B) const;
+  void ContinuousLinearizedSystem(Eigen::Ref<MatrixXf> A,
+                                  Eigen::Ref<MatrixXf> B) const;
 
   // Utilities for feedback linearization.
   MatrixXf InverseDecouplingMatrix(const VectorXf& x) const;
@@ -126,15 +128,36 @@ inline VectorXf SinglePlayerFlatCar6D::Evaluate(const VectorXf& x,
 
 inline void SinglePlayerFlatCar6D::LinearizedSystem(
     Time time_step, Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) const {
+  // Each axis is a triple integrator, so zero-order hold discretization has a
+  // simple closed form.
+  const Time half_time_step_sq = 0.5 * time_step * time_step;
+  const Time sixth_time_step_cubed = half_time_step_sq * time_step / 3.0;
   A(kPxIdx, kVxIdx) += time_step;
   A(kPyIdx, kVyIdx) += time_step;
   A(kVxIdx, kAxIdx) += time_step;
   A(kVyIdx, kAyIdx) += time_step;
+  A(kPxIdx, kAxIdx) += half_time_step_sq;
+  A(kPyIdx, kAyIdx) += half_time_step_sq;
 
+  B(kPxIdx, 0) = sixth_time_step_cubed;
+  B(kPyIdx, 1) = sixth_time_step_cubed;
+  B(kVxIdx, 0) = half_time_step_sq;
+  B(kVyIdx, 1) = half_time_step_sq;
   B(kAxIdx, 0) = time_step;
   B(kAyIdx, 1) = time_step;
 }
 
+inline void SinglePlayerFlatCar6D::ContinuousLinearizedSystem(
+    Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) const {
+  A(kPxIdx, kVxIdx) = 1.0;
+  A(kPyIdx, kVyIdx) = 1.0;
+  A(kVxIdx, kAxIdx) = 1.0;
+  A(kVyIdx, kAyIdx) = 1.0;
+
+  B(kAxIdx, 0) = 1.0;
+  B(kAyIdx, 1) = 1.0;
+}
+
 inline MatrixXf SinglePlayerFlatCar6D::InverseDecouplingMatrix(
     const VectorXf& x) const {
   MatrixXf M_inv(kNumUDims, kNumUDims);
@@ -55,10 +55,16 @@ class SinglePlayerFlatSystem {
   // Compute time derivative of state.
   virtual VectorXf Evaluate(const VectorXf& x, const VectorXf& u) const = 0;
 
-  // Discrete time approximation of the underlying linearized system.
+  // Exact (zero-order hold) discretization of the underlying linearized
+  // system. A should be initialized to identity and B to zero.
   virtual void LinearizedSystem(Time time_step, Eigen::Ref<MatrixXf> A,
                                 Eigen::Ref<MatrixXf> B) const = 0;
 
+  // Continuous time underlying linearized system. A and B should be
+  // initialized to zero.
+  virtual void ContinuousLinearizedSystem(Eigen::Ref<MatrixXf> A,
+                                          Eigen::Ref<MatrixXf> B) const = 0;
+
   // Utilities for feedback linearization.
   virtual MatrixXf InverseDecouplingMatrix(const VectorXf& x) const = 0;
   virtual VectorXf AffineTerm(const VectorXf& x) const = 0;
@@ -52,6 +52,7 @@
 #ifndef ILQGAMES_DYNAMICS_SINGLE_PLAYER_FLAT_UNICYCLE_4D_H
 #define ILQGAMES_DYNAMICS_SINGLE_PLAYER_FLAT_UNICYCLE_4D_H
 
+#include <ilqgames/dynamics/generated/single_player_flat_unicycle_4d_derivatives.h>
 #include <ilqgames/dynamics/single_player_flat_system.h>
 #include <ilqgames/utils/types.h>
 
@@ -67,9 +68,11 @@ class SinglePlayerFlatUnicycle4D : public SinglePlayerFlatSystem {
   // Compute time derivative of state.
   VectorXf Evaluate(const VectorXf& x, const VectorXf& u) const;
 
-  // Discrete time approximation of the underlying linearized system.
+  // Exact discrete and continuous time underlying linearized systems.
   void LinearizedSystem(Time time_step, Eigen::Ref<MatrixXf> A,
                         Eigen::Ref<MatrixXf> B) const;
+  void ContinuousLinearizedSystem(Eigen::Ref<MatrixXf> A,
+                                  Eigen::Ref<MatrixXf> B) const;
 
   // Utilities for feedback linearization.
   MatrixXf InverseDecouplingMatrix(const VectorXf& x) const;
@@ -113,13 +116,27 @@ inline VectorXf SinglePlayerFlatUnicycle4D::Evaluate(const VectorXf& x,
 
 inline void SinglePlayerFlatUnicycle4D::LinearizedSystem(
     Time time_step, Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) const {
+  // Each axis is a double integrator, so zero-order hold discretization has a
+  // simple closed form.
+  const Time half_time_step_sq = 0.5 * time_step * time_step;
   A(kPxIdx, kVxIdx) += time_step;
   A(kPyIdx, kVyIdx) += time_step;
 
+  B(kPxIdx, 0) = half_time_step_sq;
+  B(kPyIdx, 1) = half_time_step_sq;
   B(kVxIdx, 0) = time_step;
   B(kVyIdx, 1) = time_step;
 }
 
+inline void SinglePlayerFlatUnicycle4D::ContinuousLinearizedSystem(
+    Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) const {
+  A(kPxIdx, kVxIdx) = 1.0;
+  A(kPyIdx, kVyIdx) = 1.0;
+
+  B(kVxIdx, 0) = 1.0;
+  B(kVyIdx, 1) = 1.0;
+}
+
 inline MatrixXf SinglePlayerFlatUnicycle4D::InverseDecouplingMatrix(
     const VectorXf& x) const {
   MatrixXf M_inv(kNumUDims, kNumUDims);
@@ -209,28 +226,7 @@ inline void SinglePlayerFlatUnicycle4D::Partial(
 
   CHECK_GT(std::hypot(xi(kVxIdx), xi(kVyIdx)), 1e-2);
 
-  const float norm_squared = xi(kVxIdx) * xi(kVxIdx) + xi(kVyIdx) * xi(kVyIdx);
-  const float norm = std::sqrt(norm_squared);
-  const float norm_ss = norm_squared * norm_squared;
-  const float sqrt_norm_sss = std::sqrt(norm_ss * norm_squared);
-
-  (*grads)[kPxIdx](kPxIdx) = 1.0;
-  (*grads)[kPyIdx](kPyIdx) = 1.0;
-  (*grads)[kThetaIdx](kVxIdx) = -xi(kVyIdx) / norm_squared;
-  (*grads)[kThetaIdx](kVyIdx) = xi(kVxIdx) / norm_squared;
-  (*grads)[kVIdx](kVxIdx) = xi(kVxIdx) / norm;
-  (*grads)[kVIdx](kVyIdx) = xi(kVyIdx) / norm;
-
-  (*hesses)[kThetaIdx](kVxIdx, kVxIdx) =
-      2.0 * xi(kVxIdx) * xi(kVyIdx) / norm_ss;
-  (*hesses)[kThetaIdx](kVxIdx, kVyIdx) =
-      (xi(kVyIdx) * xi(kVyIdx) - xi(kVxIdx) * xi(kVxIdx)) / norm_ss;
-  (*hesses)[kThetaIdx](kVyIdx, kVxIdx) = (*hesses)[kThetaIdx](kVxIdx, kVyIdx);
-  (*hesses)[kThetaIdx](kVyIdx, kVyIdx) = -(*hesses)[kThetaIdx](kVxIdx, kVxIdx);
-  (*hesses)[kVIdx](kVxIdx, kVxIdx) = (xi(kVyIdx) * xi(kVyIdx)) / sqrt_norm_sss;
-  (*hesses)[kVIdx](kVxIdx, kVyIdx) = (-xi(kVxIdx) * xi(kVyIdx)) / sqrt_norm_sss;
-  (*hesses)[kVIdx](kVyIdx, kVxIdx) = (*hesses)[kVIdx](kVxIdx, kVyIdx);
-  (*hesses)[kVIdx](kVyIdx, kVyIdx) = (xi(kVxIdx) * xi(kVxIdx)) / sqrt_norm_sss;
+  generated::PartialSinglePlayerFlatUnicycle4D(xi, grads, hesses);
 }
 
 inline float SinglePlayerFlatUnicycle4D::DistanceBetween(
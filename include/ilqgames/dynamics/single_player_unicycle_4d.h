@@ -48,9 +48,13 @@
 #ifndef ILQGAMES_DYNAMICS_SINGLE_PLAYER_UNICYCLE_4D_H
 #define ILQGAMES_DYNAMICS_SINGLE_PLAYER_UNICYCLE_4D_H
 
+#include <ilqgames/dynamics/generated/single_player_unicycle_4d_derivatives.h>
 #include <ilqgames/dynamics/single_player_dynamical_system.h>
+#include <ilqgames/utils/linear_dynamics_approximation.h>
 #include <ilqgames/utils/types.h>
 
+#include <vector>
+
 namespace ilqgames {
 
 class SinglePlayerUnicycle4D : public SinglePlayerDynamicalSystem {
@@ -66,6 +70,12 @@ class SinglePlayerUnicycle4D : public SinglePlayerDynamicalSystem {
   void Linearize(Time t, Time time_step, const VectorXf& x, const VectorXf& u,
                  Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) const;
 
+  // Compute discrete-time Jacobian linearizations at a batch of time steps.
+  void LinearizeBatch(
+      Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+      Dimension x_offset, PlayerIndex player_idx,
+      std::vector<LinearDynamicsApproximation>* linearizations) const;
+
   // Distance metric between two states.
   float DistanceBetween(const VectorXf& x0, const VectorXf& x1) const;
 
@@ -100,17 +110,15 @@ inline void SinglePlayerUnicycle4D::Linearize(Time t, Time time_step,
                                               const VectorXf& u,
                                               Eigen::Ref<MatrixXf> A,
                                               Eigen::Ref<MatrixXf> B) const {
-  const float ctheta = std::cos(x(kThetaIdx)) * time_step;
-  const float stheta = std::sin(x(kThetaIdx)) * time_step;
-
-  A(kPxIdx, kThetaIdx) += -x(kVIdx) * stheta;
-  A(kPxIdx, kVIdx) += ctheta;
-
-  A(kPyIdx, kThetaIdx) += x(kVIdx) * ctheta;
-  A(kPyIdx, kVIdx) += stheta;
+  generated::LinearizeSinglePlayerUnicycle4D(time_step, x, u, A, B);
+}
 
-  B(kThetaIdx, kOmegaIdx) = time_step;
-  B(kVIdx, kAIdx) = time_step;
+inline void SinglePlayerUnicycle4D::LinearizeBatch(
+    Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+    Dimension x_offset, PlayerIndex player_idx,
+    std::vector<LinearDynamicsApproximation>* linearizations) const {
+  generated::LinearizeBatchSinglePlayerUnicycle4D(time_step, xs, us, x_offset,
+                                                  player_idx, linearizations);
 }
 
 inline float SinglePlayerUnicycle4D::DistanceBetween(const VectorXf& x0,
@@ -49,9 +49,13 @@
 #ifndef ILQGAMES_DYNAMICS_SINGLE_PLAYER_UNICYCLE_5D_H
 #define ILQGAMES_DYNAMICS_SINGLE_PLAYER_UNICYCLE_5D_H
 
+#include <ilqgames/dynamics/generated/single_player_unicycle_5d_derivatives.h>
 #include <ilqgames/dynamics/single_player_dynamical_system.h>
+#include <ilqgames/utils/linear_dynamics_approximation.h>
 #include <ilqgames/utils/types.h>
 
+#include <vector>
+
 namespace ilqgames {
 
 class SinglePlayerUnicycle5D : public SinglePlayerDynamicalSystem {
@@ -67,6 +71,12 @@ class SinglePlayerUnicycle5D : public SinglePlayerDynamicalSystem {
   void Linearize(Time t, Time time_step, const VectorXf& x, const VectorXf& u,
                  Eigen::Ref<MatrixXf> A, Eigen::Ref<MatrixXf> B) const;
 
+  // Compute discrete-time Jacobian linearizations at a batch of time steps.
+  void LinearizeBatch(
+      Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+      Dimension x_offset, PlayerIndex player_idx,
+      std::vector<LinearDynamicsApproximation>* linearizations) const;
+
   // Distance metric between two states.
   float DistanceBetween(const VectorXf& x0, const VectorXf& x1) const;
 
@@ -103,19 +113,15 @@ inline void SinglePlayerUnicycle5D::Linearize(Time t, Time time_step,
                                               const VectorXf& u,
                                               Eigen::Ref<MatrixXf> A,
                                               Eigen::Ref<MatrixXf> B) const {
-  const float ctheta = std::cos(x(kThetaIdx)) * time_step;
-  const float stheta = std::sin(x(kThetaIdx)) * time_step;
-
-  A(kPxIdx, kThetaIdx) += -x(kVIdx) * stheta;
-  A(kPxIdx, kVIdx) += ctheta;
-
-  A(kPyIdx, kThetaIdx) += x(kVIdx) * ctheta;
-  A(kPyIdx, kVIdx) += stheta;
-
-  A(kSIdx, kVIdx) += time_step;
+  generated::LinearizeSinglePlayerUnicycle5D(time_step, x, u, A, B);
+}
 
-  B(kThetaIdx, kOmegaIdx) = time_step;
-  B(kVIdx, kAIdx) = time_step;
+inline void SinglePlayerUnicycle5D::LinearizeBatch(
+    Time t0, Time time_step, const MatrixXf& xs, const MatrixXf& us,
+    Dimension x_offset, PlayerIndex player_idx,
+    std::vector<LinearDynamicsApproximation>* linearizations) const {
+  generated::LinearizeBatchSinglePlayerUnicycle5D(time_step, xs, us, x_offset,
+                                                  player_idx, linearizations);
 }
 
 inline float SinglePlayerUnicycle5D::DistanceBetween(const VectorXf& x0,
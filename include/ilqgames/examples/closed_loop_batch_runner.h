@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Utility for running many closed-loop receding horizon simulations
+// concurrently on a pool of worker threads, and summarizing the results.
+//
+// Each scenario is simulated with its own problem instance, created by a
+// user-provided factory on the worker thread which runs it. Per-run statistics
+// (solve latencies, convergence rate, minimum distance between players, and
+// cost) are collected and may be written to a single summary file.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_EXAMPLES_CLOSED_LOOP_BATCH_RUNNER_H
+#define ILQGAMES_EXAMPLES_CLOSED_LOOP_BATCH_RUNNER_H
+
+#include <ilqgames/examples/receding_horizon_simulator.h>
+#include <ilqgames/solver/top_down_renderable_problem.h>
+#include <ilqgames/utils/solver_log.h>
+#include <ilqgames/utils/types.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ilqgames {
+
+// Factory for the problem to simulate in the scenario with the given index.
+using ScenarioFactory =
+    std::function<std::unique_ptr<TopDownRenderableProblem>(size_t scenario)>;
+
+struct ClosedLoopBatchParams {
+  // Simulation final time and planner runtime for each scenario.
+  Time final_time = 10.0;
+  Time planner_runtime = 0.25;
+
+  // Model of solve time (if any). See RecedingHorizonSimulator.
+  SolveTimeModel solve_time_model;
+
+  // Replanning triggers (if any), for event-triggered replanning. See
+  // RecedingHorizonSimulator.
+  std::shared_ptr<const ReplanningTriggers> replanning_triggers;
+
+  // Number of worker threads. If zero, uses the hardware concurrency.
+  size_t num_threads = 0;
+};  // struct ClosedLoopBatchParams
+
+struct ClosedLoopRunStatistics {
+  // Scenario index.
+  size_t scenario = 0;
+
+  // Measured runtime of each solve, and number of solves which converged.
+  std::vector<Time> solve_times;
+  size_t num_converged = 0;
+
+  // Minimum distance between any two players along the executed portion of
+  // each plan.
+  float min_distance = constants::kInfinity;
+
+  // Total cost (summed over players) of each plan, averaged over solves.
+  float mean_total_cost = 0.0;
+
+  // Fraction of solves which converged.
+  float ConvergenceRate() const {
+    return (solve_times.empty()) ? 0.0
+                                 : static_cast<float>(num_converged) /
+                                       static_cast<float>(solve_times.size());
+  }
+};  // struct ClosedLoopRunStatistics
+
+// Compute statistics for a single closed-loop run, given the problem that was
+// simulated and the logs from each solve.
+ClosedLoopRunStatistics ComputeClosedLoopRunStatistics(
+    size_t scenario, const TopDownRenderableProblem& problem,
+    const std::vector<std::shared_ptr<const SolverLog>>& logs);
+
+// Simulate the given number of scenarios concurrently, and return statistics
+// for each, in order of scenario index.
+std::vector<ClosedLoopRunStatistics> RunClosedLoopBatch(
+    size_t num_scenarios, const ScenarioFactory& factory,
+    const ClosedLoopBatchParams& params);
+
+// Compute the given percentile (in [0, 100]) of the given times, by the
+// nearest-rank method. Returns zero if there are no times.
+Time Percentile(std::vector<Time> times, float percentile);
+
+// Write a summary of the given runs to file, with one line per run and a final
+// line aggregating all runs. Returns whether the file could be written.
+bool WriteClosedLoopSummary(const std::vector<ClosedLoopRunStatistics>& runs,
+                            const std::string& filename);
+
+}  // namespace ilqgames
+
+#endif
@@ -43,23 +43,93 @@
 // problem in which short horizon problems are solved asynchronously throughout
 // operation.
 //
+// By default, time advances by the measured wall-clock time of each solve.
+// Alternatively, time may advance by the time a given model charges each solve
+// (e.g., a fixed budget, or a calibrated time per solver iteration), in which
+// case closed-loop runs are reproducible regardless of machine load.
+//
+// By default, the simulator replans on a fixed schedule. Alternatively, it may
+// replan only when triggered by the state deviating from the current plan or
+// the current plan running out, and otherwise keep executing the current plan.
+//
+// By default, every solve is given the same planner runtime. Alternatively,
+// each solve may be given time for a target number of solver iterations, as
+// predicted from the runtimes of recent iterations.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifndef ILQGAMES_EXAMPLE_RECEDING_HORIZON_SIMULATOR_H
 #define ILQGAMES_EXAMPLE_RECEDING_HORIZON_SIMULATOR_H
 
 #include <ilqgames/solver/problem.h>
+#include <ilqgames/utils/runtime_predictor.h>
 #include <ilqgames/utils/solver_log.h>
 
+#include <functional>
 #include <memory>
 #include <vector>
 
 namespace ilqgames {
 
+// Model of the time taken by a solve, given the log it produced.
+using SolveTimeModel = std::function<Time(const SolverLog& log)>;
+
+// Charge each solve a fixed amount of time.
+SolveTimeModel FixedSolveTimeModel(Time solve_time);
+
+// Charge each solve a fixed overhead plus a fixed time per solver iterate.
+SolveTimeModel PerIterationSolveTimeModel(Time time_per_iteration,
+                                          Time overhead = 0.0);
+
+// Events which trigger replanning, in event-triggered mode.
+struct ReplanningTriggers {
+  // Replan when any player's state deviates from the state predicted by the
+  // current plan by more than this distance. The dynamics' distance metric for
+  // each player is a *squared* distance (e.g., squared position distance), so
+  // it is compared against the squared threshold. Either one threshold for all
+  // players, or one per player. If empty, deviations never trigger replanning.
+  std::vector<float> player_distance_thresholds;
+
+  // Replan when less than this much time would remain in the current plan by
+  // the time a new solve finished. Must exceed the solver time step by enough
+  // to fire before the simulation runs out of plan.
+  Time min_remaining_horizon = 1.0;
+};  // struct ReplanningTriggers
+
+// Adaptive planner runtime budget, in measured-time mode.
+struct PlannerRuntimeBudget {
+  // Give each solve time for this many solver iterations, with iteration
+  // runtimes predicted at this quantile, plus a fixed overhead (e.g., for
+  // setting up the problem and splicing its solution).
+  size_t num_iterations = 10;
+  float latency_quantile = 0.9;
+  Time overhead = 0.01;
+
+  // Bounds on the planner runtime of any solve.
+  Time min_planner_runtime = 0.05;
+  Time max_planner_runtime = 0.5;
+};  // struct PlannerRuntimeBudget
+
+// Planner runtime for the next solve under the given budget, given the solver's
+// runtime predictor.
+Time BudgetPlannerRuntime(const PlannerRuntimeBudget& budget,
+                          const RuntimePredictor& predictor);
+
 // Solve this game following a receding horizon, accounting for the time used
-// to solve each subproblem and integrating dynamics forward accordingly.
+// to solve each subproblem and integrating dynamics forward accordingly. If a
+// solve time model is provided, time used is charged by that model rather than
+// measured, and solves are not cut short by wall-clock time; in that case, the
+// solver's iteration limit should be set so that solves fit within the planner
+// runtime, since any solve charged more is charged the planner runtime and
+// treated as unconverged, i.e., its solution is not spliced. If replanning
+// triggers are provided, only replans when triggered. If a planner runtime
+// budget is provided, it chooses the planner runtime of every solve after the
+// first; budgets may not be used with a solve time model.
 std::vector<std::shared_ptr<const SolverLog>> RecedingHorizonSimulator(
-    Time final_time, Time planner_runtime, Problem* problem);
+    Time final_time, Time planner_runtime, Problem* problem,
+    const SolveTimeModel& solve_time_model = nullptr,
+    const ReplanningTriggers* replanning_triggers = nullptr,
+    const PlannerRuntimeBudget* planner_runtime_budget = nullptr);
 
 }  // namespace ilqgames
 
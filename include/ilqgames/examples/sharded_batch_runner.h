@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Utility for running closed-loop receding horizon simulations in shards, each
+// in its own worker process, so that a crash (e.g., a failed CHECK) in one
+// simulation does not take down the rest of the batch.
+//
+// A coordinator keeps up to a given number of worker processes busy, each
+// simulating one shard of scenarios and writing its results to a file in the
+// work directory. Results of each completed shard are merged as they arrive,
+// and also appended to a results file in the work directory. Shards whose
+// worker crashes are split and retried, until a single scenario has crashed
+// the maximum number of times, at which point it is quarantined. Workers which
+// run past a timeout are killed and handled as if they had crashed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_EXAMPLES_SHARDED_BATCH_RUNNER_H
+#define ILQGAMES_EXAMPLES_SHARDED_BATCH_RUNNER_H
+
+#include <ilqgames/examples/closed_loop_batch_runner.h>
+#include <ilqgames/utils/types.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ilqgames {
+
+struct ShardedBatchParams {
+  // Parameters for the batch run within each worker process. Each worker runs
+  // its shard on a single thread, so the number of threads is ignored.
+  ClosedLoopBatchParams batch;
+
+  // Number of scenarios per shard.
+  size_t shard_size = 1;
+
+  // Number of worker processes. If zero, uses the hardware concurrency.
+  size_t num_workers = 0;
+
+  // Number of times a single scenario may crash before it is quarantined.
+  size_t max_attempts = 2;
+
+  // Maximum wall-clock time (s) a worker may spend on one shard. Workers which
+  // exceed it (e.g., because a solve stalls) are killed, and their shard is
+  // treated as having crashed. If infinite, workers are never killed.
+  Time shard_timeout = constants::kInfinity;
+
+  // Existing directory for shard results, the merged results file, and the
+  // list of quarantined scenarios.
+  std::string work_directory;
+};  // struct ShardedBatchParams
+
+struct ShardedBatchResults {
+  // Statistics for each scenario which completed, in order of scenario index.
+  std::vector<ClosedLoopRunStatistics> runs;
+
+  // Scenarios which were quarantined after repeatedly crashing.
+  std::vector<size_t> quarantined_scenarios;
+};  // struct ShardedBatchResults
+
+// Simulate the given number of scenarios in sharded worker processes.
+ShardedBatchResults RunShardedClosedLoopBatch(
+    size_t num_scenarios, const ScenarioFactory& factory,
+    const ShardedBatchParams& params);
+
+// Write statistics for a single run as one line of text, and read them back.
+// Reading returns whether a complete line was parsed.
+void WriteClosedLoopRun(const ClosedLoopRunStatistics& run,
+                        std::ostream* stream);
+bool ReadClosedLoopRun(std::istream* stream, ClosedLoopRunStatistics* run);
+
+}  // namespace ilqgames
+
+#endif
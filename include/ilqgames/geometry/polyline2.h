@@ -65,11 +65,27 @@ class Polyline2 {
 
   // Find closest point on this line segment to a given point, and optionally
   // the line segment that point belongs to (and flag for whether it is a
-  // vertex), and the signed squared distance, where right is positive.
+  // vertex), and the signed squared distance, where right is positive, and the
+  // index of that line segment.
+  // Searches a tree of bounding boxes, so takes time logarithmic in the number
+  // of segments for typical routes. Ties are broken in favor of the segment
+  // which comes first along the polyline.
   Point2 ClosestPoint(const Point2& query, bool* is_vertex = nullptr,
                       LineSegment2* segment = nullptr,
                       float* signed_squared_distance = nullptr,
-                      bool* is_endpoint = nullptr) const;
+                      bool* is_endpoint = nullptr,
+                      size_t* segment_idx = nullptr) const;
+
+  // Same as above, but warm-started from the index of a segment which is likely
+  // to be close to the query (e.g., the result of a previous query from a
+  // nearby point). Segments are searched outward from the hint until no
+  // remaining segment can be closer, so results are identical. Upon return,
+  // the hint is overwritten with the index of the closest segment.
+  Point2 ClosestPointWithHint(const Point2& query, size_t* segment_hint,
+                              bool* is_vertex = nullptr,
+                              LineSegment2* segment = nullptr,
+                              float* signed_squared_distance = nullptr,
+                              bool* is_endpoint = nullptr) const;
 
   // Find the point the given distance from the start of the polyline.
   // Optionally returns whether this is a vertex and the line segment which the
@@ -81,10 +97,48 @@ class Polyline2 {
   // Access line segments.
   const std::vector<LineSegment2>& Segments() const { return segments_; }
 
+  // Unique identifier for the geometry of this polyline. Copies share the same
+  // identifier, but adding a point generates a new one.
+  size_t Id() const { return id_; }
+
  private:
+  // Recompute bounding boxes for all ranges of segments.
+  void ComputeBoundingBoxes();
+
+  // Lower bound on the squared distance from the query to any segment with
+  // index in the range [first, last).
+  float SquaredDistanceLowerBound(const Point2& query, size_t first,
+                                  size_t last) const;
+
+  // Find the index of the closest segment to the query, either by searching
+  // the tree of bounding boxes from the root or by searching outward from the
+  // given hint.
+  size_t ClosestSegmentIndex(const Point2& query) const;
+  size_t ClosestSegmentIndex(const Point2& query, size_t segment_hint) const;
+
+  // Squared distance from the query to the segment with the given index.
+  float SquaredDistance(const Point2& query, size_t idx) const;
+
+  // Find the closest point on the segment with the given index and populate
+  // the optional outputs of `ClosestPoint`.
+  Point2 ClosestPointOnSegment(const Point2& query, size_t idx,
+                               bool* is_vertex, LineSegment2* segment,
+                               float* signed_squared_distance,
+                               bool* is_endpoint) const;
+
+  // Generate a new unique identifier.
+  static size_t NewId();
+
   std::vector<LineSegment2> segments_;
   std::vector<float> cumulative_lengths_;
   float length_;
+  size_t id_;
+
+  // Axis-aligned bounding boxes for ranges of consecutive segments, stored as
+  // an implicit binary tree rooted at index 1. Leaves (one per segment) are at
+  // indices [segments_.size(), 2 * segments_.size()), and node ii bounds both
+  // of its children at indices 2 * ii and 2 * ii + 1.
+  std::vector<Eigen::AlignedBox2f> bounding_boxes_;
 };  // struct Polyline2
 
 }  // namespace ilqgames
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Cache of closest point queries on Polyline2s, indexed by polyline, the input
+// dimensions corresponding to (x, y)-position, and time step. Several costs
+// and constraints often query the same polyline from the same position (e.g.,
+// a lane center cost and two lane boundary costs), so sharing a cache among
+// them avoids recomputing the same closest point. Cached queries also serve as
+// warm starts for queries from new positions at the same time step.
+//
+// Costs do not hold a cache themselves, since they may be shared by several
+// players and solvers. Instead, the owner of a cache (e.g., each PlayerCost)
+// puts it in scope on the calling thread while evaluating its costs, and costs
+// query through whichever cache is in scope, if any.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_GEOMETRY_POLYLINE2_QUERY_CACHE_H
+#define ILQGAMES_GEOMETRY_POLYLINE2_QUERY_CACHE_H
+
+#include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/utils/types.h>
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace ilqgames {
+
+class Polyline2QueryCache {
+ public:
+  // Result of a single closest point query. See Polyline2::ClosestPoint for
+  // details.
+  struct ClosestPointQuery {
+    Point2 query;
+    Point2 closest_point;
+    size_t segment_idx = 0;
+    bool is_vertex = false;
+    bool is_endpoint = false;
+    float signed_squared_distance = constants::kInfinity;
+    bool is_valid = false;
+  };  // struct ClosestPointQuery
+
+  ~Polyline2QueryCache() {}
+  Polyline2QueryCache() {}
+
+  // Find the closest point on the given polyline to the query, reusing the
+  // result of an identical query at the same time step if possible.
+  ClosestPointQuery ClosestPoint(const Polyline2& polyline, Dimension xidx,
+                                 Dimension yidx, size_t time_index,
+                                 const Point2& query);
+
+  // Find the closest point as above, through the cache in scope on the calling
+  // thread if there is one, and otherwise directly.
+  static ClosestPointQuery ClosestPointInScope(const Polyline2& polyline,
+                                               Dimension xidx, Dimension yidx,
+                                               size_t time_index,
+                                               const Point2& query);
+
+  // Forget all cached queries.
+  void Clear() { queries_.clear(); }
+
+  // Put the given cache in scope on the calling thread for the lifetime of
+  // this object, restoring the previous one (if any) afterward.
+  class Scope {
+   public:
+    ~Scope() { in_scope_ = previous_; }
+    explicit Scope(Polyline2QueryCache* cache) : previous_(in_scope_) {
+      in_scope_ = cache;
+    }
+
+   private:
+    Polyline2QueryCache* const previous_;
+  };  //\class Scope
+
+ private:
+  // Cache in scope on each thread, if any.
+  static thread_local Polyline2QueryCache* in_scope_;
+
+  // Time-indexed queries, keyed by polyline ID and position dimensions.
+  std::map<std::tuple<size_t, Dimension, Dimension>,
+           std::vector<ClosestPointQuery>>
+      queries_;
+};  // class Polyline2QueryCache
+
+}  // namespace ilqgames
+
+#endif
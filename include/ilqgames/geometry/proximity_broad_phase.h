@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Broad-phase for pairwise proximity terms. Positions are given by pairs of
+// input dimensions, and each registered pair of positions interacts only
+// within a given radius. Candidate pairs are found by sorting positions along
+// the x-axis and sweeping (i.e., sweep and prune), so that far-apart pairs are
+// never examined individually.
+//
+// A single broad-phase is meant to be shared by all players' costs, so that
+// active pairs are found once per state and pairs registered by several players
+// are only checked once. Sorting reuses preallocated buffers, so this class is
+// not thread-safe and each solver should own its own instance.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_GEOMETRY_PROXIMITY_BROAD_PHASE_H
+#define ILQGAMES_GEOMETRY_PROXIMITY_BROAD_PHASE_H
+
+#include <ilqgames/utils/types.h>
+
+#include <utility>
+#include <vector>
+
+namespace ilqgames {
+
+class ProximityBroadPhase {
+ public:
+  ~ProximityBroadPhase() {}
+  ProximityBroadPhase() : max_radius_(0.0) {}
+
+  // Register a pair of positions which interact only within the given radius.
+  // Returns the index of this pair, which is shared with any identical pair
+  // registered previously.
+  size_t AddPair(const std::pair<Dimension, Dimension>& position_idxs1,
+                 const std::pair<Dimension, Dimension>& position_idxs2,
+                 float radius);
+
+  // Flag each registered pair as active if its positions lie within its radius
+  // in the given input.
+  void FindActivePairs(const VectorXf& input, std::vector<bool>* active);
+
+  // Accessors.
+  size_t NumPairs() const { return pairs_.size(); }
+  size_t NumPositions() const { return positions_.size(); }
+
+ private:
+  // Find the index of the given position, adding it if necessary.
+  size_t PositionIndex(const std::pair<Dimension, Dimension>& position_idxs);
+
+  // Registered pair of positions, and its squared radius.
+  struct Pair {
+    size_t position1;
+    size_t position2;
+    float radius_sq;
+  };  // struct Pair
+
+  // Distinct positions and registered pairs.
+  std::vector<std::pair<Dimension, Dimension>> positions_;
+  std::vector<Pair> pairs_;
+
+  // Indices of pairs between each two positions (indexed by the lower
+  // position index times the number of positions plus the higher one).
+  std::vector<std::vector<size_t>> pairs_between_positions_;
+
+  // Largest radius of any pair.
+  float max_radius_;
+
+  // Preallocated buffers for unpacked positions and their order along x.
+  PointList2 points_;
+  std::vector<size_t> order_;
+};  // class ProximityBroadPhase
+
+}  // namespace ilqgames
+
+#endif
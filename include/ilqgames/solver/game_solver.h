@@ -46,21 +46,28 @@
 #define ILQGAMES_SOLVER_GAME_SOLVER_H
 
 #include <ilqgames/cost/player_cost.h>
+#include <ilqgames/cost/shared_proximity_terms.h>
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/dynamics/multi_player_integrable_system.h>
+#include <ilqgames/geometry/proximity_broad_phase.h>
 #include <ilqgames/solver/lq_feedback_solver.h>
 #include <ilqgames/solver/lq_open_loop_solver.h>
 #include <ilqgames/solver/lq_solver.h>
 #include <ilqgames/solver/solver_params.h>
+#include <ilqgames/solver/solver_statistics.h>
+#include <ilqgames/utils/cancellation_token.h>
 #include <ilqgames/utils/linear_dynamics_approximation.h>
-#include <ilqgames/utils/loop_timer.h>
 #include <ilqgames/utils/operating_point.h>
 #include <ilqgames/utils/quadratic_cost_approximation.h>
+#include <ilqgames/utils/runtime_predictor.h>
 #include <ilqgames/utils/solver_log.h>
 #include <ilqgames/utils/strategy.h>
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <chrono>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <utility>
@@ -73,8 +80,8 @@ namespace {
 // Rename the system clock for easier usage.
 using clock = std::chrono::system_clock;
 
-// Maximum number of loop times to store in loop timer.
-static constexpr size_t kMaxLoopTimesToRecord = 10;
+// Maximum number of runtimes per solver phase to store in runtime predictor.
+static constexpr size_t kMaxRuntimesToRecord = 50;
 
 }  // anonymous namespace
 
@@ -82,14 +89,26 @@ class GameSolver {
  public:
   virtual ~GameSolver() {}
 
-  // Solve this game. Returns true if converged.
+  // Callback invoked after each iteration with the number of iterations so
+  // far, and the current operating point and total costs for all players.
+  using ProgressCallback =
+      std::function<void(size_t num_iterations, const OperatingPoint& op,
+                         const std::vector<float>& total_costs)>;
+
+  // Solve this game. Returns true if converged. If the given cancellation
+  // token (if any) is raised, stops at the next phase of the current iteration
+  // and returns false without modifying the final operating point and
+  // strategies. The progress callback (if any) is invoked on the calling
+  // thread.
   virtual bool Solve(const VectorXf& x0,
                      const OperatingPoint& initial_operating_point,
                      const std::vector<Strategy>& initial_strategies,
                      OperatingPoint* final_operating_point,
                      std::vector<Strategy>* final_strategies,
                      SolverLog* log = nullptr,
-                     Time max_runtime = std::numeric_limits<Time>::infinity());
+                     Time max_runtime = std::numeric_limits<Time>::infinity(),
+                     const CancellationToken* cancellation_token = nullptr,
+                     const ProgressCallback& progress_callback = nullptr);
 
   // Accessors.
   Time TimeHorizon() const { return time_horizon_; }
@@ -97,6 +116,9 @@ class GameSolver {
   Time TimeStep() const { return time_step_; }
   const std::vector<PlayerCost>& PlayerCosts() const { return player_costs_; }
   const MultiPlayerIntegrableSystem& Dynamics() const { return *dynamics_; }
+  const SolverStatistics& Statistics() const { return statistics_; }
+  const SolverParams& Params() const { return params_; }
+  const RuntimePredictor& Runtimes() const { return runtime_predictor_; }
 
   // Compute time stamp from time index.
   Time ComputeTimeStamp(size_t time_index) const {
@@ -116,9 +138,30 @@ class GameSolver {
         linearization_(num_time_steps_),
         quadraticization_(num_time_steps_),
         params_(params),
-        timer_(kMaxLoopTimesToRecord) {
+        integrator_(params.integration_method,
+                    params.num_integration_substeps),
+        linearization_point_(num_time_steps_, dynamics->NumPlayers(), 0.0),
+        quadraticization_points_(player_costs.size(), linearization_point_),
+        is_approximation_cached_(false),
+        cost_control_players_(player_costs.size()),
+        all_players_(player_costs.size()),
+        activity_masks_(num_time_steps_,
+                        std::vector<std::vector<bool>>(player_costs.size())),
+        are_activity_masks_valid_(false),
+        runtime_predictor_(kMaxRuntimesToRecord) {
     CHECK_EQ(player_costs_.size(), dynamics_->NumPlayers());
 
+    // Flatten costs into type-grouped arrays for fast evaluation, sharing
+    // proximity terms and a single broad-phase over proximity pairs between
+    // players.
+    const auto shared_proximity_terms =
+        std::make_shared<SharedProximityTerms>();
+    for (PlayerCost& cost : player_costs_)
+      cost.Compile(shared_proximity_terms, &proximity_broad_phase_);
+
+    // Let costs know the time step so that they can index time.
+    Cost::ResetTimeStep(time_step_);
+
     if (params_.open_loop)
       lq_solver_.reset(new LQOpenLoopSolver(dynamics_, num_time_steps_));
     else
@@ -128,6 +171,22 @@ class GameSolver {
     for (auto& quads : quadraticization_)
       quads.resize(dynamics_->NumPlayers(),
                    QuadraticCostApproximation(dynamics_->XDim()));
+
+    // Record which players' controls enter each player's costs, so that
+    // cached quadraticizations are only invalidated by relevant changes.
+    for (PlayerIndex ii = 0; ii < player_costs_.size(); ii++) {
+      all_players_[ii] = ii;
+
+      auto& players = cost_control_players_[ii];
+      for (const auto& pair : player_costs_[ii].ControlCosts())
+        players.push_back(pair.first);
+      for (const auto& pair : player_costs_[ii].ControlConstraints())
+        players.push_back(pair.first);
+
+      std::sort(players.begin(), players.end());
+      players.erase(std::unique(players.begin(), players.end()),
+                    players.end());
+    }
   }
 
   // Populate the given vector with a linearization of the dynamics about
@@ -136,6 +195,20 @@ class GameSolver {
       const OperatingPoint& op,
       std::vector<LinearDynamicsApproximation>* linearization) = 0;
 
+  // Populate the given vector with a linearization of the dynamics about
+  // the given operating point, only at those time steps flagged as stale. By
+  // default, relinearizes all time steps.
+  virtual void RecomputeLinearization(
+      const OperatingPoint& op, const std::vector<bool>& stale_time_steps,
+      std::vector<LinearDynamicsApproximation>* linearization) {
+    ComputeLinearization(op, linearization);
+  }
+
+  // Linearize dynamics and quadraticize costs for all players about the given
+  // operating point. If incremental approximation is enabled, reuses cached
+  // approximations at time steps which have not changed appreciably.
+  void ComputeApproximation(const OperatingPoint& op);
+
   // Modify LQ strategies to improve convergence properties.
   // This function replaces an Armijo linesearch that would take place in ILQR.
   // Returns true if successful, and records if we have converged and the total
@@ -146,6 +219,11 @@ class GameSolver {
                                   bool* was_initial_point_feasible,
                                   std::vector<float>* total_costs) const;
 
+  // Find the proximity pairs (shared by all players' costs) which are active at
+  // the given state, or return null if there are no proximity pairs. The
+  // returned mask is only valid until the next call.
+  const std::vector<bool>* FindActiveProximityPairs(const VectorXf& x) const;
+
   // Compute distance (infinity norm) between states in the given dimensions.
   // If dimensions empty, checks all dimensions.
   virtual float StateDistance(const VectorXf& x1, const VectorXf& x2,
@@ -186,8 +264,43 @@ class GameSolver {
   // Solver parameters.
   const SolverParams params_;
 
-  // Timer to keep track of loop execution times.
-  LoopTimer timer_;
+  // Integrator for rollouts, as specified for this problem. It is owned by
+  // this solver (rather than by the dynamics, which may be shared) since it
+  // reuses its buffers across calls. Rollouts are otherwise const, hence it is
+  // mutable.
+  mutable Integrator integrator_;
+
+  // Points about which the dynamics were last linearized and each player's
+  // costs were last quadraticized at every time step, and whether or not these
+  // cached approximations may be reused.
+  OperatingPoint linearization_point_;
+  std::vector<OperatingPoint> quadraticization_points_;
+  bool is_approximation_cached_;
+
+  // Players whose controls enter each player's costs, and all players (whose
+  // controls enter the dynamics).
+  std::vector<std::vector<PlayerIndex>> cost_control_players_;
+  std::vector<PlayerIndex> all_players_;
+
+  // Activity masks for each player's state costs at every time step (indexed
+  // by time step, then player), and whether they were recorded during a
+  // complete rollout of the current operating point. Rollouts are otherwise
+  // const, hence these are mutable.
+  mutable std::vector<std::vector<std::vector<bool>>> activity_masks_;
+  mutable bool are_activity_masks_valid_;
+
+  // Broad-phase over all players' pairwise proximity costs, and the mask of
+  // active pairs at the state of the current time step. Both reuse their
+  // storage across calls, and are mutable for the same reason as above.
+  mutable ProximityBroadPhase proximity_broad_phase_;
+  mutable std::vector<bool> active_proximity_pairs_;
+
+  // Statistics from the most recent solve.
+  SolverStatistics statistics_;
+
+  // Predictor of iteration runtimes, from runtimes of each phase of recent
+  // iterations (across solves).
+  RuntimePredictor runtime_predictor_;
 };  // class GameSolver
 
 }  // namespace ilqgames
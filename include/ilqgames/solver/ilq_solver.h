@@ -77,6 +77,12 @@ class ILQSolver : public GameSolver {
   virtual void ComputeLinearization(
       const OperatingPoint& op,
       std::vector<LinearDynamicsApproximation>* linearization);
+
+  // Populate the given vector with a linearization of the dynamics about
+  // the given operating point, only at those time steps flagged as stale.
+  virtual void RecomputeLinearization(
+      const OperatingPoint& op, const std::vector<bool>& stale_time_steps,
+      std::vector<LinearDynamicsApproximation>* linearization);
 };  // class ILQSolver
 
 }  // namespace ilqgames
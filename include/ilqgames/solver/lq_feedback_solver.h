@@ -106,6 +106,10 @@ class LQFeedbackSolver : public LQSolver {
     // Preallocate memory for intermediate variables F, beta.
     F_.resize(dynamics_->XDim(), dynamics_->XDim());
     beta_.resize(dynamics_->XDim());
+
+    // Preallocate memory for products with Zs.
+    ZF_.resize(dynamics_->XDim(), dynamics_->XDim());
+    zeta_.resize(dynamics_->XDim());
   }
 
   // Solve underlying LQ game to a feedback Nash equilibrium.
@@ -132,13 +136,19 @@ class LQFeedbackSolver : public LQSolver {
   std::vector<Eigen::Ref<MatrixXf>> Ps_;
   std::vector<Eigen::Ref<VectorXf>> alphas_;
 
-  // Initialize Zs and zetas for each player.
+  // Initialize Zs and zetas for each player. Zs are symmetric, and only their
+  // lower triangles are stored.
   std::vector<MatrixXf> Zs_;
   std::vector<VectorXf> zetas_;
 
   // Preallocate memory for intermediate variables F, beta.
   MatrixXf F_;
   VectorXf beta_;
+
+  // Intermediate products Z * B, Z * F, Z * beta + zeta, and R * P. Those
+  // involving control dimensions are resized as needed for each player.
+  MatrixXf ZB_, ZF_, RP_;
+  VectorXf zeta_;
 };  // LQFeedbackSolver
 
 }  // namespace ilqgames
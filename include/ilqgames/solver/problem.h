@@ -44,11 +44,16 @@
 #ifndef ILQGAMES_SOLVER_PROBLEM_H
 #define ILQGAMES_SOLVER_PROBLEM_H
 
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/solver/game_solver.h>
+#include <ilqgames/solver/solution_splicer.h>
+#include <ilqgames/utils/cancellation_token.h>
 #include <ilqgames/utils/solver_log.h>
 #include <ilqgames/utils/strategy.h>
 #include <ilqgames/utils/types.h>
 
+#include <functional>
+#include <future>
 #include <limits>
 #include <memory>
 #include <vector>
@@ -59,9 +64,24 @@ class Problem {
  public:
   virtual ~Problem() {}
 
-  // Solve this game. Returns log populated by solver.
+  // Solve this game. Returns log populated by solver. If the given token (if
+  // any) is cancelled, the solver stops early and the current solution is left
+  // unchanged. Progress is reported after each iteration to the given callback
+  // (if any).
   std::shared_ptr<SolverLog> Solve(
-      Time max_runtime = std::numeric_limits<Time>::infinity());
+      Time max_runtime = std::numeric_limits<Time>::infinity(),
+      const CancellationToken* cancellation_token = nullptr,
+      const GameSolver::ProgressCallback& progress_callback = nullptr);
+
+  // Solve this game as above, but on a background thread, from which the
+  // progress callback will also be invoked. This problem must not be modified
+  // until the returned future is ready. Note that, as with std::async, the
+  // returned future blocks on destruction until the solve is done.
+  std::future<std::shared_ptr<SolverLog>> SolveAsync(
+      Time max_runtime = std::numeric_limits<Time>::infinity(),
+      const std::shared_ptr<const CancellationToken>& cancellation_token =
+          nullptr,
+      const GameSolver::ProgressCallback& progress_callback = nullptr);
 
   // Reset the initial time and change nothing else.
   void ResetInitialTime(Time t0) { operating_point_->t0 = t0; }
@@ -80,6 +100,15 @@ class Problem {
   virtual void SetUpNextRecedingHorizon(const VectorXf& x0, Time t0,
                                         Time planner_runtime = 0.1);
 
+  // As above, but read the existing plan directly from the given splicer
+  // rather than from this problem's own solution, which is overwritten. Only
+  // the time steps spanned by integration are copied out of the splicer. If
+  // this problem's solution is the one spliced in last, the new horizon reuses
+  // it in place, and otherwise the new horizon is copied out of the splicer.
+  void SetUpNextRecedingHorizon(const SolutionSplicer& splicer,
+                                const VectorXf& x0, Time t0,
+                                Time planner_runtime = 0.1);
+
   // Overwrite existing solution with the given operating point and strategies.
   // Truncates to fit in the same memory.
   void OverwriteSolution(const OperatingPoint& operating_point,
@@ -94,6 +123,7 @@ class Problem {
   const std::vector<Strategy>& CurrentStrategies() const {
     return *strategies_;
   }
+  size_t NumTimeStepsWritten() const { return num_time_steps_written_; }
 
  protected:
   Problem() {}
@@ -102,6 +132,16 @@ class Problem {
   // change the name of the log).
   virtual std::shared_ptr<SolverLog> CreateNewLog() const;
 
+  // Extend the solution beyond the given number of time steps from the
+  // existing plan to the solver's horizon, with zero controls and strategies,
+  // propagating states forward accordingly.
+  void ExtendSolution(size_t num_existing_timesteps, Integrator* integrator);
+
+  // Integrator configured as in the solver's params, for setting up receding
+  // horizon problems. It is created on first use, once derived classes have
+  // set up the solver, and then reused.
+  Integrator* SolverIntegrator();
+
   // Solver.
   std::unique_ptr<GameSolver> solver_;
 
@@ -111,6 +151,50 @@ class Problem {
   // Converged strategies and operating points for all players.
   std::unique_ptr<OperatingPoint> operating_point_;
   std::unique_ptr<std::vector<Strategy>> strategies_;
+
+ private:
+  // Copy the given number of time steps of a plan, starting at the given time
+  // step, into the front of the given operating point and strategies.
+  using CopyTimeStepsFunction =
+      std::function<void(size_t first_timestep, size_t num_time_steps,
+                         OperatingPoint* operating_point,
+                         std::vector<Strategy>* strategies)>;
+
+  // Integrate x0 forward from t0 by approximately planner_runtime, following
+  // the plan with the given initial time and number of time steps. Only the
+  // time steps spanned are copied into the integration window, by the given
+  // function. Returns the integrated state, and sets the time at which it is
+  // reached, which lies on the plan's time grid.
+  VectorXf IntegrateThroughPlannerRuntime(
+      const VectorXf& x0, Time t0, Time planner_runtime, Time plan_t0,
+      size_t plan_num_time_steps, const CopyTimeStepsFunction& copy_time_steps,
+      Time* new_t0);
+
+  // Truncate the solution to the solver's horizon, if it is longer.
+  void TruncateSolution();
+
+  // Shift the given number of time steps of the solution, starting at the
+  // given time step, to the front of the solution. Time steps are swapped into
+  // place rather than copied.
+  void ShiftSolution(size_t first_timestep, size_t num_time_steps);
+
+  // Log holding the current solution, if it was the last one solved for and
+  // has not since been modified.
+  std::shared_ptr<const SolverLog> solution_log_;
+
+  // Number of time steps of the solution written by the last receding horizon
+  // set up, i.e., copied out of a splicer or extended, rather than shifted
+  // into place.
+  size_t num_time_steps_written_ = 0;
+
+  // Contiguous copies of the time steps spanned by the last integration
+  // through the planner runtime, created on first use.
+  std::unique_ptr<OperatingPoint> window_operating_point_;
+  std::vector<Strategy> window_strategies_;
+
+  // Integrator for setting up receding horizon problems. Owned by this problem
+  // rather than shared with the solver, since each reuses its own buffers.
+  std::unique_ptr<Integrator> integrator_;
 };  // class Problem
 
 }  // namespace ilqgames
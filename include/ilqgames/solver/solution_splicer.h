@@ -38,15 +38,22 @@
 //
 // Splice together existing and new solutions to a receding horizon problem.
 //
+// Time steps are kept in a circular buffer, so that dropping time steps which
+// have elapsed only moves a head index, and splicing in a new solution only
+// writes its time steps. Consumers read the spliced solution through the
+// buffer, copying out only the time steps they need.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
 #ifndef ILQGAMES_SOLVER_SOLUTION_SPLICER_H
 #define ILQGAMES_SOLVER_SOLUTION_SPLICER_H
 
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/dynamics/multi_player_integrable_system.h>
 #include <ilqgames/utils/operating_point.h>
 #include <ilqgames/utils/solver_log.h>
 #include <ilqgames/utils/strategy.h>
+#include <ilqgames/utils/time_ring_buffer.h>
 #include <ilqgames/utils/types.h>
 
 #include <memory>
@@ -57,30 +64,73 @@ namespace ilqgames {
 class SolutionSplicer {
  public:
   ~SolutionSplicer() {}
-  explicit SolutionSplicer(const SolverLog& log);
+  explicit SolutionSplicer(const std::shared_ptr<const SolverLog>& log);
 
   // Splice in a new solution stored in a solver log.
-  void Splice(const SolverLog& log);
+  void Splice(const std::shared_ptr<const SolverLog>& log);
 
   // Check if a given time is contained within the current operating point.
   bool ContainsTime(Time t) const {
-    return (operating_point_.t0 <= t) &&
-           (operating_point_.t0 + operating_point_.xs.size() * time_step_ >= t);
+    return (t0_ <= t) && (t0_ + steps_.Size() * time_step_ >= t);
   }
 
+  // Integrate the given state forward from time t0 to time t, following the
+  // spliced solution. Only the time steps in between are copied out of the
+  // circular buffer. Integrates with the given integrator, which should be
+  // configured as in the solver's params, or else the dynamics' default.
+  VectorXf Integrate(const MultiPlayerIntegrableSystem& dynamics, Time t0,
+                     Time t, const VectorXf& x0,
+                     Integrator* integrator = nullptr);
+
+  // Copy the given number of time steps, starting at the given time step, into
+  // the front of the given operating point and strategies, which must already
+  // be large enough. Sets the operating point's initial time to that of the
+  // first time step copied.
+  void CopyTimeSteps(size_t first_timestep, size_t num_time_steps,
+                     OperatingPoint* operating_point,
+                     std::vector<Strategy>* strategies) const;
+
+  // Copy a single time step into the given time step of the given operating
+  // point and strategies, which must already be large enough.
+  void CopyTimeStep(size_t timestep, size_t kk, OperatingPoint* operating_point,
+                    std::vector<Strategy>* strategies) const;
+
   // Accessors.
-  const std::vector<Strategy>& CurrentStrategies() const { return strategies_; }
-  const OperatingPoint& CurrentOperatingPoint() const {
-    return operating_point_;
+  Time InitialTime() const { return t0_; }
+  size_t NumTimeSteps() const { return steps_.Size(); }
+  const VectorXf& State(size_t kk) const { return steps_[kk].x; }
+  const std::shared_ptr<const SolverLog>& LastSplicedLog() const {
+    return last_spliced_log_;
   }
 
  private:
-  // Converged strategies and operating points for all players.
-  std::vector<Strategy> strategies_;
-  OperatingPoint operating_point_;
+  // Everything stored at a single time step: state, controls, and each
+  // player's feedback gain and feedforward term.
+  struct TimeStep {
+    VectorXf x;
+    std::vector<VectorXf> us;
+    std::vector<MatrixXf> Ps;
+    std::vector<VectorXf> alphas;
+  };  //\struct TimeStep
+
+  // Copy the given time step of the given solver log into the next time step
+  // in the circular buffer.
+  void PushBack(const SolverLog& log, size_t kk);
+
+  // Time steps of the spliced solution, and initial time.
+  TimeRingBuffer<TimeStep> steps_;
+  Time t0_;
 
   // Time step.
-  Time time_step_;
+  const Time time_step_;
+
+  // Log whose solution was spliced in last, and which therefore makes up the
+  // time steps from its initial time onward.
+  std::shared_ptr<const SolverLog> last_spliced_log_;
+
+  // Contiguous copies of the time steps spanned by the last integration.
+  OperatingPoint window_operating_point_;
+  std::vector<Strategy> window_strategies_;
 };  // class SolutionSplicer
 
 }  // namespace ilqgames
@@ -43,6 +43,7 @@
 #ifndef ILQGAMES_SOLVER_SOLVER_PARAMS_H
 #define ILQGAMES_SOLVER_SOLVER_PARAMS_H
 
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/utils/types.h>
 
 namespace ilqgames {
@@ -74,6 +75,38 @@ struct SolverParams {
 
   // Whether solver should shoot for an open loop or feedback Nash.
   bool open_loop = false;
+
+  // Whether to reuse the linearization and each player's quadraticization at a
+  // time step from an earlier iteration, so long as the state and relevant
+  // controls at that time step have changed by no more than the given
+  // tolerance (elementwise) since that approximation was computed.
+  bool incremental_approximation = false;
+  float incremental_tolerance = 1e-3;
+
+  // Whether to record which piecewise cost terms are active at each time step
+  // during rollouts, so that inactive terms may be skipped when quadraticizing.
+  // Terms are considered active within the given margin of becoming nonzero.
+  bool skip_inactive_costs = true;
+  float activity_margin = 0.1;
+
+  // When setting up the next receding horizon problem, search for the state
+  // in the existing plan nearest to the new initial state only within the
+  // given number of time steps of where elapsed time says it should be. Fall
+  // back to searching the entire plan if the nearest state in that window is
+  // farther than the given threshold, as measured by the dynamics' distance
+  // metric.
+  size_t nearest_state_search_radius = 5;
+  float nearest_state_distance_threshold = 1.0;
+
+  // Stop iterating once the next iteration would probably overrun the maximum
+  // runtime, i.e., once its predicted runtime at this quantile (estimated from
+  // recent iterations) exceeds the time remaining.
+  float runtime_quantile = 0.99;
+
+  // Integration method for rollouts, and number of integration substeps per
+  // time step (for adaptive methods, the initial number of substeps).
+  IntegrationMethod integration_method = IntegrationMethod::RK4;
+  size_t num_integration_substeps = 2;
 };  // struct SolverParams
 
 }  // namespace ilqgames
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Statistics recorded by a solver over its most recent call to `Solve`.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_SOLVER_SOLVER_STATISTICS_H
+#define ILQGAMES_SOLVER_SOLVER_STATISTICS_H
+
+#include <ilqgames/utils/types.h>
+
+namespace ilqgames {
+
+struct SolverStatistics {
+  // Number of solver iterations, and whether the solve was cancelled.
+  size_t num_iterations = 0;
+  bool was_cancelled = false;
+
+  // Number of time steps at which dynamics were to be linearized, and the
+  // number of those at which a cached linearization was reused instead.
+  size_t num_linearizations = 0;
+  size_t num_linearization_hits = 0;
+
+  // Number of (time step, player) pairs at which costs were to be
+  // quadraticized, and the number of those at which a cached quadraticization
+  // was reused instead.
+  size_t num_quadraticizations = 0;
+  size_t num_quadraticization_hits = 0;
+
+  // Number of piecewise cost terms which were to be quadraticized according
+  // to activity masks, and the number of those which were skipped as inactive.
+  size_t num_activity_terms = 0;
+  size_t num_skipped_terms = 0;
+
+  // Fraction of linearizations and quadraticizations which were reused.
+  float LinearizationHitRate() const {
+    return (num_linearizations > 0)
+               ? static_cast<float>(num_linearization_hits) /
+                     static_cast<float>(num_linearizations)
+               : 0.0;
+  }
+  float QuadraticizationHitRate() const {
+    return (num_quadraticizations > 0)
+               ? static_cast<float>(num_quadraticization_hits) /
+                     static_cast<float>(num_quadraticizations)
+               : 0.0;
+  }
+
+  // Fraction of piecewise cost terms which were skipped as inactive.
+  float SkipRatio() const {
+    return (num_activity_terms > 0)
+               ? static_cast<float>(num_skipped_terms) /
+                     static_cast<float>(num_activity_terms)
+               : 0.0;
+  }
+};  // struct SolverStatistics
+
+}  // namespace ilqgames
+
+#endif
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Executes the most recently published strategies at arbitrary query times,
+// e.g. from a fast control loop, while a planner thread publishes new
+// solutions as they become available.
+//
+// Solutions are held in a double buffer in the manner of read-copy-update:
+// readers take a reference to whichever buffer is current without blocking,
+// and the (single) publisher fills the other buffer and then swaps them,
+// waiting only until readers of the retired buffer are done. Evaluating
+// controls does not allocate memory.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_SOLVER_STRATEGY_EXECUTOR_H
+#define ILQGAMES_SOLVER_STRATEGY_EXECUTOR_H
+
+#include <ilqgames/utils/operating_point.h>
+#include <ilqgames/utils/strategy.h>
+#include <ilqgames/utils/types.h>
+#include <ilqgames/utils/uncopyable.h>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace ilqgames {
+
+class StrategyExecutor : private Uncopyable {
+ public:
+  ~StrategyExecutor() {}
+  explicit StrategyExecutor(Time time_step);
+
+  // Publish a new solution, e.g. from a solution splicer. Only one thread may
+  // publish at a time. Only allocates memory if the solution is longer than
+  // the last one held in the same buffer.
+  void Publish(const OperatingPoint& operating_point,
+               const std::vector<Strategy>& strategies);
+
+  // Check whether the current solution contains the given time.
+  bool ContainsTime(Time t) const;
+
+  // Compute the given player's control at the given time and state, linearly
+  // interpolating the reference trajectory and feedforward terms between time
+  // steps and holding feedback gains. The output must already have the correct
+  // dimension. Returns false if the current solution does not contain the
+  // given time.
+  bool Control(Time t, const VectorXf& x, PlayerIndex player,
+               VectorXf* u) const;
+
+  // Compute controls for all players as above.
+  bool Controls(Time t, const VectorXf& x, std::vector<VectorXf>* us) const;
+
+  // Number of solutions published so far.
+  size_t NumPublished() const { return num_published_.load(); }
+
+ private:
+  // A single published solution.
+  struct Solution {
+    OperatingPoint operating_point;
+    std::vector<Strategy> strategies;
+
+    Solution() : operating_point(0, 0, 0.0) {}
+  };  //\struct Solution
+
+  // Find the time step at or before the given time in the given solution, and
+  // the fraction of the way to the next time step. Returns false if the
+  // solution does not contain the given time.
+  bool FindTimeStep(const Solution& solution, Time t, size_t* kk,
+                    float* frac) const;
+
+  // Compute the given player's control from the given solution.
+  bool Control(const Solution& solution, Time t, const VectorXf& x,
+               PlayerIndex player, VectorXf* u) const;
+
+  // Acquire a reference to the current buffer, and release it when done.
+  size_t Acquire() const;
+  void Release(size_t buffer) const { num_readers_[buffer]--; }
+
+  // Time step.
+  const Time time_step_;
+
+  // Double buffer of solutions, the index of the current buffer, and the
+  // number of readers holding each buffer.
+  std::array<Solution, 2> buffers_;
+  std::atomic<size_t> current_;
+  mutable std::array<std::atomic<size_t>, 2> num_readers_;
+
+  // Number of solutions published.
+  std::atomic<size_t> num_published_;
+};  //\class StrategyExecutor
+
+}  // namespace ilqgames
+
+#endif
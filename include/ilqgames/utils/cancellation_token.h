@@ -36,57 +36,37 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 //
-// Keeps track of elapsed time (e.g., during loops) and provides an upper bound
-// on the runtime of the next loop. To reduce memory consumption and adapt to
-// changing processor activity, computes statistics based on a moving window of
-// specified length.
+// Flag which may be raised from any thread to ask a running solver to stop.
+// Solvers check it cooperatively, between phases of each iteration.
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#ifndef ILQGAMES_UTILS_LOOP_TIMER_H
-#define ILQGAMES_UTILS_LOOP_TIMER_H
+#ifndef ILQGAMES_UTILS_CANCELLATION_TOKEN_H
+#define ILQGAMES_UTILS_CANCELLATION_TOKEN_H
 
-#include <ilqgames/utils/types.h>
+#include <ilqgames/utils/uncopyable.h>
 
-#include <glog/logging.h>
-#include <chrono>
-#include <list>
+#include <atomic>
 
 namespace ilqgames {
 
-class LoopTimer {
+class CancellationToken : private Uncopyable {
  public:
-  ~LoopTimer() {}
-  LoopTimer(size_t max_samples = 10)
-      : max_samples_(max_samples), total_time_(0.0) {
-    CHECK_GT(max_samples, 1);
+  ~CancellationToken() {}
+  CancellationToken() : is_cancelled_(false) {}
 
-    // For defined behavior, starting with a Tic().
-    Tic();
-  }
-
-  // Tic and toc. Start and stop loop timer.
-  void Tic();
-  void Toc();
+  // Ask the solver to stop, or reset so that the token may be reused.
+  void Cancel() { is_cancelled_.store(true, std::memory_order_release); }
+  void Reset() { is_cancelled_.store(false, std::memory_order_release); }
 
-  // High probability upper bound on next loop runtime, with initial guess to be
-  // returned if not enough data has been observed yet.
-  Time RuntimeUpperBound(float num_stddevs = 3.0,
-                         Time initial_guess = 0.02) const;
+  // Check whether cancellation has been requested.
+  bool IsCancelled() const {
+    return is_cancelled_.load(std::memory_order_acquire);
+  }
 
  private:
-  // Maximum number of samples used to compute mean and variance.
-  const size_t max_samples_;
-
-  // Most recent timer start time.
-  std::chrono::time_point<std::chrono::high_resolution_clock> start_;
-
-  // Queue of observed loop times.
-  std::list<Time> loop_times_;
-
-  // Running sum of times in the queue.
-  Time total_time_;
-};  // class LoopTimer
+  std::atomic<bool> is_cancelled_;
+};  //\class CancellationToken
 
 }  // namespace ilqgames
 
@@ -45,6 +45,7 @@
 #define ILQGAMES_UTILS_COMPUTE_STRATEGY_COSTS_H
 
 #include <ilqgames/cost/player_cost.h>
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/dynamics/multi_player_flat_system.h>
 #include <ilqgames/dynamics/multi_player_integrable_system.h>
 #include <ilqgames/utils/operating_point.h>
@@ -59,13 +60,14 @@
 
 namespace ilqgames {
 
-// Compute cost of a set of strategies for each player.
+// Compute cost of a set of strategies for each player, integrating dynamics
+// with the given integrator (if any).
 std::vector<float> ComputeStrategyCosts(
     const std::vector<PlayerCost>& player_costs,
     const std::vector<Strategy>& strategies,
     const OperatingPoint& operating_point,
     const MultiPlayerIntegrableSystem& dynamics, const VectorXf& x0,
-    float time_step, bool open_loop = false);
+    float time_step, bool open_loop = false, Integrator* integrator = nullptr);
 
 }  // namespace ilqgames
 
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Predicts the runtime of the next solver iteration from the observed runtimes
+// of each phase of recent iterations (linearization, quadraticization, LQ
+// solve, and linesearch). To adapt to changing processor activity, estimates
+// quantiles of each phase's runtime over a moving window of specified length.
+// The predicted iteration runtime at a given quantile is the sum of the phases'
+// runtimes at that quantile, which is conservative since phases seldom all run
+// slow at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_UTILS_RUNTIME_PREDICTOR_H
+#define ILQGAMES_UTILS_RUNTIME_PREDICTOR_H
+
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace ilqgames {
+
+enum class SolverPhase { LINEARIZE, QUADRATICIZE, LQ_SOLVE, LINESEARCH };
+static constexpr size_t kNumSolverPhases = 4;
+
+class RuntimePredictor {
+ public:
+  ~RuntimePredictor() {}
+  explicit RuntimePredictor(size_t max_samples = 50);
+
+  // Tic and toc. Start and stop timing the given phase of the current
+  // iteration.
+  void Tic(SolverPhase phase);
+  void Toc(SolverPhase phase);
+
+  // Record an observed runtime for the given phase.
+  void Record(SolverPhase phase, Time runtime);
+
+  // Time the given phase for the lifetime of this object, so that it is
+  // recorded however its scope is left (e.g., by an early return).
+  class ScopedPhase {
+   public:
+    ~ScopedPhase() { predictor_->Toc(phase_); }
+    ScopedPhase(RuntimePredictor* predictor, SolverPhase phase)
+        : predictor_(predictor), phase_(phase) {
+      predictor_->Tic(phase_);
+    }
+
+   private:
+    RuntimePredictor* const predictor_;
+    const SolverPhase phase_;
+  };  //\class ScopedPhase
+
+  // Forget all observed runtimes.
+  void Clear();
+
+  // Runtime of the given phase at the given quantile (in [0, 1]) over the
+  // moving window, or the initial guess if the phase has not been observed.
+  Time PhaseRuntime(SolverPhase phase, float quantile,
+                    Time initial_guess = 0.0) const;
+
+  // Predicted runtime of the next iteration at the given quantile, with
+  // initial guess to be returned until every phase has been observed.
+  Time IterationRuntime(float quantile, Time initial_guess = 0.02) const;
+
+  // Number of runtimes currently in the window for the given phase.
+  size_t NumSamples(SolverPhase phase) const {
+    return samples_[static_cast<size_t>(phase)].size();
+  }
+
+ private:
+  // Maximum number of samples per phase used to compute quantiles.
+  const size_t max_samples_;
+
+  // Most recent start time for each phase.
+  std::array<std::chrono::time_point<std::chrono::high_resolution_clock>,
+             kNumSolverPhases>
+      starts_;
+
+  // Circular buffers of observed runtimes for each phase, and the index of the
+  // oldest sample in each once full.
+  std::array<std::vector<Time>, kNumSolverPhases> samples_;
+  std::array<size_t, kNumSolverPhases> oldest_;
+
+  // Scratch space for selecting quantiles.
+  mutable std::vector<Time> scratch_;
+};  // class RuntimePredictor
+
+}  // namespace ilqgames
+
+#endif
@@ -0,0 +1,497 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// Second-order forward-mode dual numbers over a fixed number of variables.
+// Each number carries its value along with its gradient and Hessian with
+// respect to those variables, so that a single pass through a function
+// computes all three. Gradient and Hessian are fixed-size, so for small
+// numbers of variables all arithmetic happens on the stack.
+//
+// Since the Hessian is symmetric, only its lower triangle is stored, packed
+// row by row. Most intermediate quantities in a cost (differences of
+// coordinates, squared speeds, etc.) depend upon only a few of the variables,
+// and many are linear in them. So each number records which variables its
+// gradient and Hessian may depend upon, and outer products of gradients only
+// touch the corresponding block of the Hessian. Everywhere outside that block
+// the Hessian is kept zero, so sums and multiples of Hessians are vectorized
+// over the whole packed triangle. Numbers which are linear in the variables do
+// no Hessian arithmetic at all, and their Hessians are neither initialized nor
+// copied.
+//
+// Functions written as templates on the scalar type may be evaluated with
+// either float or SecondOrderDual. Such functions should bring the standard
+// math functions into scope (e.g. `using std::sqrt;`) and call them
+// unqualified, so that the overloads below are found for dual numbers.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_UTILS_SECOND_ORDER_DUAL_H
+#define ILQGAMES_UTILS_SECOND_ORDER_DUAL_H
+
+#include <ilqgames/utils/types.h>
+
+#include <cmath>
+#include <cstdint>
+
+namespace ilqgames {
+
+template <int N>
+struct SecondOrderDual {
+  static_assert(N > 0 && N <= 32, "Support is tracked in a 32-bit mask.");
+
+  // Number of entries in the lower triangle of the Hessian, padded to a
+  // multiple of four so that Eigen vectorizes arithmetic on all of them.
+  static constexpr int kNumHessianEntries = (N * (N + 1) / 2 + 3) / 4 * 4;
+
+  typedef Eigen::Matrix<float, N, 1> Gradient;
+  typedef Eigen::Matrix<float, kNumHessianEntries, 1> PackedHessian;
+  typedef Eigen::Matrix<float, N, N> Hessian;
+
+  // Bit mask of variables, with bit ii set for variable ii.
+  typedef uint32_t Support;
+
+  // Value and gradient. Gradient entries outside the support are zero.
+  float v;
+  Gradient g;
+  Support support;
+
+  // Lower triangle of the Hessian, packed row by row, and the variables upon
+  // which it may depend. It is only initialized if the Hessian support is
+  // nonempty, in which case all entries outside the supported block are zero.
+  PackedHessian h;
+  Support hessian_support;
+
+  // Constants have zero gradient and Hessian.
+  SecondOrderDual(float value = 0.0)
+      : v(value), g(Gradient::Zero()), support(0), hessian_support(0) {}
+
+  // Copies skip the Hessian if it is identically zero.
+  SecondOrderDual(const SecondOrderDual& b)
+      : v(b.v), g(b.g), support(b.support), hessian_support(b.hessian_support) {
+    if (hessian_support) h = b.h;
+  }
+  SecondOrderDual& operator=(const SecondOrderDual& b) {
+    v = b.v;
+    g = b.g;
+    support = b.support;
+    hessian_support = b.hessian_support;
+    if (hessian_support) h = b.h;
+    return *this;
+  }
+
+  // Construct the variable with the given index and value.
+  static SecondOrderDual Variable(float value, int idx) {
+    SecondOrderDual x(value);
+    x.g(idx) = 1.0;
+    x.support = Support(1) << idx;
+    return x;
+  }
+
+  // Is variable ii in the given support?
+  static bool Contains(Support mask, int ii) { return (mask >> ii) & 1; }
+
+  // Index of the (ii, jj) entry of the Hessian in the packed lower triangle,
+  // for jj <= ii.
+  static constexpr int PackedIndex(int ii, int jj) {
+    return ii * (ii + 1) / 2 + jj;
+  }
+
+  // Call f(ii, jj, kk) for each entry (ii, jj) of the lower triangle of the
+  // Hessian block whose rows and columns are in the given support, where kk is
+  // the packed index of that entry. Only visits set bits, so small blocks are
+  // cheap regardless of N.
+  template <typename F>
+  static void ForEachEntry(Support mask, F f) {
+    for (Support rows = mask; rows; rows &= rows - 1) {
+      const int ii = __builtin_ctz(rows);
+      const int row_start = PackedIndex(ii, 0);
+      for (Support cols = mask & ((Support(2) << ii) - 1); cols;
+           cols &= cols - 1) {
+        const int jj = __builtin_ctz(cols);
+        f(ii, jj, row_start + jj);
+      }
+    }
+  }
+
+  // Is the Hessian identically zero?
+  bool IsLinear() const { return hessian_support == 0; }
+
+  // Hessian, including when it is identically zero.
+  Hessian FullHessian() const {
+    Hessian full(Hessian::Zero());
+    for (int ii = 0; ii < N; ii++) {
+      if (!Contains(hessian_support, ii)) continue;
+
+      for (int jj = 0; jj <= ii; jj++) {
+        if (Contains(hessian_support, jj))
+          full(ii, jj) = full(jj, ii) = h(PackedIndex(ii, jj));
+      }
+    }
+    return full;
+  }
+
+  // Add the given multiple of another Hessian to this one.
+  void AddHessian(float scale, const SecondOrderDual& b) {
+    if (b.IsLinear()) return;
+
+    if (IsLinear())
+      h = scale * b.h;
+    else
+      h += scale * b.h;
+    hessian_support |= b.hessian_support;
+  }
+
+  // Add the given multiple of the outer product a a^T to the Hessian, where a
+  // is supported on the given variables.
+  void AddOuterProduct(float scale, const Gradient& a, Support a_support) {
+    AddOuterProduct(0.5 * scale, a, a_support, a, a_support);
+  }
+
+  // Add the given multiple of the symmetric outer product a b^T + b a^T to the
+  // Hessian, where a and b are supported on the given variables. If the
+  // Hessian is identically zero, the whole lower triangle is set, since that
+  // is as cheap as zeroing it; otherwise, only the supported block is updated.
+  void AddOuterProduct(float scale, const Gradient& a, Support a_support,
+                       const Gradient& b, Support b_support) {
+    const Support ab_support = a_support | b_support;
+    if (!ab_support) return;
+
+    if (IsLinear()) {
+      // Copy the gradients, which may belong to this number, so that the
+      // compiler knows that writing the Hessian does not change them.
+      const Gradient a_copy = a;
+      const Gradient b_copy = b;
+      for (int ii = 0; ii < N; ii++) {
+        const float scaled_a = scale * a_copy(ii);
+        const float scaled_b = scale * b_copy(ii);
+        for (int jj = 0; jj <= ii; jj++)
+          h(PackedIndex(ii, jj)) =
+              scaled_a * b_copy(jj) + scaled_b * a_copy(jj);
+      }
+      for (int kk = PackedIndex(N, 0); kk < kNumHessianEntries; kk++)
+        h(kk) = 0.0;
+    } else {
+      ForEachEntry(ab_support, [this, scale, &a, &b](int ii, int jj, int kk) {
+        h(kk) += scale * (a(ii) * b(jj) + b(ii) * a(jj));
+      });
+    }
+    hessian_support |= ab_support;
+  }
+
+  // Compound assignment.
+  SecondOrderDual& operator+=(const SecondOrderDual& b) {
+    v += b.v;
+    g += b.g;
+    support |= b.support;
+    AddHessian(1.0, b);
+    return *this;
+  }
+  SecondOrderDual& operator-=(const SecondOrderDual& b) {
+    v -= b.v;
+    g -= b.g;
+    support |= b.support;
+    AddHessian(-1.0, b);
+    return *this;
+  }
+  SecondOrderDual& operator*=(float b) {
+    v *= b;
+    g *= b;
+    if (!IsLinear()) h *= b;
+    return *this;
+  }
+  SecondOrderDual& operator*=(const SecondOrderDual& b);
+  SecondOrderDual& operator/=(const SecondOrderDual& b);
+
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};  //\struct SecondOrderDual
+
+// Apply a scalar function f with the given value, first, and second derivative
+// at x.v, via the chain rule.
+template <int N>
+inline SecondOrderDual<N> Chain(const SecondOrderDual<N>& x, float f,
+                                float df, float ddf) {
+  SecondOrderDual<N> y(f);
+  y.g = df * x.g;
+  y.support = x.support;
+  y.AddHessian(df, x);
+  y.AddOuterProduct(ddf, x.g, x.support);
+  return y;
+}
+
+// Apply a function f(a, b) with the given value and partial derivatives via
+// the chain rule.
+template <int N>
+inline SecondOrderDual<N> Chain(const SecondOrderDual<N>& a,
+                                const SecondOrderDual<N>& b, float f,
+                                float df_da, float df_db, float ddf_dada,
+                                float ddf_dadb, float ddf_dbdb) {
+  SecondOrderDual<N> y(f);
+  y.g = df_da * a.g + df_db * b.g;
+  y.support = a.support | b.support;
+  y.AddHessian(df_da, a);
+  y.AddHessian(df_db, b);
+  y.AddOuterProduct(ddf_dada, a.g, a.support);
+  y.AddOuterProduct(ddf_dbdb, b.g, b.support);
+  y.AddOuterProduct(ddf_dadb, a.g, a.support, b.g, b.support);
+  return y;
+}
+
+// Arithmetic.
+template <int N>
+inline SecondOrderDual<N> operator-(SecondOrderDual<N> a) {
+  return a *= -1.0;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator+(SecondOrderDual<N> a,
+                                    const SecondOrderDual<N>& b) {
+  return a += b;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator+(SecondOrderDual<N> a, float b) {
+  a.v += b;
+  return a;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator+(float a, SecondOrderDual<N> b) {
+  b.v += a;
+  return b;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator-(SecondOrderDual<N> a,
+                                    const SecondOrderDual<N>& b) {
+  return a -= b;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator-(SecondOrderDual<N> a, float b) {
+  a.v -= b;
+  return a;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator-(float a, SecondOrderDual<N> b) {
+  b *= -1.0;
+  b.v += a;
+  return b;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator*(const SecondOrderDual<N>& a,
+                                    const SecondOrderDual<N>& b) {
+  SecondOrderDual<N> y(a.v * b.v);
+  y.g = a.v * b.g + b.v * a.g;
+  y.support = a.support | b.support;
+  y.AddHessian(b.v, a);
+  y.AddHessian(a.v, b);
+  y.AddOuterProduct(1.0, a.g, a.support, b.g, b.support);
+  return y;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator*(SecondOrderDual<N> a, float b) {
+  return a *= b;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator*(float a, SecondOrderDual<N> b) {
+  return b *= a;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator/(const SecondOrderDual<N>& a,
+                                    const SecondOrderDual<N>& b) {
+  const float inv_b = 1.0 / b.v;
+  return a * Chain(b, inv_b, -inv_b * inv_b, 2.0 * inv_b * inv_b * inv_b);
+}
+
+template <int N>
+inline SecondOrderDual<N> operator/(SecondOrderDual<N> a, float b) {
+  return a *= 1.0 / b;
+}
+
+template <int N>
+inline SecondOrderDual<N> operator/(float a, const SecondOrderDual<N>& b) {
+  const float inv_b = 1.0 / b.v;
+  return Chain(b, a * inv_b, -a * inv_b * inv_b,
+               2.0 * a * inv_b * inv_b * inv_b);
+}
+
+template <int N>
+inline SecondOrderDual<N>& SecondOrderDual<N>::operator*=(
+    const SecondOrderDual<N>& b) {
+  return *this = *this * b;
+}
+
+template <int N>
+inline SecondOrderDual<N>& SecondOrderDual<N>::operator/=(
+    const SecondOrderDual<N>& b) {
+  return *this = *this / b;
+}
+
+// Comparisons are on values only.
+template <int N>
+inline bool operator<(const SecondOrderDual<N>& a,
+                      const SecondOrderDual<N>& b) {
+  return a.v < b.v;
+}
+
+template <int N>
+inline bool operator<(const SecondOrderDual<N>& a, float b) {
+  return a.v < b;
+}
+
+template <int N>
+inline bool operator<(float a, const SecondOrderDual<N>& b) {
+  return a < b.v;
+}
+
+template <int N>
+inline bool operator>(const SecondOrderDual<N>& a,
+                      const SecondOrderDual<N>& b) {
+  return a.v > b.v;
+}
+
+template <int N>
+inline bool operator>(const SecondOrderDual<N>& a, float b) {
+  return a.v > b;
+}
+
+template <int N>
+inline bool operator>(float a, const SecondOrderDual<N>& b) {
+  return a > b.v;
+}
+
+template <int N>
+inline bool operator<=(const SecondOrderDual<N>& a,
+                       const SecondOrderDual<N>& b) {
+  return a.v <= b.v;
+}
+
+template <int N>
+inline bool operator<=(const SecondOrderDual<N>& a, float b) {
+  return a.v <= b;
+}
+
+template <int N>
+inline bool operator>=(const SecondOrderDual<N>& a,
+                       const SecondOrderDual<N>& b) {
+  return a.v >= b.v;
+}
+
+template <int N>
+inline bool operator>=(const SecondOrderDual<N>& a, float b) {
+  return a.v >= b;
+}
+
+// Elementary functions. Nonsmooth functions take the derivative of whichever
+// branch is active.
+template <int N>
+inline SecondOrderDual<N> abs(const SecondOrderDual<N>& x) {
+  return (x.v < 0.0) ? -x : x;
+}
+
+template <int N>
+inline SecondOrderDual<N> min(const SecondOrderDual<N>& a,
+                              const SecondOrderDual<N>& b) {
+  return (b.v < a.v) ? b : a;
+}
+
+template <int N>
+inline SecondOrderDual<N> max(const SecondOrderDual<N>& a,
+                              const SecondOrderDual<N>& b) {
+  return (a.v < b.v) ? b : a;
+}
+
+template <int N>
+inline SecondOrderDual<N> sqrt(const SecondOrderDual<N>& x) {
+  const float s = std::sqrt(x.v);
+  return Chain(x, s, 0.5 / s, -0.25 / (s * x.v));
+}
+
+template <int N>
+inline SecondOrderDual<N> exp(const SecondOrderDual<N>& x) {
+  const float e = std::exp(x.v);
+  return Chain(x, e, e, e);
+}
+
+template <int N>
+inline SecondOrderDual<N> log(const SecondOrderDual<N>& x) {
+  const float inv_x = 1.0 / x.v;
+  return Chain(x, std::log(x.v), inv_x, -inv_x * inv_x);
+}
+
+template <int N>
+inline SecondOrderDual<N> pow(const SecondOrderDual<N>& x, float p) {
+  return Chain(x, std::pow(x.v, p), p * std::pow(x.v, p - 1.0f),
+               p * (p - 1.0f) * std::pow(x.v, p - 2.0f));
+}
+
+template <int N>
+inline SecondOrderDual<N> sin(const SecondOrderDual<N>& x) {
+  const float s = std::sin(x.v);
+  return Chain(x, s, std::cos(x.v), -s);
+}
+
+template <int N>
+inline SecondOrderDual<N> cos(const SecondOrderDual<N>& x) {
+  const float c = std::cos(x.v);
+  return Chain(x, c, -std::sin(x.v), -c);
+}
+
+template <int N>
+inline SecondOrderDual<N> atan(const SecondOrderDual<N>& x) {
+  const float inv = 1.0 / (1.0 + x.v * x.v);
+  return Chain(x, std::atan(x.v), inv, -2.0 * x.v * inv * inv);
+}
+
+template <int N>
+inline SecondOrderDual<N> atan2(const SecondOrderDual<N>& y,
+                                const SecondOrderDual<N>& x) {
+  const float inv_r2 = 1.0 / (x.v * x.v + y.v * y.v);
+  const float inv_r4 = inv_r2 * inv_r2;
+  return Chain(y, x, std::atan2(y.v, x.v), x.v * inv_r2, -y.v * inv_r2,
+               -2.0 * x.v * y.v * inv_r4, (y.v * y.v - x.v * x.v) * inv_r4,
+               2.0 * x.v * y.v * inv_r4);
+}
+
+}  // namespace ilqgames
+
+#endif
@@ -114,6 +114,10 @@ class SolverLog : private Uncopyable {
   const OperatingPoint& FinalOperatingPoint() const {
     return operating_points_.back();
   }
+  const std::vector<float>& FinalTotalCosts() const {
+    return total_player_costs_.back();
+  }
+  Time FinalRuntime() const { return cumulative_runtimes_.back(); }
 
   VectorXf InterpolateState(size_t iterate, Time t) const;
   float InterpolateState(size_t iterate, Time t, Dimension dim) const;
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Fixed-capacity circular buffer of time-indexed entries. Dropping entries
+// from the front only moves a head index, and entries appended at the back
+// reuse the storage of dropped ones, so that advancing a receding horizon
+// only costs work proportional to the number of new time steps.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef ILQGAMES_UTILS_TIME_RING_BUFFER_H
+#define ILQGAMES_UTILS_TIME_RING_BUFFER_H
+
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <vector>
+
+namespace ilqgames {
+
+template <typename T>
+class TimeRingBuffer {
+ public:
+  ~TimeRingBuffer() {}
+  explicit TimeRingBuffer(size_t capacity)
+      : entries_(capacity), head_(0), size_(0) {
+    CHECK_GT(capacity, 0);
+  }
+
+  // Access the entry at the given time index, relative to the front.
+  T& operator[](size_t kk) {
+    DCHECK_LT(kk, size_);
+    return entries_[(head_ + kk) % entries_.size()];
+  }
+  const T& operator[](size_t kk) const {
+    DCHECK_LT(kk, size_);
+    return entries_[(head_ + kk) % entries_.size()];
+  }
+
+  // Append an entry to the back, and return it so that it may be overwritten.
+  // The returned entry holds whatever was last stored in that slot.
+  T& PushBack() {
+    CHECK_LT(size_, entries_.size());
+    size_++;
+    return (*this)[size_ - 1];
+  }
+
+  // Drop the given number of entries from the front, or keep only the given
+  // number of entries at the front.
+  void PopFront(size_t num_entries) {
+    CHECK_LE(num_entries, size_);
+    head_ = (head_ + num_entries) % entries_.size();
+    size_ -= num_entries;
+  }
+  void Truncate(size_t size) {
+    CHECK_LE(size, size_);
+    size_ = size;
+  }
+
+  // Accessors.
+  size_t Size() const { return size_; }
+  size_t Capacity() const { return entries_.size(); }
+  bool IsEmpty() const { return size_ == 0; }
+
+ private:
+  // Storage for all entries, index of the front entry, and number of entries.
+  std::vector<T> entries_;
+  size_t head_;
+  size_t size_;
+};  //\class TimeRingBuffer
+
+}  // namespace ilqgames
+
+#endif
@@ -0,0 +1,607 @@
+"""
+BSD 3-Clause License
+
+Copyright (c) 2019, HJ Reachability Group
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+* Redistributions of source code must retain the above copyright notice, this
+  list of conditions and the following disclaimer.
+
+* Redistributions in binary form must reproduce the above copyright notice,
+  this list of conditions and the following disclaimer in the documentation
+  and/or other materials provided with the distribution.
+
+* Neither the name of the copyright holder nor the names of its
+  contributors may be used to endorse or promote products derived from
+  this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+Author(s): David Fridovich-Keil ( dfk@eecs.berkeley.edu )
+"""
+################################################################################
+#
+# Generates optimized C++ kernels for derivatives of single-player dynamics
+# from symbolic model definitions. For each dynamical system we emit the
+# discrete-time (Euler) Jacobian linearization used by `Linearize`, and for
+# each flat system we emit first and second partials of the map from linear
+# system state xi to nonlinear system state x used by `Partial`. Common
+# subexpressions are eliminated across all outputs of a kernel, and only
+# structurally nonzero entries are written.
+#
+# Usage:
+#   python3 generate_dynamics_derivatives.py <output_directory>
+#
+# By default, output goes to include/ilqgames/dynamics/generated.
+#
+################################################################################
+
+import os
+import re
+import sys
+import textwrap
+
+import sympy as sp
+from sympy.printing.cxx import CXX11CodePrinter
+from sympy.printing.precedence import precedence
+
+# License header shared with all C++ sources.
+LICENSE = """/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+"""
+
+BANNER = "/" * 79
+
+
+class FloatCodePrinter(CXX11CodePrinter):
+    """
+    C++ printer which emits single precision literals and expands small
+    integer and half-integer powers into multiplications and square roots.
+    """
+
+    def _print_Integer(self, expr):
+        return "%d.0f" % int(expr)
+
+    def _print_Rational(self, expr):
+        return "(%d.0f / %d.0f)" % (expr.p, expr.q)
+
+    def _print_Float(self, expr):
+        return "%sf" % repr(float(expr))
+
+    def _print_Pow(self, expr):
+        base, exp = expr.base, expr.exp
+        b = self.parenthesize(base, precedence(expr))
+
+        def positive_power(n):
+            product = " * ".join([b] * n)
+            return product if n == 1 else "(%s)" % product
+
+        if exp.is_Integer and 0 < exp <= 8:
+            return positive_power(int(exp))
+        if exp.is_Integer and -8 <= exp < 0:
+            return "1.0f / %s" % positive_power(int(-exp))
+        if exp.is_Rational and exp.q == 2 and abs(exp.p) <= 9:
+            n = abs(int(exp.p)) // 2
+            root = "%ssqrt(%s)" % (self._namespace(base), self._print(base))
+            magnitude = root if n == 0 else "%s * %s" % (positive_power(n),
+                                                         root)
+            if exp > 0:
+                return magnitude if n == 0 else "(%s)" % magnitude
+            return "1.0f / (%s)" % magnitude
+        return "%spow(%s, %s)" % (self._namespace(base), self._print(base),
+                                  self._print(exp))
+
+    def _namespace(self, expr):
+        """ Namespace of math functions applied to the given expression. """
+        return "std::"
+
+
+class ArrayCodePrinter(FloatCodePrinter):
+    """
+    Printer for batched kernels, in which some symbols are Eigen arrays. Math
+    functions of arrays are printed as coefficient-wise (and, where Eigen
+    supports it, vectorized) Eigen functions.
+    """
+
+    def __init__(self, array_symbols):
+        super(ArrayCodePrinter, self).__init__()
+        self.array_symbols = set(array_symbols)
+
+    def is_array(self, expr):
+        return bool(expr.free_symbols & self.array_symbols)
+
+    def _namespace(self, expr):
+        return "Eigen::" if self.is_array(expr) else "std::"
+
+    def _print_function(self, name, expr):
+        return "%s%s(%s)" % (self._namespace(expr), name,
+                             ", ".join(self._print(a) for a in expr.args))
+
+    def _print_sin(self, expr):
+        return self._print_function("sin", expr)
+
+    def _print_cos(self, expr):
+        return self._print_function("cos", expr)
+
+    def _print_tan(self, expr):
+        return self._print_function("tan", expr)
+
+
+PRINTER = FloatCodePrinter()
+
+# Maximum line length in generated code.
+MAX_LINE_LENGTH = 80
+
+
+def print_expr(expr, printer=PRINTER):
+    """ Print an expression with spaces around binary operators. """
+    out = re.sub(r"\s*([*/])\s*", r" \1 ", printer.doprint(expr))
+
+    # Strip redundant outer parentheses.
+    if out.startswith("(") and out.endswith(")"):
+        depth = 0
+        for ii, c in enumerate(out):
+            depth += {"(": 1, ")": -1}.get(c, 0)
+            if depth == 0 and ii < len(out) - 1:
+                return out
+        return out[1:-1]
+    return out
+
+
+def comment(*paragraphs):
+    """
+    Word-wrap a comment, starting each paragraph on a new line. Paragraphs
+    starting with spaces (e.g., formulas) keep their indentation.
+    """
+    lines = []
+    for text in paragraphs:
+        indent = "// " + " " * (len(text) - len(text.lstrip()))
+        lines += textwrap.wrap(text.lstrip(), MAX_LINE_LENGTH,
+                               initial_indent=indent, subsequent_indent=indent)
+    return lines
+
+
+def wrap(line, indent=4, after=None):
+    """
+    Break a statement longer than MAX_LINE_LENGTH at spaces, preferring spaces
+    just before an operator (or after the given separator), and indent
+    continuation lines.
+    """
+    leading = len(line) - len(line.lstrip())
+    lines = []
+    while len(line) > MAX_LINE_LENGTH:
+        if after is None:
+            breaks = [ii for ii in range(leading + indent, MAX_LINE_LENGTH)
+                      if line[ii] == " " and line[ii + 1] in "+-*/"]
+        else:
+            breaks = [ii for ii in range(leading + indent, MAX_LINE_LENGTH)
+                      if line[ii] == " " and line[ii - 1] == after]
+        if not breaks:
+            breaks = [ii for ii in range(leading + indent, MAX_LINE_LENGTH)
+                      if line[ii] == " "]
+        if not breaks:
+            break
+        lines.append(line[:breaks[-1]])
+        line = " " * (leading + indent) + line[breaks[-1] + 1:]
+    lines.append(line)
+    return lines
+
+
+class DynamicsModel(object):
+    """ Single-player dynamical system xdot = f(x, u; params). """
+
+    def __init__(self, name, params, states, controls, f):
+        self.name = name
+        self.params = params
+        self.states = states
+        self.controls = controls
+        self.f = sp.Matrix(f)
+
+
+class FlatModel(object):
+    """ Single-player flat system with state map x = g(xi; params). """
+
+    def __init__(self, name, params, linear_states, g):
+        self.name = name
+        self.params = params
+        self.linear_states = linear_states
+        self.g = sp.Matrix(g)
+
+
+def header_name(class_name):
+    """ Convert a class name like SinglePlayerCar6D to single_player_car_6d. """
+    out = ""
+    for ii, c in enumerate(class_name):
+        if c.isupper() and ii > 0 and not class_name[ii - 1].isdigit():
+            out += "_"
+        elif c.isdigit() and ii > 0 and not class_name[ii - 1].isdigit():
+            out += "_"
+        out += c.lower()
+    return out
+
+
+def emit_reads(symbols, container):
+    """ Read each used symbol from an Eigen vector into a local float. """
+    return ["  const float %s = %s(%d);" % (s.name, container, ii)
+            for ii, s in symbols]
+
+
+def emit_body(reads, entries):
+    """
+    Eliminate common subexpressions across all entries, which are tuples of
+    (format string, expression), and emit assignments.
+    """
+    exprs = [sp.simplify(expr) for _, expr in entries]
+    temporaries = sp.numbered_symbols("tmp")
+    replacements, reduced = sp.cse(exprs, symbols=temporaries)
+
+    lines = list(reads)
+    if lines:
+        lines.append("")
+    for symbol, expr in replacements:
+        lines += wrap("  const float %s = %s;" % (symbol, print_expr(expr)))
+    if replacements:
+        lines.append("")
+    for (fmt, _), expr in zip(entries, reduced):
+        lines += wrap(fmt % print_expr(expr))
+    return lines
+
+
+def used(symbols, exprs):
+    """ Indexed symbols which appear in any of the given expressions. """
+    free = set()
+    for expr in exprs:
+        free |= expr.free_symbols
+    return [(ii, s) for ii, s in enumerate(symbols) if s in free]
+
+
+def generate_linearize(model):
+    """ Kernel for A += dt * df/dx and B = dt * df/du. """
+    dt = sp.Symbol("dt")
+    Jx = model.f.jacobian(model.states)
+    Ju = model.f.jacobian(model.controls)
+
+    entries = []
+    for ii in range(Jx.rows):
+        for jj in range(Jx.cols):
+            if Jx[ii, jj] != 0:
+                entries.append(("  A(%d, %d) += %%s;" % (ii, jj),
+                                dt * Jx[ii, jj]))
+    for ii in range(Ju.rows):
+        for jj in range(Ju.cols):
+            if Ju[ii, jj] != 0:
+                entries.append(("  B(%d, %d) = %%s;" % (ii, jj),
+                                dt * Ju[ii, jj]))
+
+    exprs = [expr for _, expr in entries]
+    reads = ["  const float dt = static_cast<float>(time_step);"]
+    reads += emit_reads(used(model.states, exprs), "x")
+    reads += emit_reads(used(model.controls, exprs), "u")
+
+    params = "".join("float %s, " % p.name for p in model.params)
+    lines = comment("Discrete-time Jacobian linearization of %s dynamics:"
+                    % model.name,
+                    "  A += time_step * df/dx and B = time_step * df/du.")
+    lines += comment("NOTE: assumes A, B already initialized (to I, 0 "
+                     "respectively) and only writes structurally nonzero "
+                     "entries.")
+    lines += wrap("inline void Linearize%s(%sTime time_step, const VectorXf& x, "
+                  "const VectorXf& u, Eigen::Ref<MatrixXf> A, "
+                  "Eigen::Ref<MatrixXf> B) {" % (model.name, params),
+                  after=",")
+    lines += emit_body(reads, entries)
+    lines.append("}")
+    return lines
+
+
+def generate_linearize_batch(model):
+    """
+    Batched kernel for A += dt * df/dx and B = dt * df/du at many time steps.
+    States and controls are stored struct-of-arrays, so every Jacobian entry
+    is computed with coefficient-wise array math across all time steps before
+    being scattered into each time step's linearization.
+    """
+    dt = sp.Symbol("dt")
+    Jx = model.f.jacobian(model.states)
+    Ju = model.f.jacobian(model.controls)
+
+    targets = []
+    exprs = []
+    for ii in range(Jx.rows):
+        for jj in range(Jx.cols):
+            if Jx[ii, jj] != 0:
+                targets.append(("A", "x_offset + %d, x_offset + %d" % (ii, jj),
+                                "+="))
+                exprs.append(dt * Jx[ii, jj])
+    for ii in range(Ju.rows):
+        for jj in range(Ju.cols):
+            if Ju[ii, jj] != 0:
+                targets.append(("Bs[player_idx]", "x_offset + %d, %d" % (ii, jj),
+                                "="))
+                exprs.append(dt * Ju[ii, jj])
+
+    # Express tangents in terms of sines and cosines, which Eigen vectorizes
+    # and which share subexpressions with other entries.
+    exprs = [sp.simplify(expr).replace(sp.tan, lambda a: sp.sin(a) / sp.cos(a))
+             for expr in exprs]
+    temporaries = sp.numbered_symbols("tmp")
+    replacements, reduced = sp.cse(exprs, symbols=temporaries)
+
+    printer = ArrayCodePrinter(model.states + model.controls)
+    lines = comment("Batched discrete-time Jacobian linearization of %s "
+                    "dynamics at each time step:" % model.name,
+                    "  A += time_step * df/dx and B = time_step * df/du.",
+                    "Row kk of xs (us) holds the state "
+                    "(control) at time step kk, and results are written into "
+                    "the kk-th linearization at the given state offset and "
+                    "player's B.")
+    lines += comment("NOTE: assumes A, B already initialized (to I, 0 "
+                     "respectively) and only writes structurally nonzero "
+                     "entries.")
+    params = "".join("float %s, " % p.name for p in model.params)
+    lines += wrap("inline void LinearizeBatch%s(%sTime time_step, "
+                  "const MatrixXf& xs, const MatrixXf& us, Dimension x_offset, "
+                  "PlayerIndex player_idx, "
+                  "std::vector<LinearDynamicsApproximation>* linearizations) {"
+                  % (model.name, params), after=",")
+    lines += [
+        "  CHECK_NOTNULL(linearizations);",
+        "  CHECK_EQ(static_cast<size_t>(xs.rows()), linearizations->size());",
+        "  CHECK_EQ(static_cast<size_t>(us.rows()), linearizations->size());",
+        "",
+        "  const float dt = static_cast<float>(time_step);",
+    ]
+    all_exprs = list(reduced) + [expr for _, expr in replacements]
+    for ii, symbol in used(model.states, all_exprs):
+        lines.append("  const auto %s = xs.col(%d).array();" % (symbol, ii))
+    for ii, symbol in used(model.controls, all_exprs):
+        lines.append("  const auto %s = us.col(%d).array();" % (symbol, ii))
+    lines.append("")
+
+    # Temporaries are arrays if they depend on any state or control.
+    for symbol, expr in replacements:
+        if printer.is_array(expr):
+            printer.array_symbols.add(symbol)
+            decl = "const Eigen::ArrayXf"
+        else:
+            decl = "const float"
+        lines += wrap("  %s %s = %s;" % (decl, symbol,
+                                         print_expr(expr, printer)))
+    if replacements:
+        lines.append("")
+
+    # Evaluate each entry across all time steps, then scatter.
+    values = []
+    for ii, expr in enumerate(reduced):
+        if expr.is_Symbol or expr.is_Number:
+            values.append(print_expr(expr, printer))
+            continue
+        name = "entry%d" % ii
+        decl = "const Eigen::ArrayXf" if printer.is_array(expr) else "const float"
+        lines += wrap("  %s %s = %s;" % (decl, name, print_expr(expr, printer)))
+        if printer.is_array(expr):
+            printer.array_symbols.add(sp.Symbol(name))
+        values.append(name)
+    lines.append("")
+
+    lines += [
+        "  for (size_t kk = 0; kk < linearizations->size(); kk++) {",
+        "    LinearDynamicsApproximation& lin = (*linearizations)[kk];",
+    ]
+    for (matrix, index, op), value in zip(targets, values):
+        if printer.is_array(sp.Symbol(value)) or value in model_names(model):
+            value = "%s(kk)" % value
+        lines += wrap("    lin.%s(%s) %s %s;" % (matrix, index, op, value))
+    lines += ["  }", "}"]
+    return lines
+
+
+def model_names(model):
+    """ Names of all state and control symbols. """
+    return set(s.name for s in model.states + model.controls)
+
+
+def generate_partial(model):
+    """ Kernel for grads[k] = dx_k/dxi and hesses[k] = d2x_k/dxi2. """
+    entries = []
+    for kk in range(model.g.rows):
+        grad = [sp.diff(model.g[kk], s) for s in model.linear_states]
+        for ii, g in enumerate(grad):
+            if g != 0:
+                entries.append(("  (*grads)[%d](%d) = %%s;" % (kk, ii), g))
+        for ii in range(len(model.linear_states)):
+            for jj in range(ii, len(model.linear_states)):
+                h = sp.diff(grad[ii], model.linear_states[jj])
+                if h == 0:
+                    continue
+                if ii == jj:
+                    fmt = "  (*hesses)[%d](%d, %d) = %%s;" % (kk, ii, jj)
+                else:
+                    fmt = "  (*hesses)[%d](%d, %d) = (*hesses)[%d](%d, %d) = %%s;" % (
+                        kk, ii, jj, kk, jj, ii)
+                entries.append((fmt, h))
+
+    exprs = [expr for _, expr in entries]
+    reads = emit_reads(used(model.linear_states, exprs), "xi")
+
+    params = "".join("float %s, " % p.name for p in model.params)
+    lines = comment("First and second partials of the map from xi to x for "
+                    "%s:" % model.name,
+                    "  grads[k] = dx_k/dxi and hesses[k] = d2x_k/dxi2.")
+    lines += comment("NOTE: assumes grads, hesses already sized and zeroed "
+                     "and only writes structurally nonzero entries.")
+    lines += wrap("inline void Partial%s(%sconst VectorXf& xi, "
+                  "std::vector<VectorXf>* grads, "
+                  "std::vector<MatrixXf>* hesses) {" % (model.name, params),
+                  after=",")
+    lines += emit_body(reads, entries)
+    lines.append("}")
+    return lines
+
+
+def write_header(directory, model, kernel_lines, includes,
+                 ilqgames_includes=[]):
+    """ Wrap kernel in a header with license, banner, and include guard. """
+    name = header_name(model.name) + "_derivatives"
+    guard = "ILQGAMES_DYNAMICS_GENERATED_%s_H" % name.upper()
+    contents = [
+        LICENSE.rstrip("\n"),
+        "",
+        BANNER,
+        "//",
+        "// Derivatives of %s, generated from a symbolic model." % model.name,
+        "// NOTE: automatically generated by",
+        "// python/generate_dynamics_derivatives.py. Edit the model there and",
+        "// regenerate rather than editing this file.",
+        "//",
+        BANNER,
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+    ]
+    contents += ["#include <%s>" % inc for inc in ilqgames_includes]
+    contents += [
+        "#include <ilqgames/utils/types.h>",
+        "",
+    ]
+    if ilqgames_includes:
+        contents.append("#include <glog/logging.h>")
+    contents += ["#include <%s>" % inc for inc in includes]
+    contents += [
+        "",
+        "namespace ilqgames {",
+        "namespace generated {",
+        "",
+    ]
+    contents += kernel_lines
+    contents += [
+        "",
+        "}  // namespace generated",
+        "}  // namespace ilqgames",
+        "",
+        "#endif",
+    ]
+
+    path = os.path.join(directory, name + ".h")
+    with open(path, "w") as f:
+        f.write("\n".join(contents) + "\n")
+    print("Wrote %s." % path)
+
+
+def models():
+    """ Symbolic definitions of all single-player models. """
+    px, py, theta, phi, v, a, s, kappa = sp.symbols(
+        "px py theta phi v a s kappa", real=True)
+    omega, jerk = sp.symbols("omega jerk", real=True)
+    vx, vy, ax, ay = sp.symbols("vx vy ax ay", real=True)
+    L = sp.Symbol("inter_axle_distance", positive=True)
+    speed = sp.Symbol("speed", real=True)
+
+    dynamics = [
+        DynamicsModel("SinglePlayerUnicycle4D", [], [px, py, theta, v],
+                      [omega, a],
+                      [v * sp.cos(theta), v * sp.sin(theta), omega, a]),
+        DynamicsModel("SinglePlayerUnicycle5D", [], [px, py, theta, v, s],
+                      [omega, a],
+                      [v * sp.cos(theta), v * sp.sin(theta), omega, a, v]),
+        DynamicsModel("SinglePlayerCar5D", [L], [px, py, theta, phi, v],
+                      [omega, a],
+                      [v * sp.cos(theta), v * sp.sin(theta),
+                       v / L * sp.tan(phi), omega, a]),
+        DynamicsModel("SinglePlayerCar6D", [L], [px, py, theta, phi, v, a],
+                      [omega, jerk],
+                      [v * sp.cos(theta), v * sp.sin(theta),
+                       v / L * sp.tan(phi), omega, a, jerk]),
+        DynamicsModel("SinglePlayerCar7D", [L],
+                      [px, py, theta, phi, v, kappa, s], [omega, a],
+                      [v * sp.cos(theta), v * sp.sin(theta),
+                       v / L * sp.tan(phi), omega, a,
+                       omega / (L * sp.cos(phi)**2), v]),
+        DynamicsModel("SinglePlayerDubinsCar", [speed], [px, py, theta],
+                      [omega],
+                      [speed * sp.cos(theta), speed * sp.sin(theta), omega]),
+    ]
+
+    norm = sp.sqrt(vx**2 + vy**2)
+    flat = [
+        FlatModel("SinglePlayerFlatUnicycle4D", [], [px, py, vx, vy],
+                  [px, py, sp.atan2(vy, vx), norm]),
+        FlatModel("SinglePlayerFlatCar6D", [L], [px, py, vx, vy, ax, ay],
+                  [px, py, sp.atan2(vy, vx),
+                   sp.atan(L * (vx * ay - vy * ax) / norm**3), norm,
+                   (vx * ax + vy * ay) / norm]),
+    ]
+
+    return dynamics, flat
+
+
+def main():
+    if len(sys.argv) > 1:
+        directory = sys.argv[1]
+    else:
+        directory = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                 "..", "include", "ilqgames", "dynamics",
+                                 "generated")
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+
+    dynamics, flat = models()
+    for model in dynamics:
+        write_header(directory, model,
+                     generate_linearize(model) + [""] +
+                     generate_linearize_batch(model),
+                     ["cmath", "vector"],
+                     ["ilqgames/utils/linear_dynamics_approximation.h"])
+    for model in flat:
+        write_header(directory, model, generate_partial(model),
+                     ["cmath", "vector"])
+
+
+if __name__ == "__main__":
+    main()
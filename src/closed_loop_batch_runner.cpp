@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Utility for running many closed-loop receding horizon simulations
+// concurrently on a pool of worker threads, and summarizing the results.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/cost/cost.h>
+#include <ilqgames/examples/closed_loop_batch_runner.h>
+#include <ilqgames/examples/receding_horizon_simulator.h>
+#include <ilqgames/solver/top_down_renderable_problem.h>
+#include <ilqgames/utils/operating_point.h>
+#include <ilqgames/utils/solver_log.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ilqgames {
+
+namespace {
+
+// Minimum distance between any two players at the given state.
+float MinDistance(const TopDownRenderableProblem& problem, const VectorXf& x) {
+  const std::vector<float> pxs = problem.Xs(x);
+  const std::vector<float> pys = problem.Ys(x);
+  CHECK_EQ(pxs.size(), pys.size());
+
+  float min_distance = constants::kInfinity;
+  for (size_t ii = 0; ii < pxs.size(); ii++) {
+    for (size_t jj = ii + 1; jj < pxs.size(); jj++) {
+      min_distance = std::min(
+          min_distance, std::hypot(pxs[ii] - pxs[jj], pys[ii] - pys[jj]));
+    }
+  }
+
+  return min_distance;
+}
+
+// Write a line of the summary file.
+void WriteSummaryLine(const std::string& label,
+                      const std::vector<Time>& solve_times,
+                      float convergence_rate, float min_distance,
+                      float mean_total_cost, std::ofstream* file) {
+  *file << label << "," << solve_times.size() << "," << convergence_rate << ","
+        << Percentile(solve_times, 50.0) << ","
+        << Percentile(solve_times, 90.0) << ","
+        << Percentile(solve_times, 99.0) << ","
+        << Percentile(solve_times, 100.0) << "," << min_distance << ","
+        << mean_total_cost << std::endl;
+}
+
+}  // anonymous namespace
+
+ClosedLoopRunStatistics ComputeClosedLoopRunStatistics(
+    size_t scenario, const TopDownRenderableProblem& problem,
+    const std::vector<std::shared_ptr<const SolverLog>>& logs) {
+  ClosedLoopRunStatistics run;
+  run.scenario = scenario;
+  if (logs.empty()) return run;
+
+  // Solve times, convergence, and costs.
+  float total_cost = 0.0;
+  for (const auto& log : logs) {
+    run.solve_times.push_back(log->FinalRuntime());
+    if (log->WasConverged()) run.num_converged++;
+
+    const std::vector<float>& costs = log->FinalTotalCosts();
+    total_cost += std::accumulate(costs.begin(), costs.end(), 0.0f);
+  }
+  run.mean_total_cost = total_cost / static_cast<float>(logs.size());
+
+  // Only the initial plan and later plans which converged are executed (see
+  // RecedingHorizonSimulator), each until the next such plan begins.
+  std::vector<size_t> executed;
+  for (size_t ii = 0; ii < logs.size(); ii++) {
+    if (ii == 0 || logs[ii]->WasConverged()) executed.push_back(ii);
+  }
+
+  for (size_t jj = 0; jj < executed.size(); jj++) {
+    const OperatingPoint& op = logs[executed[jj]]->FinalOperatingPoint();
+    const Time end_time =
+        (jj + 1 < executed.size())
+            ? logs[executed[jj + 1]]->FinalOperatingPoint().t0
+            : constants::kInfinity;
+
+    const Time time_step = logs[executed[jj]]->TimeStep();
+    for (size_t kk = 0; kk < op.xs.size(); kk++) {
+      if (op.t0 + time_step * static_cast<Time>(kk) >= end_time) break;
+      run.min_distance =
+          std::min(run.min_distance, MinDistance(problem, op.xs[kk]));
+    }
+  }
+
+  return run;
+}
+
+std::vector<ClosedLoopRunStatistics> RunClosedLoopBatch(
+    size_t num_scenarios, const ScenarioFactory& factory,
+    const ClosedLoopBatchParams& params) {
+  CHECK(factory);
+
+  std::vector<ClosedLoopRunStatistics> runs(num_scenarios);
+  if (num_scenarios == 0) return runs;
+
+  // Each worker repeatedly claims the next scenario to simulate, and writes
+  // only to that scenario's statistics.
+  std::atomic<size_t> next_scenario(0);
+  auto work = [&runs, &next_scenario, num_scenarios, &factory, &params]() {
+    for (size_t scenario = next_scenario++; scenario < num_scenarios;
+         scenario = next_scenario++) {
+      std::unique_ptr<TopDownRenderableProblem> problem = factory(scenario);
+      CHECK_NOTNULL(problem.get());
+
+      // Costs' initial time is kept per thread and left over from the last
+      // scenario run on this thread, so reset it to this problem's.
+      Cost::ResetInitialTime(problem->CurrentOperatingPoint().t0);
+
+      const std::vector<std::shared_ptr<const SolverLog>> logs =
+          RecedingHorizonSimulator(params.final_time, params.planner_runtime,
+                                   problem.get(), params.solve_time_model,
+                                   params.replanning_triggers.get());
+      runs[scenario] = ComputeClosedLoopRunStatistics(scenario, *problem, logs);
+    }
+  };  // work
+
+  size_t num_threads = params.num_threads;
+  if (num_threads == 0)
+    num_threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+  num_threads = std::min(num_threads, num_scenarios);
+
+  std::vector<std::thread> workers;
+  for (size_t ii = 0; ii < num_threads; ii++) workers.emplace_back(work);
+  for (auto& worker : workers) worker.join();
+
+  return runs;
+}
+
+Time Percentile(std::vector<Time> times, float percentile) {
+  CHECK_GE(percentile, 0.0);
+  CHECK_LE(percentile, 100.0);
+  if (times.empty()) return 0.0;
+
+  const size_t rank = static_cast<size_t>(
+      std::ceil(0.01 * percentile * static_cast<Time>(times.size())));
+  const size_t idx = std::max<size_t>(rank, 1) - 1;
+  std::nth_element(times.begin(), times.begin() + idx, times.end());
+  return times[idx];
+}
+
+bool WriteClosedLoopSummary(const std::vector<ClosedLoopRunStatistics>& runs,
+                            const std::string& filename) {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    LOG(ERROR) << "Could not open summary file " << filename << ".";
+    return false;
+  }
+
+  file << "scenario,num_solves,convergence_rate,solve_time_p50,"
+          "solve_time_p90,solve_time_p99,solve_time_max,min_distance,"
+          "mean_total_cost"
+       << std::endl;
+
+  // One line per run, while aggregating over all runs.
+  std::vector<Time> all_solve_times;
+  size_t num_converged = 0;
+  float min_distance = constants::kInfinity;
+  float total_cost = 0.0;
+  for (const auto& run : runs) {
+    WriteSummaryLine(std::to_string(run.scenario), run.solve_times,
+                     run.ConvergenceRate(), run.min_distance,
+                     run.mean_total_cost, &file);
+
+    all_solve_times.insert(all_solve_times.end(), run.solve_times.begin(),
+                           run.solve_times.end());
+    num_converged += run.num_converged;
+    min_distance = std::min(min_distance, run.min_distance);
+    total_cost += run.mean_total_cost;
+  }
+
+  const float convergence_rate =
+      (all_solve_times.empty())
+          ? 0.0
+          : static_cast<float>(num_converged) /
+                static_cast<float>(all_solve_times.size());
+  const float mean_total_cost =
+      (runs.empty()) ? 0.0 : total_cost / static_cast<float>(runs.size());
+  WriteSummaryLine("all", all_solve_times, convergence_rate, min_distance,
+                   mean_total_cost, &file);
+
+  return file.good();
+}
+
+}  // namespace ilqgames
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// Costs flattened into contiguous arrays of parameters, grouped by type, so
+// that evaluation and quadraticization of the most common cost types run in
+// tight, non-virtual loops.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/cost/compiled_costs.h>
+#include <ilqgames/cost/cost.h>
+#include <ilqgames/cost/shared_proximity_terms.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ilqgames {
+
+constexpr size_t CompiledCosts::kNoProximityPair;
+constexpr size_t CompiledCosts::kNoSharedTerm;
+
+namespace {
+
+// Find the core of the given proximity term at the given input, either from
+// the shared terms or computing it directly.
+SharedProximityTerms::Core ProximityCore(
+    const CompiledCosts::ProximityTerm& term, const VectorXf& input,
+    SharedProximityTerms* shared_proximity_terms) {
+  if (term.shared_term != CompiledCosts::kNoSharedTerm)
+    return shared_proximity_terms->Evaluate(term.shared_term, input);
+
+  return SharedProximityTerms::ComputeCore(
+      input(term.xidx1) - input(term.xidx2),
+      input(term.yidx1) - input(term.yidx2), term.threshold,
+      term.threshold_sq);
+}
+
+// Check whether the given semiquadratic term may be active at the given input,
+// within the given margin.
+bool IsSemiquadraticTermActive(const CompiledCosts::SemiquadraticTerm& term,
+                               const VectorXf& input, float margin) {
+  const float diff = input(term.dim) - term.threshold;
+  return (term.oriented_right) ? diff > -margin : diff < margin;
+}
+
+// Check whether the given proximity term may be active at the given input,
+// within the given margin.
+bool IsProximityTermActive(const CompiledCosts::ProximityTerm& term,
+                           const VectorXf& input, float margin) {
+  const float dx = input(term.xidx1) - input(term.xidx2);
+  const float dy = input(term.yidx1) - input(term.yidx2);
+  const float radius = term.threshold + margin;
+  return dx * dx + dy * dy < radius * radius;
+}
+
+}  // anonymous namespace
+
+void CompiledCosts::Add(const std::shared_ptr<Cost>& cost,
+                        size_t proximity_pair) {
+  CHECK_NOTNULL(cost.get());
+  if (!cost->Compile(proximity_pair, this))
+    virtual_costs_.emplace_back(cost, proximity_pair);
+}
+
+void CompiledCosts::AddProximityTerm(const ProximityTerm& term) {
+  proximity_terms_.push_back(term);
+  if (!shared_proximity_terms_) return;
+
+  // Share this term, with its positions in canonical order.
+  ProximityTerm& shared = proximity_terms_.back();
+  std::pair<Dimension, Dimension> position_idxs1(shared.xidx1, shared.yidx1);
+  std::pair<Dimension, Dimension> position_idxs2(shared.xidx2, shared.yidx2);
+  shared.shared_term = shared_proximity_terms_->Add(
+      &position_idxs1, &position_idxs2, shared.threshold);
+  std::tie(shared.xidx1, shared.yidx1) = position_idxs1;
+  std::tie(shared.xidx2, shared.yidx2) = position_idxs2;
+}
+
+float CompiledCosts::Evaluate(Time t, const VectorXf& input,
+                              const std::vector<bool>* active_proximity_pairs,
+                              float activity_margin,
+                              std::vector<bool>* activity) const {
+  CHECK_GE(activity_margin, 0.0);
+  if (activity) activity->resize(NumActivityTerms());
+  size_t activity_idx = 0;
+
+  float total_cost = 0.0;
+  for (const auto& term : quadratic_terms_) {
+    const float delta = input(term.dim) - term.nominal;
+    total_cost += 0.5 * term.weight * delta * delta;
+  }
+
+  for (const auto& term : semiquadratic_terms_) {
+    if (activity) {
+      (*activity)[activity_idx++] =
+          IsSemiquadraticTermActive(term, input, activity_margin);
+    }
+
+    const float diff = input(term.dim) - term.threshold;
+    if ((diff > 0.0 && term.oriented_right) ||
+        (diff < 0.0 && !term.oriented_right))
+      total_cost += 0.5 * term.weight * diff * diff;
+  }
+
+  for (const auto& term : proximity_terms_) {
+    if (!IsActive(term.proximity_pair, active_proximity_pairs)) {
+      if (activity) (*activity)[activity_idx++] = false;
+      continue;
+    }
+
+    const SharedProximityTerms::Core core =
+        ProximityCore(term, input, shared_proximity_terms_.get());
+    total_cost += term.weight * core.value;
+
+    if (activity) {
+      (*activity)[activity_idx++] =
+          core.is_active ||
+          IsProximityTermActive(term, input, activity_margin);
+    }
+  }
+
+  for (const auto& pair : virtual_costs_) {
+    // Inactive costs vanish, so they need not be evaluated.
+    const bool is_active =
+        IsActive(pair.second, active_proximity_pairs) &&
+        (!activity || pair.first->IsActive(t, input, activity_margin));
+    if (activity) (*activity)[activity_idx++] = is_active;
+
+    if (is_active) total_cost += pair.first->Evaluate(t, input);
+  }
+
+  return total_cost;
+}
+
+void CompiledCosts::Quadraticize(
+    Time t, const VectorXf& input,
+    const std::vector<bool>* active_proximity_pairs, MatrixXf* hess,
+    VectorXf* grad, const std::vector<bool>* activity) const {
+  CHECK_NOTNULL(hess);
+  CHECK_NOTNULL(grad);
+  if (activity) CHECK_EQ(activity->size(), NumActivityTerms());
+
+  // Check whether the term at the given index in the activity mask (if any)
+  // is active.
+  size_t activity_idx = 0;
+  auto is_masked_active = [activity, &activity_idx]() {
+    const bool is_active = !activity || (*activity)[activity_idx];
+    activity_idx++;
+    return is_active;
+  };  // is_masked_active
+
+  // Check dimensions once for all compiled terms.
+  CHECK_EQ(input.size(), hess->rows());
+  CHECK_EQ(input.size(), hess->cols());
+  CHECK_EQ(input.size(), grad->size());
+
+  for (const auto& term : quadratic_terms_) {
+    (*hess)(term.dim, term.dim) += term.weight;
+    (*grad)(term.dim) += term.weight * (input(term.dim) - term.nominal);
+  }
+
+  for (const auto& term : semiquadratic_terms_) {
+    if (!is_masked_active()) continue;
+
+    const float diff = input(term.dim) - term.threshold;
+    if ((diff < 0.0 && term.oriented_right) ||
+        (diff > 0.0 && !term.oriented_right))
+      continue;
+
+    (*hess)(term.dim, term.dim) += term.weight;
+    (*grad)(term.dim) += term.weight * diff;
+  }
+
+  for (const auto& term : proximity_terms_) {
+    if (!is_masked_active() ||
+        (!activity && !IsActive(term.proximity_pair, active_proximity_pairs)))
+      continue;
+
+    const SharedProximityTerms::Core core =
+        ProximityCore(term, input, shared_proximity_terms_.get());
+    if (!core.is_active) continue;
+
+    const float hess_x1x1 = term.weight * core.hess_xx;
+    (*hess)(term.xidx1, term.xidx1) += hess_x1x1;
+    (*hess)(term.xidx1, term.xidx2) -= hess_x1x1;
+    (*hess)(term.xidx2, term.xidx1) -= hess_x1x1;
+    (*hess)(term.xidx2, term.xidx2) += hess_x1x1;
+
+    const float hess_y1y1 = term.weight * core.hess_yy;
+    (*hess)(term.yidx1, term.yidx1) += hess_y1y1;
+    (*hess)(term.yidx1, term.yidx2) -= hess_y1y1;
+    (*hess)(term.yidx2, term.yidx1) -= hess_y1y1;
+    (*hess)(term.yidx2, term.yidx2) += hess_y1y1;
+
+    const float hess_x1y1 = term.weight * core.hess_xy;
+    (*hess)(term.xidx1, term.yidx1) += hess_x1y1;
+    (*hess)(term.yidx1, term.xidx1) += hess_x1y1;
+    (*hess)(term.xidx1, term.yidx2) -= hess_x1y1;
+    (*hess)(term.yidx2, term.xidx1) -= hess_x1y1;
+    (*hess)(term.xidx2, term.yidx1) -= hess_x1y1;
+    (*hess)(term.yidx1, term.xidx2) -= hess_x1y1;
+    (*hess)(term.xidx2, term.yidx2) += hess_x1y1;
+    (*hess)(term.yidx2, term.xidx2) += hess_x1y1;
+
+    const float ddx1 = term.weight * core.grad_x;
+    (*grad)(term.xidx1) += ddx1;
+    (*grad)(term.xidx2) -= ddx1;
+
+    const float ddy1 = term.weight * core.grad_y;
+    (*grad)(term.yidx1) += ddy1;
+    (*grad)(term.yidx2) -= ddy1;
+  }
+
+  for (const auto& pair : virtual_costs_) {
+    if (is_masked_active() &&
+        (activity || IsActive(pair.second, active_proximity_pairs)))
+      pair.first->Quadraticize(t, input, hess, grad);
+  }
+}
+
+}  // namespace ilqgames
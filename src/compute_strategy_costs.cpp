@@ -42,6 +42,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <ilqgames/cost/player_cost.h>
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/dynamics/multi_player_flat_system.h>
 #include <ilqgames/dynamics/multi_player_integrable_system.h>
 #include <ilqgames/utils/operating_point.h>
@@ -62,7 +63,7 @@ std::vector<float> ComputeStrategyCosts(
     const std::vector<Strategy>& strategies,
     const OperatingPoint& operating_point,
     const MultiPlayerIntegrableSystem& dynamics, const VectorXf& x0,
-    float time_step, bool open_loop = false) {
+    float time_step, bool open_loop = false, Integrator* integrator = nullptr) {
   // Start at the initial state.
   VectorXf x(x0);
   Time t = 0.0;
@@ -84,7 +85,7 @@ std::vector<float> ComputeStrategyCosts(
     }
 
     // Update costs.
-    const VectorXf next_x = dynamics.Integrate(t, time_step, x, us);
+    const VectorXf next_x = dynamics.Integrate(t, time_step, x, us, integrator);
     const Time next_t = t + time_step;
     for (PlayerIndex ii = 0; ii < dynamics.NumPlayers(); ii++) {
       total_costs[ii] +=
@@ -108,6 +108,49 @@ LinearDynamicsApproximation ConcatenatedDynamicalSystem::Linearize(
   return linearization;
 }
 
+void ConcatenatedDynamicalSystem::LinearizeBatch(
+    Time t0, const std::vector<VectorXf>& xs,
+    const std::vector<std::vector<VectorXf>>& us,
+    std::vector<LinearDynamicsApproximation>* linearizations) const {
+  CHECK_NOTNULL(linearizations);
+  CHECK_EQ(xs.size(), us.size());
+
+  // Reset each linearization to A = I and Bs = 0, reusing storage if possible.
+  const size_t num_time_steps = xs.size();
+  linearizations->resize(num_time_steps);
+  for (auto& lin : *linearizations) {
+    if (lin.A.rows() != xdim_ || lin.Bs.size() != NumPlayers()) {
+      lin = LinearDynamicsApproximation(*this);
+      continue;
+    }
+
+    lin.A.setIdentity();
+    for (auto& B : lin.Bs) B.setZero();
+  }
+
+  // Gather each subsystem's states and controls across time, and linearize
+  // them together.
+  MatrixXf subsystem_xs;
+  MatrixXf subsystem_us;
+  for (PlayerIndex ii = 0; ii < NumPlayers(); ii++) {
+    const auto& subsystem = subsystems_[ii];
+    const Dimension x_start = subsystem_start_dims_[ii];
+    const Dimension xdim = subsystem->XDim();
+    const Dimension udim = subsystem->UDim();
+
+    subsystem_xs.resize(num_time_steps, xdim);
+    subsystem_us.resize(num_time_steps, udim);
+    for (size_t kk = 0; kk < num_time_steps; kk++) {
+      CHECK_EQ(us[kk].size(), NumPlayers());
+      subsystem_xs.row(kk) = xs[kk].segment(x_start, xdim).transpose();
+      subsystem_us.row(kk) = us[kk][ii].transpose();
+    }
+
+    subsystem->LinearizeBatch(t0, time_step_, subsystem_xs, subsystem_us,
+                              x_start, ii, linearizations);
+  }
+}
+
 float ConcatenatedDynamicalSystem::DistanceBetween(const VectorXf& x0,
                                                    const VectorXf& x1) const {
   // HACK: assumes only first subsystem matters.
@@ -129,4 +172,12 @@ float ConcatenatedDynamicalSystem::DistanceBetween(const VectorXf& x0,
   // return total;
 }
 
+float ConcatenatedDynamicalSystem::PlayerDistanceBetween(
+    PlayerIndex player_idx, const VectorXf& x0, const VectorXf& x1) const {
+  const Dimension start_dim = subsystem_start_dims_[player_idx];
+  const Dimension xdim = subsystems_[player_idx]->XDim();
+  return subsystems_[player_idx]->DistanceBetween(x0.segment(start_dim, xdim),
+                                                  x1.segment(start_dim, xdim));
+}
+
 }  // namespace ilqgames
@@ -45,6 +45,8 @@
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <algorithm>
+#include <vector>
 
 namespace ilqgames {
 
@@ -66,6 +68,13 @@ ConcatenatedFlatSystem::ConcatenatedFlatSystem(
     subsystem_start_dims_.push_back(subsystem_start_dims_.back() +
                                     subsystem->XDim());
   }
+
+  max_subsystem_xdim_ = 0;
+  for (const auto& subsystem : subsystems_)
+    max_subsystem_xdim_ = std::max(max_subsystem_xdim_, subsystem->XDim());
+
+  // Linearize up front so that const integration never writes members.
+  ComputeLinearizedSystem();
 }
 
 VectorXf ConcatenatedFlatSystem::Evaluate(
@@ -86,8 +95,11 @@ VectorXf ConcatenatedFlatSystem::Evaluate(
 }
 
 void ConcatenatedFlatSystem::ComputeLinearizedSystem() const {
-  // Populate a block-diagonal A, as well as Bs.
-  LinearDynamicsApproximation linearization(*this);
+  // Populate block-diagonal As, as well as Bs, for both the discrete and
+  // continuous time systems.
+  LinearDynamicsApproximation discrete_linearization(*this);
+  LinearDynamicsApproximation continuous_linearization(*this);
+  continuous_linearization.A.setZero();
 
   Dimension dims_so_far = 0;
   for (size_t ii = 0; ii < NumPlayers(); ii++) {
@@ -95,21 +107,20 @@ void ConcatenatedFlatSystem::ComputeLinearizedSystem() const {
     const Dimension xdim = subsystem->XDim();
     const Dimension udim = subsystem->UDim();
     subsystem->LinearizedSystem(
-        time_step_, linearization.A.block(dims_so_far, dims_so_far, xdim, xdim),
-        linearization.Bs[ii].block(dims_so_far, 0, xdim, udim));
+        time_step_,
+        discrete_linearization.A.block(dims_so_far, dims_so_far, xdim, xdim),
+        discrete_linearization.Bs[ii].block(dims_so_far, 0, xdim, udim));
+    subsystem->ContinuousLinearizedSystem(
+        continuous_linearization.A.block(dims_so_far, dims_so_far, xdim, xdim),
+        continuous_linearization.Bs[ii].block(dims_so_far, 0, xdim, udim));
 
     dims_so_far += xdim;
   }
 
-  discrete_linear_system_.reset(new LinearDynamicsApproximation(linearization));
-
-  // Reconstruct the continuous system.
-  linearization.A -= MatrixXf::Identity(xdim_, xdim_);
-  linearization.A /= time_step_;
-  for (size_t ii = 0; ii < NumPlayers(); ii++)
-    linearization.Bs[ii] /= time_step_;
+  discrete_linear_system_.reset(
+      new LinearDynamicsApproximation(discrete_linearization));
   continuous_linear_system_.reset(
-      new LinearDynamicsApproximation(linearization));
+      new LinearDynamicsApproximation(continuous_linearization));
 }
 
 MatrixXf ConcatenatedFlatSystem::InverseDecouplingMatrix(
@@ -245,133 +256,93 @@ bool ConcatenatedFlatSystem::IsLinearSystemStateSingular(
   return false;
 }
 
+void ConcatenatedFlatSystem::ResizeCostCoordinateBuffers(
+    CostCoordinateBuffers* buffers) const {
+  if (buffers->jacobians.size() == NumPlayers() &&
+      buffers->grad.size() == xdim_)
+    return;
+
+  buffers->first_partials.clear();
+  buffers->second_partials.clear();
+  buffers->jacobians.clear();
+  for (const auto& subsystem : subsystems_) {
+    const Dimension xdim = subsystem->XDim();
+    buffers->first_partials.emplace_back(xdim, VectorXf::Zero(xdim));
+    buffers->second_partials.emplace_back(xdim, MatrixXf::Zero(xdim, xdim));
+    buffers->jacobians.emplace_back(MatrixXf::Zero(xdim, xdim));
+  }
+
+  buffers->block_product.resize(max_subsystem_xdim_, max_subsystem_xdim_);
+  buffers->hess.resize(xdim_, xdim_);
+  buffers->grad.resize(xdim_);
+}
+
 void ConcatenatedFlatSystem::ChangeCostCoordinates(
-    const VectorXf& xi, std::vector<QuadraticCostApproximation>* q) const {
+    const VectorXf& xi, std::vector<QuadraticCostApproximation>* q,
+    CostCoordinateBuffers* buffers) const {
   CHECK_NOTNULL(q);
   CHECK_EQ(q->size(), NumPlayers());
-
-  // For each player we record dx_i/dxi and d2x_i/dxi2.
-  std::vector<std::vector<VectorXf>> first_partials(NumPlayers());
-  std::vector<std::vector<MatrixXf>> second_partials(NumPlayers());
-  Dimension xi_dims_so_far = 0;
+  CHECK_EQ(xi.size(), xdim_);
+
+  // Use buffers local to this call if none were given.
+  CostCoordinateBuffers local_buffers;
+  if (!buffers) buffers = &local_buffers;
+  ResizeCostCoordinateBuffers(buffers);
+  auto& first_partials = buffers->first_partials;
+  auto& second_partials = buffers->second_partials;
+  auto& jacobians = buffers->jacobians;
+  MatrixXf& block_product = buffers->block_product;
+  MatrixXf& hess = buffers->hess;
+  VectorXf& grad = buffers->grad;
+
+  // For each player we record the Jacobian dx_i/dxi_i and the second partials
+  // d2x_i/dxi_i2. The Jacobian of the full map from xi to x is block diagonal.
   for (size_t ii = 0; ii < NumPlayers(); ii++) {
-    const auto& subsystem_ii = subsystems_[ii];
-    const Dimension xdim = subsystem_ii->XDim();
-
-    first_partials[ii] = std::vector<VectorXf>(xdim, VectorXf::Zero(xdim));
-    second_partials[ii] =
-        std::vector<MatrixXf>(xdim, MatrixXf::Zero(xdim, xdim));
+    const auto& subsystem = subsystems_[ii];
+    const Dimension xdim = subsystem->XDim();
+    subsystem->Partial(xi.segment(subsystem_start_dims_[ii], xdim),
+                       &first_partials[ii], &second_partials[ii]);
 
-    DCHECK_LT(xi_dims_so_far + xdim, xi.size());
-    subsystem_ii->Partial(xi.segment(xi_dims_so_far, xdim), &first_partials[ii],
-                          &second_partials[ii]);
-    xi_dims_so_far += xdim;
+    MatrixXf& jacobian = jacobians[ii];
+    for (Dimension kk = 0; kk < xdim; kk++)
+      jacobian.row(kk) = first_partials[ii][kk].transpose();
   }
 
-  // For loop for hessian.
-  // Vector that is going to contain all the cost hessians for each player.
-  std::vector<MatrixXf> hess_xs(NumPlayers(), MatrixXf::Zero(xdim_, xdim_));
-  Dimension rows_so_far = 0;
-
-  // Iterating over primary player indexes.
-  for (PlayerIndex pp = 0; pp < NumPlayers(); pp++) {
-    // Iterating over that player's number of dimensions.
-    for (Dimension ii = 0; ii < SubsystemXDim(pp); ii++) {
-      const Dimension ii_rows = ii + rows_so_far;
-
-      // Iterating over secondary player indexes.
-      Dimension cols_so_far = rows_so_far;
-      for (PlayerIndex qq = pp; qq < NumPlayers(); qq++) {
-        // Iterating over that player's number of dimensions.
-        for (Dimension jj = 0; jj < SubsystemXDim(qq); jj++) {
-          const Dimension jj_cols = jj + cols_so_far;
-
-          // Iterating over each player's cost.
-          for (PlayerIndex rr = 0; rr < NumPlayers(); rr++) {
-            const MatrixXf& Q = (*q)[rr].state.hess;
-            const VectorXf& l = (*q)[rr].state.grad;
-            MatrixXf& xhess = hess_xs[rr];
-            for (Dimension kk = 0; kk < SubsystemXDim(pp); kk++) {
-              float total = 0.0;
-
-              if (pp == qq) {
-                total += l(kk + rows_so_far) * second_partials[pp][kk](ii, jj);
-              }
-
-              float temp = 0.0;
-              for (Dimension ll = 0; ll < SubsystemXDim(qq); ll++) {
-                temp += Q(kk + rows_so_far, ll + cols_so_far) *
-                        first_partials[qq][ll](jj);
-              }
-
-              total += temp * first_partials[pp][kk](ii);
-
-              DCHECK_LT(ii_rows, xdim_);
-              DCHECK_LT(jj_cols, xdim_);
-              xhess(ii_rows, jj_cols) += total;
-              xhess(jj_cols, ii_rows) += total;
-            }
-          }
-        }
-
-        // Increment columns so far to track next subsystem.
-        cols_so_far += SubsystemXDim(qq);
+  // Transform each player's cost one block at a time, i.e., the (pp, qq) block
+  // of the Hessian becomes J_pp^T Q_pp,qq J_qq, plus gradient-weighted second
+  // partials on the diagonal, and each block of the gradient becomes
+  // J_pp^T l_pp.
+  for (auto& quad : *q) {
+    MatrixXf& Q = quad.state.hess;
+    VectorXf& l = quad.state.grad;
+    CHECK_EQ(Q.rows(), xdim_);
+    CHECK_EQ(l.size(), xdim_);
+
+    for (PlayerIndex pp = 0; pp < NumPlayers(); pp++) {
+      const Dimension pp_start = subsystem_start_dims_[pp];
+      const Dimension pp_dim = SubsystemXDim(pp);
+      const MatrixXf& J_pp = jacobians[pp];
+
+      for (PlayerIndex qq = 0; qq < NumPlayers(); qq++) {
+        const Dimension qq_start = subsystem_start_dims_[qq];
+        const Dimension qq_dim = SubsystemXDim(qq);
+        auto product = block_product.topLeftCorner(pp_dim, qq_dim);
+        product.noalias() =
+            Q.block(pp_start, qq_start, pp_dim, qq_dim) * jacobians[qq];
+        hess.block(pp_start, qq_start, pp_dim, qq_dim).noalias() =
+            J_pp.transpose() * product;
       }
-    }
 
-    // Increment rows so far to track next subsystem.
-    rows_so_far += SubsystemXDim(pp);
-  }
+      auto hess_pp = hess.block(pp_start, pp_start, pp_dim, pp_dim);
+      for (Dimension kk = 0; kk < pp_dim; kk++)
+        hess_pp += l(pp_start + kk) * second_partials[pp][kk];
 
-  // Update Qs to match these hessians.
-  for (PlayerIndex pp = 0; pp < NumPlayers(); pp++) {
-    //    std::cout << "pp: " << pp << "\n" << hess_xs[pp] << std::endl <<
-    //    "-----------------\n";
-    // if (pp == 1) {
-    //   std::cout << "pp: " << pp << "\n"
-    //             << hess_xs[pp] << std::endl
-    //             << "-----------------\n";
-    // }
-    (*q)[pp].state.hess.swap(hess_xs[pp]);
-  }
-
-  // For loop for gradient.
-  // Vector that is going to contain all the cost gradients for each player.
-  std::vector<VectorXf> grad_xs(NumPlayers(), VectorXf::Zero(xdim_));
-  rows_so_far = 0;
-
-  // Iterating over primary player indexes.
-  for (PlayerIndex pp = 0; pp < NumPlayers(); pp++) {
-    const VectorXf& l = (*q)[pp].state.grad;
-
-    // Iterating over that player's number of dimensions.
-    for (Dimension ii = 0; ii < SubsystemXDim(pp); ii++) {
-      // Iterating over each player's cost.
-      for (Dimension jj = 0; jj < SubsystemXDim(pp); jj++) {
-        DCHECK_LT(jj + rows_so_far, l.size());
-        grad_xs[pp](ii + rows_so_far) +=
-            l(jj + rows_so_far) * first_partials[pp][jj](ii);
-      }
+      grad.segment(pp_start, pp_dim).noalias() =
+          J_pp.transpose() * l.segment(pp_start, pp_dim);
     }
 
-    // Increment rows so far to track next subsystem.
-    rows_so_far += SubsystemXDim(pp);
-  }
-
-  // Update ls to match these gradients.
-  for (PlayerIndex pp = 0; pp < NumPlayers(); pp++) {
-    // if (pp == 1) {
-    //   std::cout << "pp: " << pp << "computed" <<  "\n"
-    //             << grad_xs[pp] << std::endl
-    //             << "-----------------\n";
-    //   std::cout << "pp: " << pp << "original \n"
-    //             << (*q)[pp].l << std::endl
-    //             << "-----------------\n";
-    // }
-    // CHECK_LT(std::abs(grad_xs[pp](0) - (*q)[pp].l(0)), 1e-4);
-    // CHECK_LT(std::abs(grad_xs[pp](1) - (*q)[pp].l(1)), 1e-4);
-
-    (*q)[pp].state.grad.swap(grad_xs[pp]);
+    Q = hess;
+    l = grad;
   }
 
   // Now modify the cost hessians, i.e. 'Rs'.
@@ -422,4 +393,12 @@ float ConcatenatedFlatSystem::DistanceBetween(const VectorXf& x0,
   return total;
 }
 
+float ConcatenatedFlatSystem::PlayerDistanceBetween(
+    PlayerIndex player_idx, const VectorXf& x0, const VectorXf& x1) const {
+  const Dimension start_dim = subsystem_start_dims_[player_idx];
+  const Dimension xdim = subsystems_[player_idx]->XDim();
+  return subsystems_[player_idx]->DistanceBetween(x0.segment(start_dim, xdim),
+                                                  x1.segment(start_dim, xdim));
+}
+
 }  // namespace ilqgames
@@ -43,9 +43,26 @@
 
 #include <ilqgames/cost/cost.h>
 
+#include <glog/logging.h>
+#include <cmath>
+
 namespace ilqgames {
 
-// Initial time associated to this cost.
-Time Cost::initial_time_ = 0.0;
+// Initial time and time step associated to this cost.
+thread_local Time Cost::initial_time_ = 0.0;
+thread_local Time Cost::time_step_ = 0.0;
+
+bool Cost::PrecomputedTimeIndex(Time t, size_t table_size, size_t* kk) const {
+  CHECK_NOTNULL(kk);
+
+  if (precomputed_initial_time_ != initial_time_ ||
+      precomputed_time_step_ != time_step_ || time_step_ <= 0.0)
+    return false;
+
+  *kk = TimeIndex(t);
+  return *kk < table_size &&
+         std::abs(initial_time_ + time_step_ * static_cast<Time>(*kk) - t) <
+             constants::kSmallNumber;
+}
 
 }  // namespace ilqgames
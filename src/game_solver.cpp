@@ -42,14 +42,15 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/cost/cost.h>
 #include <ilqgames/cost/player_cost.h>
 #include <ilqgames/solver/game_solver.h>
 #include <ilqgames/solver/lq_solver.h>
 #include <ilqgames/utils/compute_strategy_costs.h>
 #include <ilqgames/utils/linear_dynamics_approximation.h>
-#include <ilqgames/utils/loop_timer.h>
 #include <ilqgames/utils/operating_point.h>
 #include <ilqgames/utils/quadratic_cost_approximation.h>
+#include <ilqgames/utils/runtime_predictor.h>
 #include <ilqgames/utils/strategy.h>
 #include <ilqgames/utils/types.h>
 
@@ -78,7 +79,9 @@ bool GameSolver::Solve(const VectorXf& x0,
                        const std::vector<Strategy>& initial_strategies,
                        OperatingPoint* final_operating_point,
                        std::vector<Strategy>* final_strategies, SolverLog* log,
-                       Time max_runtime) {
+                       Time max_runtime,
+                       const CancellationToken* cancellation_token,
+                       const ProgressCallback& progress_callback) {
   // Start a stopwatch.
   const auto solver_call_time = clock::now();
 
@@ -87,6 +90,17 @@ bool GameSolver::Solve(const VectorXf& x0,
     return std::chrono::duration<Time>(clock::now() - start).count();
   };  // elapsed_time
 
+  // Check whether cancellation has been requested, and if so record it.
+  auto is_cancelled = [this, cancellation_token]() {
+    if (!cancellation_token || !cancellation_token->IsCancelled())
+      return false;
+
+    LOG(INFO) << "Solver cancelled after " << this->statistics_.num_iterations
+              << " iterations.";
+    this->statistics_.was_cancelled = true;
+    return true;
+  };  // is_cancelled
+
   // Chech return pointers not null.
   CHECK_NOTNULL(final_strategies);
   CHECK_NOTNULL(final_operating_point);
@@ -120,6 +134,19 @@ bool GameSolver::Solve(const VectorXf& x0,
   // Reset all constraint barrier weights to unity.
   for (PlayerCost& cost : player_costs_) cost.ResetConstraintBarrierWeights();
 
+  // Costs' initial time and time step are kept per thread, so set them for
+  // the thread on which this solve runs.
+  Cost::ResetInitialTime(initial_operating_point.t0);
+  Cost::ResetTimeStep(time_step_);
+
+  // Precompute time-indexed cost terms for this solve.
+  for (PlayerCost& cost : player_costs_) cost.Precompute(num_time_steps_);
+
+  // Reset statistics and forget approximations from previous solves.
+  statistics_ = SolverStatistics();
+  is_approximation_cached_ = false;
+  are_activity_masks_valid_ = false;
+
   // Number of iterations, whether or not the solver has converged, and total
   // costs for all players.
   size_t num_iterations = 0;
@@ -128,7 +155,8 @@ bool GameSolver::Solve(const VectorXf& x0,
   bool was_initial_point_feasible = true;
   std::vector<float> total_costs =
       ComputeStrategyCosts(player_costs_, current_strategies,
-                           current_operating_point, *dynamics_, x0, time_step_);
+                           current_operating_point, *dynamics_, x0, time_step_,
+                           false, &integrator_);
 
   // Log current iterate.
   if (log) {
@@ -137,16 +165,19 @@ bool GameSolver::Solve(const VectorXf& x0,
                           has_converged);
   }
 
-  // Main loop with timer for anytime execution.
+  // Main loop with runtime prediction for anytime execution.
   while (num_iterations < params_.max_solver_iters && !has_converged &&
-         elapsed_time(solver_call_time) <
-             max_runtime - timer_.RuntimeUpperBound()) {
-    // Start loop timer.
-    timer_.Tic();
+         elapsed_time(solver_call_time) +
+                 runtime_predictor_.IterationRuntime(
+                     params_.runtime_quantile) <
+             max_runtime) {
+    // Stop if cancelled.
+    if (is_cancelled()) return false;
 
     // New iteration.
     num_iterations++;
     num_iterations_since_barrier_rescaling++;
+    statistics_.num_iterations++;
 
     // Maybe rescale constraint barrier weights.
     if (num_iterations_since_barrier_rescaling >
@@ -154,6 +185,9 @@ bool GameSolver::Solve(const VectorXf& x0,
       num_iterations_since_barrier_rescaling = 0;
       for (PlayerCost& cost : player_costs_)
         cost.ScaleConstraintBarrierWeights(params_.geometric_barrier_scaling);
+
+      // Barrier weights enter quadraticizations, so cached ones are stale.
+      is_approximation_cached_ = false;
     }
 
     // Swap operating points and compute new current operating point if this is
@@ -168,45 +202,40 @@ bool GameSolver::Solve(const VectorXf& x0,
     }
 
     // Linearize dynamics and quadraticize costs for all players about the new
-    // operating point, only if the system can't be treated as linear from the
-    // outset, in which case we've already linearized it.
-    if (!dynamics_->TreatAsLinear())
-      ComputeLinearization(current_operating_point, &linearization_);
-
-    for (size_t kk = 0; kk < num_time_steps_; kk++) {
-      const Time t = initial_operating_point.t0 + ComputeTimeStamp(kk);
-      const auto& x = current_operating_point.xs[kk];
-      const auto& us = current_operating_point.us[kk];
-
-      // Quadraticize costs.
-      std::transform(player_costs_.begin(), player_costs_.end(),
-                     quadraticization_[kk].begin(),
-                     [&t, &x, &us](const PlayerCost& cost) {
-                       return cost.Quadraticize(t, x, us);
-                     });
-    }
+    // operating point.
+    ComputeApproximation(current_operating_point);
+    if (is_cancelled()) return false;
 
     // Solve LQ game.
-    current_strategies =
-        lq_solver_->Solve(linearization_, quadraticization_, x0);
-
-    // Modify this LQ solution.
-    if (!ModifyLQStrategies(&current_strategies, &current_operating_point,
-                            &has_converged, &was_initial_point_feasible,
-                            &total_costs)) {
-      // Maybe emit warning if exiting early.
-      if (num_iterations == 1) {
-        LOG(WARNING)
-            << "Solver exited after during first iteration, which may indicate "
-               "an infeasible initial operating point.";
+    {
+      const RuntimePredictor::ScopedPhase lq_solve(&runtime_predictor_,
+                                                   SolverPhase::LQ_SOLVE);
+      current_strategies =
+          lq_solver_->Solve(linearization_, quadraticization_, x0);
+    }
+    if (is_cancelled()) return false;
+
+    // Modify this LQ solution. Time the linesearch even if it fails, since
+    // failing linesearches run out of backtracking steps and are the slowest.
+    {
+      const RuntimePredictor::ScopedPhase linesearch(&runtime_predictor_,
+                                                     SolverPhase::LINESEARCH);
+      if (!ModifyLQStrategies(&current_strategies, &current_operating_point,
+                              &has_converged, &was_initial_point_feasible,
+                              &total_costs)) {
+        // Maybe emit warning if exiting early.
+        if (num_iterations == 1) {
+          LOG(WARNING) << "Solver exited after during first iteration, which "
+                          "may indicate an infeasible initial operating point.";
+        }
+
+        if (was_initial_point_feasible)
+          LOG(INFO) << "Previous operating point was feasible.";
+        else
+          LOG(INFO) << "Previous operating point was infeasible.";
+
+        return false;
       }
-
-      if (was_initial_point_feasible)
-        LOG(INFO) << "Previous operating point was feasible.";
-      else
-        LOG(INFO) << "Previous operating point was infeasible.";
-
-      return false;
     }
 
     // Log current iterate.
@@ -216,8 +245,9 @@ bool GameSolver::Solve(const VectorXf& x0,
                             has_converged);
     }
 
-    // Record loop runtime.
-    timer_.Toc();
+    // Report progress.
+    if (progress_callback)
+      progress_callback(num_iterations, current_operating_point, total_costs);
   }
 
   // Maybe emit warning if exiting early.
@@ -239,6 +269,109 @@ bool GameSolver::Solve(const VectorXf& x0,
   return true;
 }
 
+void GameSolver::ComputeApproximation(const OperatingPoint& op) {
+  const bool is_incremental =
+      params_.incremental_approximation && is_approximation_cached_;
+  const float tolerance = params_.incremental_tolerance;
+
+  // Check if the given controls for the given players are within tolerance of
+  // the reference controls.
+  auto are_controls_close = [tolerance](
+                                const std::vector<VectorXf>& us,
+                                const std::vector<VectorXf>& reference_us,
+                                const std::vector<PlayerIndex>& players) {
+    for (const PlayerIndex jj : players) {
+      if ((us[jj] - reference_us[jj]).cwiseAbs().maxCoeff() > tolerance)
+        return false;
+    }
+    return true;
+  };  // are_controls_close
+
+  auto is_state_close = [tolerance](const VectorXf& x,
+                                    const VectorXf& reference_x) {
+    return (x - reference_x).cwiseAbs().maxCoeff() <= tolerance;
+  };  // is_state_close
+
+  // Linearize dynamics only if the system can't be treated as linear from the
+  // outset, in which case we've already linearized it.
+  runtime_predictor_.Tic(SolverPhase::LINEARIZE);
+  if (!dynamics_->TreatAsLinear()) {
+    statistics_.num_linearizations += num_time_steps_;
+
+    if (is_incremental) {
+      std::vector<bool> stale_time_steps(num_time_steps_, true);
+      for (size_t kk = 0; kk < num_time_steps_; kk++) {
+        if (is_state_close(op.xs[kk], linearization_point_.xs[kk]) &&
+            are_controls_close(op.us[kk], linearization_point_.us[kk],
+                               all_players_)) {
+          stale_time_steps[kk] = false;
+          statistics_.num_linearization_hits++;
+        } else {
+          linearization_point_.xs[kk] = op.xs[kk];
+          linearization_point_.us[kk] = op.us[kk];
+        }
+      }
+
+      RecomputeLinearization(op, stale_time_steps, &linearization_);
+    } else {
+      ComputeLinearization(op, &linearization_);
+      if (params_.incremental_approximation) {
+        linearization_point_.xs = op.xs;
+        linearization_point_.us = op.us;
+      }
+    }
+  }
+
+  runtime_predictor_.Toc(SolverPhase::LINEARIZE);
+
+  // Quadraticize costs for each player.
+  runtime_predictor_.Tic(SolverPhase::QUADRATICIZE);
+  for (size_t kk = 0; kk < num_time_steps_; kk++) {
+    const Time t = op.t0 + ComputeTimeStamp(kk);
+    const auto& x = op.xs[kk];
+    const auto& us = op.us[kk];
+
+    // Active proximity pairs at this time step, found at most once for all
+    // players and only if there are no activity masks.
+    const std::vector<bool>* active_proximity_pairs = nullptr;
+    bool has_active_proximity_pairs = false;
+
+    for (PlayerIndex ii = 0; ii < player_costs_.size(); ii++) {
+      statistics_.num_quadraticizations++;
+
+      OperatingPoint& point = quadraticization_points_[ii];
+      if (is_incremental && is_state_close(x, point.xs[kk]) &&
+          are_controls_close(us, point.us[kk], cost_control_players_[ii])) {
+        statistics_.num_quadraticization_hits++;
+        continue;
+      }
+
+      // Skip inactive terms if we have a mask for this operating point.
+      const std::vector<bool>* activity = nullptr;
+      if (are_activity_masks_valid_) {
+        activity = &activity_masks_[kk][ii];
+        statistics_.num_activity_terms += activity->size();
+        statistics_.num_skipped_terms +=
+            std::count(activity->begin(), activity->end(), false);
+      } else if (!has_active_proximity_pairs) {
+        active_proximity_pairs = FindActiveProximityPairs(x);
+        has_active_proximity_pairs = true;
+      }
+
+      quadraticization_[kk][ii] = player_costs_[ii].Quadraticize(
+          t, x, us, activity, active_proximity_pairs);
+      if (params_.incremental_approximation) {
+        point.xs[kk] = x;
+        for (const PlayerIndex jj : cost_control_players_[ii])
+          point.us[kk][jj] = us[jj];
+      }
+    }
+  }
+  runtime_predictor_.Toc(SolverPhase::QUADRATICIZE);
+
+  is_approximation_cached_ = params_.incremental_approximation;
+}
+
 bool GameSolver::CurrentOperatingPoint(
     const OperatingPoint& last_operating_point,
     const std::vector<Strategy>& current_strategies,
@@ -254,6 +387,10 @@ bool GameSolver::CurrentOperatingPoint(
     total_costs->resize(player_costs_.size());
   std::fill(total_costs->begin(), total_costs->end(), 0.0);
 
+  // Activity masks only describe the new operating point once it has been
+  // completely rolled out.
+  are_activity_masks_valid_ = false;
+
   // Integrate dynamics and populate operating point, one time step at a time.
   VectorXf x(last_operating_point.xs[0]);
   for (size_t kk = 0; kk < num_time_steps_; kk++) {
@@ -264,9 +401,18 @@ bool GameSolver::CurrentOperatingPoint(
     const auto& last_us = last_operating_point.us[kk];
     auto& current_us = current_operating_point->us[kk];
 
-    // Accumulate costs.
-    for (size_t ii = 0; ii < player_costs_.size(); ii++)
-      (*total_costs)[ii] += player_costs_[ii].Evaluate(t, x, current_us);
+    // Accumulate costs, finding active proximity pairs once for all players.
+    const std::vector<bool>* active_proximity_pairs =
+        FindActiveProximityPairs(x);
+    for (size_t ii = 0; ii < player_costs_.size(); ii++) {
+      (*total_costs)[ii] +=
+          (params_.skip_inactive_costs)
+              ? player_costs_[ii].Evaluate(
+                    t, x, current_us, params_.activity_margin,
+                    &activity_masks_[kk][ii], active_proximity_pairs)
+              : player_costs_[ii].Evaluate(t, x, current_us,
+                                           active_proximity_pairs);
+    }
 
     // Check convergence and trust region (including explicit inequality
     // constraints).
@@ -296,12 +442,21 @@ bool GameSolver::CurrentOperatingPoint(
 
     // Integrate dynamics for one time step.
     if (kk < num_time_steps_ - 1)
-      x = dynamics_->Integrate(t, time_step_, x, current_us);
+      x = dynamics_->Integrate(t, time_step_, x, current_us, &integrator_);
   }
 
+  are_activity_masks_valid_ = params_.skip_inactive_costs;
   return true;
 }
 
+const std::vector<bool>* GameSolver::FindActiveProximityPairs(
+    const VectorXf& x) const {
+  if (proximity_broad_phase_.NumPairs() == 0) return nullptr;
+
+  proximity_broad_phase_.FindActivePairs(x, &active_proximity_pairs_);
+  return &active_proximity_pairs_;
+}
+
 float GameSolver::StateDistance(const VectorXf& x1, const VectorXf& x2,
                                 const std::vector<Dimension>& dims) const {
   if (dims.empty()) return (x1 - x2).cwiseAbs().maxCoeff();
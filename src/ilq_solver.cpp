@@ -46,13 +46,13 @@
 #include <ilqgames/solver/ilq_solver.h>
 #include <ilqgames/solver/lq_solver.h>
 #include <ilqgames/utils/linear_dynamics_approximation.h>
-#include <ilqgames/utils/loop_timer.h>
 #include <ilqgames/utils/operating_point.h>
 #include <ilqgames/utils/quadratic_cost_approximation.h>
 #include <ilqgames/utils/strategy.h>
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -64,18 +64,37 @@ void ILQSolver::ComputeLinearization(
     std::vector<LinearDynamicsApproximation>* linearization) {
   CHECK_NOTNULL(linearization);
 
-  // Check if linearization is the right length.
-  if (linearization->size() != op.xs.size())
-    linearization->resize(op.xs.size());
+  // Cast dynamics to appropriate type.
+  const auto dyn =
+      static_cast<const MultiPlayerDynamicalSystem*>(dynamics_.get());
+
+  // Populate all time steps at once, so that dynamics may batch them.
+  dyn->LinearizeBatch(op.t0, op.xs, op.us, linearization);
+}
+
+void ILQSolver::RecomputeLinearization(
+    const OperatingPoint& op, const std::vector<bool>& stale_time_steps,
+    std::vector<LinearDynamicsApproximation>* linearization) {
+  CHECK_NOTNULL(linearization);
+  CHECK_EQ(stale_time_steps.size(), op.xs.size());
+
+  // If every time step is stale, batch them all.
+  if (std::all_of(stale_time_steps.begin(), stale_time_steps.end(),
+                  [](bool is_stale) { return is_stale; })) {
+    ComputeLinearization(op, linearization);
+    return;
+  }
 
   // Cast dynamics to appropriate type.
   const auto dyn =
       static_cast<const MultiPlayerDynamicalSystem*>(dynamics_.get());
 
-  // Populate one timestep at a time.
-  for (size_t kk = 0; kk < op.xs.size(); kk++) {
-    const Time t = op.t0 + ComputeTimeStamp(kk);
-    (*linearization)[kk] = dyn->Linearize(t, op.xs[kk], op.us[kk]);
+  // Relinearize stale time steps one at a time.
+  for (size_t kk = 0; kk < stale_time_steps.size(); kk++) {
+    if (stale_time_steps[kk]) {
+      (*linearization)[kk] =
+          dyn->Linearize(op.t0 + ComputeTimeStamp(kk), op.xs[kk], op.us[kk]);
+    }
   }
 }
 
@@ -45,6 +45,8 @@
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <cmath>
+#include <utility>
 
 namespace ilqgames {
 
@@ -59,6 +61,13 @@ float LocallyConvexProximityCost::Evaluate(const VectorXf& input) const {
   return 0.5 * weight_ * std::min(delta_x * delta_x, delta_y * delta_y);
 }
 
+bool LocallyConvexProximityCost::IsActive(const VectorXf& input,
+                                          float margin) const {
+  const float radius = threshold_ + margin;
+  return std::abs(input(xidx1_) - input(xidx2_)) < radius &&
+         std::abs(input(yidx1_) - input(yidx2_)) < radius;
+}
+
 void LocallyConvexProximityCost::Quadraticize(const VectorXf& input,
                                               MatrixXf* hess,
                                               VectorXf* grad) const {
@@ -103,4 +112,20 @@ void LocallyConvexProximityCost::Quadraticize(const VectorXf& input,
   }
 }
 
+bool LocallyConvexProximityCost::ProximityPair(
+    std::pair<Dimension, Dimension>* position_idxs1,
+    std::pair<Dimension, Dimension>* position_idxs2, float* radius) const {
+  CHECK_NOTNULL(position_idxs1);
+  CHECK_NOTNULL(position_idxs2);
+  CHECK_NOTNULL(radius);
+
+  *position_idxs1 = {xidx1_, yidx1_};
+  *position_idxs2 = {xidx2_, yidx2_};
+
+  // Both coordinates must be within the threshold, so the positions must be
+  // within a circle circumscribing the corresponding square.
+  *radius = std::sqrt(2.0) * threshold_;
+  return true;
+}
+
 }  // namespace ilqgames
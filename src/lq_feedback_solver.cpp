@@ -83,8 +83,10 @@ std::vector<Strategy> LQFeedbackSolver::Solve(
                             dynamics_->UDim(ii));
 
   // Initialize Zs and zetas at the final time.
+  // NOTE: Zs are symmetric, so only their lower triangles are kept up to date.
   for (PlayerIndex ii = 0; ii < dynamics_->NumPlayers(); ii++) {
-    Zs_[ii] = quadraticization.back()[ii].state.hess;
+    Zs_[ii].triangularView<Eigen::Lower>() =
+        quadraticization.back()[ii].state.hess;
     zetas_[ii] = quadraticization.back()[ii].state.grad;
   }
 
@@ -102,8 +104,10 @@ std::vector<Strategy> LQFeedbackSolver::Solve(
     // players have the same Z.
     Dimension cumulative_udim_row = 0;
     for (PlayerIndex ii = 0; ii < dynamics_->NumPlayers(); ii++) {
-      // Intermediate variable to store B[ii]' * Z[ii].
-      const MatrixXf BiZi = lin.Bs[ii].transpose() * Zs_[ii];
+      // Intermediate variable to store B[ii]' * Z[ii], computed from the lower
+      // triangle of Z[ii].
+      ZB_.noalias() = Zs_[ii].selfadjointView<Eigen::Lower>() * lin.Bs[ii];
+      const auto BiZi = ZB_.transpose();
 
       Dimension cumulative_udim_col = 0;
       for (PlayerIndex jj = 0; jj < dynamics_->NumPlayers(); jj++) {
@@ -154,20 +158,27 @@ std::vector<Strategy> LQFeedbackSolver::Solve(
       beta_ -= lin.Bs[ii] * alphas_[ii];
     }
 
-    // Update Zs and zetas.
+    // Update Zs and zetas. Symmetric products only compute the lower triangle.
     for (PlayerIndex ii = 0; ii < dynamics_->NumPlayers(); ii++) {
-      zetas_[ii] = (F_.transpose() * (zetas_[ii] + Zs_[ii] * beta_) +
-                    quad[ii].state.grad)
-                       .eval();
-      Zs_[ii] = (F_.transpose() * Zs_[ii] * F_ + quad[ii].state.hess).eval();
+      const auto Zi = Zs_[ii].selfadjointView<Eigen::Lower>();
+      zeta_.noalias() = Zi * beta_;
+      zeta_ += zetas_[ii];
+      zetas_[ii].noalias() = F_.transpose() * zeta_;
+      zetas_[ii] += quad[ii].state.grad;
+
+      ZF_.noalias() = Zi * F_;
+      Zs_[ii].triangularView<Eigen::Lower>() = quad[ii].state.hess;
+      Zs_[ii].triangularView<Eigen::Lower>() += F_.transpose() * ZF_;
 
       // Add terms for nonzero Rijs.
       for (const auto& Rij_entry : quad[ii].control) {
         const PlayerIndex jj = Rij_entry.first;
         const MatrixXf& Rij = Rij_entry.second.hess;
         const VectorXf& rij = Rij_entry.second.grad;
-        zetas_[ii] += Ps_[jj].transpose() * (Rij * alphas_[jj] - rij);
-        Zs_[ii] += Ps_[jj].transpose() * Rij * Ps_[jj];
+        zetas_[ii].noalias() += Ps_[jj].transpose() * (Rij * alphas_[jj] - rij);
+
+        RP_.noalias() = Rij * Ps_[jj];
+        Zs_[ii].triangularView<Eigen::Lower>() += Ps_[jj].transpose() * RP_;
       }
     }
   }
@@ -41,31 +41,42 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/dynamics/multi_player_dynamical_system.h>
 #include <ilqgames/utils/linear_dynamics_approximation.h>
 #include <ilqgames/utils/types.h>
 
+#include <glog/logging.h>
+#include <vector>
+
 namespace ilqgames {
 
+void MultiPlayerDynamicalSystem::LinearizeBatch(
+    Time t0, const std::vector<VectorXf>& xs,
+    const std::vector<std::vector<VectorXf>>& us,
+    std::vector<LinearDynamicsApproximation>* linearizations) const {
+  CHECK_NOTNULL(linearizations);
+  CHECK_EQ(xs.size(), us.size());
+
+  linearizations->resize(xs.size());
+  for (size_t kk = 0; kk < xs.size(); kk++) {
+    const Time t = t0 + time_step_ * static_cast<Time>(kk);
+    (*linearizations)[kk] = Linearize(t, xs[kk], us[kk]);
+  }
+}
+
 VectorXf MultiPlayerDynamicalSystem::Integrate(
     Time t0, Time time_interval, const VectorXf& x0,
-    const std::vector<VectorXf>& us) const {
-  // Number of integration steps and corresponding time step.
-  constexpr size_t kNumIntegrationSteps = 2;
-  const double dt = time_interval / static_cast<Time>(kNumIntegrationSteps);
+    const std::vector<VectorXf>& us, Integrator* integrator) const {
+  auto x_dot = [this, &us](Time t, const VectorXf& x, VectorXf* deriv) {
+    *deriv = this->Evaluate(t, x, us);
+  };  // x_dot
 
-  // RK4 integration. See https://en.wikipedia.org/wiki/Runge-Kutta_methods for
-  // further details.
-  VectorXf x(x0);
-  for (Time t = t0; t < t0 + time_interval - 0.5 * dt; t += dt) {
-    const VectorXf k1 = dt * Evaluate(t, x, us);
-    const VectorXf k2 = dt * Evaluate(t + 0.5 * dt, x + 0.5 * k1, us);
-    const VectorXf k3 = dt * Evaluate(t + 0.5 * dt, x + 0.5 * k2, us);
-    const VectorXf k4 = dt * Evaluate(t + dt, x + k3, us);
-
-    x += (k1 + 2.0 * (k2 + k3) + k4) / 6.0;
-  }
+  static thread_local Integrator default_integrator;
+  if (!integrator) integrator = &default_integrator;
 
+  VectorXf x(x0);
+  integrator->Integrate(x_dot, t0, time_interval, &x);
   return x;
 }
 
@@ -41,42 +41,44 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/dynamics/multi_player_flat_system.h>
 #include <ilqgames/utils/linear_dynamics_approximation.h>
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <cmath>
 
 namespace ilqgames {
 
 VectorXf MultiPlayerFlatSystem::Integrate(
-    Time time_interval, const VectorXf& xi0,
-    const std::vector<VectorXf>& vs) const {
-  // Number of integration steps and corresponding time step.
-  constexpr size_t kNumIntegrationSteps = 2;
-  const double dt = time_step_ / static_cast<Time>(kNumIntegrationSteps);
-
+    Time time_interval, const VectorXf& xi0, const std::vector<VectorXf>& vs,
+    Integrator* integrator) const {
   CHECK_NOTNULL(continuous_linear_system_.get());
-  auto xi_dot = [this, &vs](const VectorXf& xi) {
-    VectorXf deriv = this->continuous_linear_system_->A * xi;
+  CHECK_NOTNULL(discrete_linear_system_.get());
+
+  // Over a full time step, apply the exact discrete time system.
+  if (std::abs(time_interval - time_step_) <
+      constants::kSmallNumber * time_step_) {
+    VectorXf xi = discrete_linear_system_->A * xi0;
     for (size_t ii = 0; ii < NumPlayers(); ii++)
-      deriv += this->continuous_linear_system_->Bs[ii] * vs[ii];
+      xi.noalias() += discrete_linear_system_->Bs[ii] * vs[ii];
 
-    return deriv;
-  };  // xi_dot
+    return xi;
+  }
 
-  // RK4 integration. See https://en.wikipedia.org/wiki/Runge-Kutta_methods for
-  // further details.
-  VectorXf xi(xi0);
-  for (Time t = 0.0; t < time_interval - 0.5 * dt; t += dt) {
-    const VectorXf k1 = dt * xi_dot(xi);
-    const VectorXf k2 = dt * xi_dot(xi + 0.5 * k1);
-    const VectorXf k3 = dt * xi_dot(xi + 0.5 * k2);
-    const VectorXf k4 = dt * xi_dot(xi + k3);
+  // Otherwise, integrate the continuous time system.
+  auto xi_dot = [this, &vs](Time t, const VectorXf& xi, VectorXf* deriv) {
+    deriv->noalias() = this->continuous_linear_system_->A * xi;
+    for (size_t ii = 0; ii < NumPlayers(); ii++)
+      deriv->noalias() += this->continuous_linear_system_->Bs[ii] * vs[ii];
+  };  // xi_dot
 
-    xi += (k1 + 2.0 * (k2 + k3) + k4) / 6.0;
-  }
+  static thread_local Integrator default_integrator;
+  if (!integrator) integrator = &default_integrator;
 
+  VectorXf xi(xi0);
+  integrator->Integrate(xi_dot, 0.0, time_interval, &xi);
   return xi;
 }
 
@@ -52,7 +52,7 @@ namespace ilqgames {
 
 VectorXf MultiPlayerIntegrableSystem::Integrate(
     Time t0, Time t, const VectorXf& x0, const OperatingPoint& operating_point,
-    const std::vector<Strategy>& strategies) const {
+    const std::vector<Strategy>& strategies, Integrator* integrator) const {
   CHECK_GE(t, t0);
   CHECK_GE(t0, operating_point.t0);
   CHECK_EQ(strategies.size(), NumPlayers());
@@ -70,20 +70,22 @@ VectorXf MultiPlayerIntegrableSystem::Integrate(
   // 't0' to the next discrete timestep.
   VectorXf x(x0);
   if (t0 > operating_point.t0)
-    x = IntegrateToNextTimeStep(t0, x0, operating_point, strategies);
+    x = IntegrateToNextTimeStep(t0, x0, operating_point, strategies,
+                                integrator);
 
   // Integrate forward step by step up to timestep including t.
   x = Integrate(current_timestep + 1, final_timestep, x, operating_point,
-                strategies);
+                strategies, integrator);
 
   // Integrate forward from this timestep to t.
-  return IntegrateFromPriorTimeStep(t, x, operating_point, strategies);
+  return IntegrateFromPriorTimeStep(t, x, operating_point, strategies,
+                                    integrator);
 }
 
 VectorXf MultiPlayerIntegrableSystem::Integrate(
     size_t initial_timestep, size_t final_timestep, const VectorXf& x0,
     const OperatingPoint& operating_point,
-    const std::vector<Strategy>& strategies) const {
+    const std::vector<Strategy>& strategies, Integrator* integrator) const {
   VectorXf x(x0);
   std::vector<VectorXf> us(NumPlayers());
   for (size_t kk = initial_timestep; kk < final_timestep; kk++) {
@@ -94,7 +96,7 @@ VectorXf MultiPlayerIntegrableSystem::Integrate(
       us[ii] = strategies[ii](kk, x - operating_point.xs[kk],
                               operating_point.us[kk][ii]);
 
-    x = Integrate(t, time_step_, x, us);
+    x = Integrate(t, time_step_, x, us, integrator);
   }
 
   return x;
@@ -102,7 +104,7 @@ VectorXf MultiPlayerIntegrableSystem::Integrate(
 
 VectorXf MultiPlayerIntegrableSystem::IntegrateToNextTimeStep(
     Time t0, const VectorXf& x0, const OperatingPoint& operating_point,
-    const std::vector<Strategy>& strategies) const {
+    const std::vector<Strategy>& strategies, Integrator* integrator) const {
   CHECK_GE(t0, operating_point.t0);
 
   // Compute remaining time this timestep.
@@ -130,12 +132,12 @@ VectorXf MultiPlayerIntegrableSystem::IntegrateToNextTimeStep(
     us[ii] = strategies[ii](current_timestep, x0 - x0_ref,
                             operating_point.us[current_timestep][ii]);
 
-  return Integrate(t0, remaining_time_this_step, x0, us);
+  return Integrate(t0, remaining_time_this_step, x0, us, integrator);
 }
 
 VectorXf MultiPlayerIntegrableSystem::IntegrateFromPriorTimeStep(
     Time t, const VectorXf& x0, const OperatingPoint& operating_point,
-    const std::vector<Strategy>& strategies) const {
+    const std::vector<Strategy>& strategies, Integrator* integrator) const {
   // Compute time until next timestep.
   const Time relative_t = t - operating_point.t0;
   const size_t current_timestep = static_cast<size_t>(relative_t / time_step_);
@@ -153,7 +155,7 @@ VectorXf MultiPlayerIntegrableSystem::IntegrateFromPriorTimeStep(
   }
 
   return Integrate(operating_point.t0 + time_step_ * current_timestep,
-                   remaining_time_until_t, x0, us);
+                   remaining_time_until_t, x0, us, integrator);
 }
 
 }  // namespace ilqgames
@@ -48,10 +48,28 @@
 
 namespace ilqgames {
 
+void NominalPathLengthCost::Precompute(size_t num_time_steps) {
+  nominal_path_lengths_.resize(num_time_steps);
+  for (size_t kk = 0; kk < num_time_steps; kk++) {
+    const Time t = initial_time_ + time_step_ * static_cast<Time>(kk);
+    nominal_path_lengths_[kk] = t * nominal_speed_;
+  }
+
+  SetPrecomputedTimeGrid();
+}
+
+float NominalPathLengthCost::NominalPathLength(Time t) const {
+  size_t kk;
+  if (PrecomputedTimeIndex(t, nominal_path_lengths_.size(), &kk))
+    return nominal_path_lengths_[kk];
+
+  return t * nominal_speed_;
+}
+
 float NominalPathLengthCost::Evaluate(Time t, const VectorXf& input) const {
   CHECK_LT(dimension_, input.size());
 
-  const float delta = input(dimension_) - t * nominal_speed_;
+  const float delta = input(dimension_) - NominalPathLength(t);
 
   return 0.5 * weight_ * delta * delta;
 }
@@ -69,7 +87,7 @@ void NominalPathLengthCost::Quadraticize(Time t, const VectorXf& input,
 
   // Populate Hessian and gradient.
   (*hess)(dimension_, dimension_) += weight_;
-  (*grad)(dimension_) += weight_ * (input(dimension_) - t * nominal_speed_);
+  (*grad)(dimension_) += weight_ * (input(dimension_) - NominalPathLength(t));
 }
 
 }  // namespace ilqgames
@@ -42,19 +42,47 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <ilqgames/constraint/constraint.h>
+#include <ilqgames/cost/compiled_costs.h>
 #include <ilqgames/cost/cost.h>
 #include <ilqgames/cost/player_cost.h>
+#include <ilqgames/cost/shared_proximity_terms.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
 #include <ilqgames/utils/operating_point.h>
 #include <ilqgames/utils/quadratic_cost_approximation.h>
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace ilqgames {
 
 namespace {
 
+// Find the control term for the given player in the given quadratic
+// approximation, initializing R and r to zero if we haven't seen this player
+// yet.
+SingleCostApproximation& FindOrAddControlApproximation(
+    PlayerIndex player, const std::vector<VectorXf>& us, float regularization,
+    QuadraticCostApproximation* q) {
+  auto iter = q->control.find(player);
+  if (iter == q->control.end()) {
+    auto inserted_pair = q->control.emplace(
+        player, SingleCostApproximation(us[player].size(), regularization));
+
+    // Second element should be true because we definitely won't have any
+    // key collisions.
+    CHECK(inserted_pair.second);
+
+    // Update iter to point to where the new R was inserted.
+    iter = inserted_pair.first;
+  }
+
+  return iter->second;
+}
+
 // Accumulate control costs into the given quadratic approximation.
 // NOTE: templated to allow use with constraints as well.
 template <typename T>
@@ -66,22 +94,9 @@ void AccumulateControlCosts(const CostMap<T>& costs, Time t,
     const PlayerIndex player = pair.first;
     const auto& cost = pair.second;
 
-    // If we haven't seen this player yet, initialize R and r to zero.
-    auto iter = q->control.find(player);
-    if (iter == q->control.end()) {
-      auto inserted_pair = q->control.emplace(
-          player, SingleCostApproximation(us[player].size(), regularization));
-
-      // Second element should be true because we definitely won't have any
-      // key collisions.
-      CHECK(inserted_pair.second);
-
-      // Update iter to point to where the new R was inserted.
-      iter = inserted_pair.first;
-    }
-
-    cost->Quadraticize(t, us[player], &(iter->second.hess),
-                       &(iter->second.grad));
+    SingleCostApproximation& control =
+        FindOrAddControlApproximation(player, us, regularization, q);
+    cost->Quadraticize(t, us[player], &control.hess, &control.grad);
   }
 }
 
@@ -89,11 +104,13 @@ void AccumulateControlCosts(const CostMap<T>& costs, Time t,
 
 void PlayerCost::AddStateCost(const std::shared_ptr<Cost>& cost) {
   state_costs_.emplace_back(cost);
+  is_compiled_ = false;
 }
 
 void PlayerCost::AddControlCost(PlayerIndex idx,
                                 const std::shared_ptr<Cost>& cost) {
   control_costs_.emplace(idx, cost);
+  is_compiled_ = false;
 }
 
 void PlayerCost::AddStateConstraint(
@@ -106,21 +123,57 @@ void PlayerCost::AddControlConstraint(
   control_constraints_.emplace(idx, constraint);
 }
 
-float PlayerCost::Evaluate(Time t, const VectorXf& x,
-                           const std::vector<VectorXf>& us) const {
-  float total_cost = 0.0;
-
-  // State costs.
-  for (const auto& cost : state_costs_) total_cost += cost->Evaluate(t, x);
+void PlayerCost::Compile(
+    const std::shared_ptr<SharedProximityTerms>& shared_proximity_terms,
+    ProximityBroadPhase* proximity_broad_phase) {
+  compiled_state_costs_ = CompiledCosts(shared_proximity_terms);
+  for (const auto& cost : state_costs_) {
+    // Register pairwise proximity costs with the broad-phase.
+    std::pair<Dimension, Dimension> position_idxs1, position_idxs2;
+    float radius;
+    const size_t proximity_pair =
+        (proximity_broad_phase &&
+         cost->ProximityPair(&position_idxs1, &position_idxs2, &radius))
+            ? proximity_broad_phase->AddPair(position_idxs1, position_idxs2,
+                                             radius)
+            : CompiledCosts::kNoProximityPair;
+    compiled_state_costs_.Add(cost, proximity_pair);
+  }
 
-  // Control costs.
+  // Group control costs by player.
+  compiled_control_costs_.clear();
   for (const auto& pair : control_costs_) {
-    const PlayerIndex& player = pair.first;
-    const auto& cost = pair.second;
-    total_cost += cost->Evaluate(t, us[player]);
+    auto iter = std::find_if(
+        compiled_control_costs_.begin(), compiled_control_costs_.end(),
+        [&pair](const std::pair<PlayerIndex, CompiledCosts>& compiled) {
+          return compiled.first == pair.first;
+        });
+    if (iter == compiled_control_costs_.end()) {
+      compiled_control_costs_.emplace_back(pair.first, CompiledCosts());
+      iter = compiled_control_costs_.end() - 1;
+    }
+
+    iter->second.Add(pair.second);
   }
 
-  return total_cost;
+  is_compiled_ = true;
+}
+
+float PlayerCost::Evaluate(
+    Time t, const VectorXf& x, const std::vector<VectorXf>& us,
+    const std::vector<bool>* active_proximity_pairs) const {
+  return EvaluateStateCosts(t, x, active_proximity_pairs) +
+         EvaluateControlCosts(t, us);
+}
+
+float PlayerCost::Evaluate(
+    Time t, const VectorXf& x, const std::vector<VectorXf>& us,
+    float activity_margin, std::vector<bool>* activity,
+    const std::vector<bool>* active_proximity_pairs) const {
+  CHECK_NOTNULL(activity);
+  return EvaluateStateCosts(t, x, active_proximity_pairs, activity_margin,
+                            activity) +
+         EvaluateControlCosts(t, us);
 }
 
 float PlayerCost::Evaluate(const OperatingPoint& op, Time time_step) const {
@@ -133,15 +186,43 @@ float PlayerCost::Evaluate(const OperatingPoint& op, Time time_step) const {
   return cost;
 }
 
-float PlayerCost::EvaluateOffset(Time t, Time next_t, const VectorXf& next_x,
-                                 const std::vector<VectorXf>& us) const {
+float PlayerCost::EvaluateOffset(
+    Time t, Time next_t, const VectorXf& next_x,
+    const std::vector<VectorXf>& us,
+    const std::vector<bool>* active_proximity_pairs) const {
+  return EvaluateStateCosts(next_t, next_x, active_proximity_pairs) +
+         EvaluateControlCosts(t, us);
+}
+
+float PlayerCost::EvaluateStateCosts(
+    Time t, const VectorXf& x, const std::vector<bool>* active_proximity_pairs,
+    float activity_margin, std::vector<bool>* activity) const {
+  const Polyline2QueryCache::Scope scope(&polyline2_query_cache_);
+
+  // Skip proximity costs for far-apart positions. Only compiled costs are
+  // registered with a broad-phase.
+  if (is_compiled_) {
+    return compiled_state_costs_.Evaluate(t, x, active_proximity_pairs,
+                                          activity_margin, activity);
+  }
+
+  if (activity) activity->clear();
+
   float total_cost = 0.0;
+  for (const auto& cost : state_costs_) total_cost += cost->Evaluate(t, x);
+
+  return total_cost;
+}
 
-  // State costs.
-  for (const auto& cost : state_costs_)
-    total_cost += cost->Evaluate(next_t, next_x);
+float PlayerCost::EvaluateControlCosts(Time t,
+                                       const std::vector<VectorXf>& us) const {
+  float total_cost = 0.0;
+  if (is_compiled_) {
+    for (const auto& pair : compiled_control_costs_)
+      total_cost += pair.second.Evaluate(t, us[pair.first]);
+    return total_cost;
+  }
 
-  // Control costs.
   for (const auto& pair : control_costs_) {
     const PlayerIndex& player = pair.first;
     const auto& cost = pair.second;
@@ -152,15 +233,35 @@ float PlayerCost::EvaluateOffset(Time t, Time next_t, const VectorXf& next_x,
 }
 
 QuadraticCostApproximation PlayerCost::Quadraticize(
-    Time t, const VectorXf& x, const std::vector<VectorXf>& us) const {
+    Time t, const VectorXf& x, const std::vector<VectorXf>& us,
+    const std::vector<bool>* activity,
+    const std::vector<bool>* active_proximity_pairs) const {
+  const Polyline2QueryCache::Scope scope(&polyline2_query_cache_);
   QuadraticCostApproximation q(x.size(), state_regularization_);
 
-  // Accumulate state costs.
-  for (const auto& cost : state_costs_)
-    cost->Quadraticize(t, x, &q.state.hess, &q.state.grad);
+  // Accumulate state costs, skipping inactive terms if we have a mask, and
+  // otherwise skipping proximity costs for far-apart positions.
+  if (is_compiled_) {
+    const bool has_activity = activity && !activity->empty();
+    compiled_state_costs_.Quadraticize(t, x, active_proximity_pairs,
+                                       &q.state.hess, &q.state.grad,
+                                       (has_activity) ? activity : nullptr);
+  } else {
+    for (const auto& cost : state_costs_)
+      cost->Quadraticize(t, x, &q.state.hess, &q.state.grad);
+  }
 
   // Accumulate control costs.
-  AccumulateControlCosts(control_costs_, t, us, control_regularization_, &q);
+  if (is_compiled_) {
+    for (const auto& pair : compiled_control_costs_) {
+      SingleCostApproximation& control = FindOrAddControlApproximation(
+          pair.first, us, control_regularization_, &q);
+      pair.second.Quadraticize(t, us[pair.first], nullptr, &control.hess,
+                               &control.grad);
+    }
+  } else {
+    AccumulateControlCosts(control_costs_, t, us, control_regularization_, &q);
+  }
 
   // Accumulate state and control constraint barriers.
   // NOTE: these are *not* considered when evaluating costs, since the barriers
@@ -175,6 +276,7 @@ QuadraticCostApproximation PlayerCost::Quadraticize(
 }
 
 bool PlayerCost::CheckConstraints(Time t, const VectorXf& x) const {
+  const Polyline2QueryCache::Scope scope(&polyline2_query_cache_);
   for (const auto& constraint : state_constraints_) {
     if (!constraint->IsSatisfied(t, x)) return false;
   }
@@ -198,4 +300,13 @@ void PlayerCost::ResetConstraintBarrierWeights() {
   for (auto& pair : control_constraints_) pair.second->SetBarrierWeight(1.0);
 }
 
+void PlayerCost::Precompute(size_t num_time_steps) {
+  for (auto& cost : state_costs_) cost->Precompute(num_time_steps);
+  for (auto& pair : control_costs_) pair.second->Precompute(num_time_steps);
+  for (auto& constraint : state_constraints_)
+    constraint->Precompute(num_time_steps);
+  for (auto& pair : control_constraints_)
+    pair.second->Precompute(num_time_steps);
+}
+
 }  // namespace ilqgames
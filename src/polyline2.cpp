@@ -45,10 +45,43 @@
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <array>
+#include <atomic>
+#include <utility>
+#include <vector>
 
 namespace ilqgames {
 
-Polyline2::Polyline2(const PointList2& points) : length_(0.0) {
+namespace {
+
+// Maximum depth of the tree of bounding boxes, which is more than enough for
+// any polyline that fits in memory.
+static constexpr size_t kMaxTreeDepth = 64;
+
+// Closest segment found so far during a search, and the corresponding squared
+// distance. Ties are broken in favor of the lower index so that results do not
+// depend upon the order in which segments are visited.
+struct ClosestSegment {
+  size_t idx;
+  float squared_distance;
+
+  explicit ClosestSegment(size_t invalid_idx)
+      : idx(invalid_idx), squared_distance(constants::kInfinity) {}
+
+  void Update(size_t candidate_idx, float candidate_squared_distance) {
+    if (candidate_squared_distance < squared_distance ||
+        (candidate_squared_distance == squared_distance &&
+         candidate_idx < idx)) {
+      idx = candidate_idx;
+      squared_distance = candidate_squared_distance;
+    }
+  }
+};  // struct ClosestSegment
+
+}  // anonymous namespace
+
+Polyline2::Polyline2(const PointList2& points)
+    : length_(0.0), id_(NewId()) {
   CHECK_GT(points.size(), 1);
   cumulative_lengths_.push_back(length_);
 
@@ -58,11 +91,65 @@ Polyline2::Polyline2(const PointList2& points) : length_(0.0) {
     length_ += segments_.back().Length();
     cumulative_lengths_.push_back(length_);
   }
+
+  ComputeBoundingBoxes();
 }
 
 void Polyline2::AddPoint(const Point2& point) {
   segments_.emplace_back(segments_.back().SecondPoint(), point);
   length_ += segments_.back().Length();
+  cumulative_lengths_.push_back(length_);
+  id_ = NewId();
+
+  ComputeBoundingBoxes();
+}
+
+size_t Polyline2::NewId() {
+  static std::atomic<size_t> next_id(0);
+  return next_id++;
+}
+
+void Polyline2::ComputeBoundingBoxes() {
+  const size_t num_segments = segments_.size();
+  bounding_boxes_.resize(2 * num_segments);
+
+  // Leaves bound individual segments. Pad them a little so that lower bounds
+  // remain conservative in the presence of floating point error.
+  const Point2 padding = Point2::Constant(constants::kSmallNumber);
+  for (size_t ii = 0; ii < num_segments; ii++) {
+    Eigen::AlignedBox2f& box = bounding_boxes_[num_segments + ii];
+    box.setEmpty();
+    box.extend(segments_[ii].FirstPoint());
+    box.extend(segments_[ii].SecondPoint());
+    box.min() -= padding;
+    box.max() += padding;
+  }
+
+  // Each internal node bounds its two children.
+  for (size_t ii = num_segments - 1; ii > 0; ii--) {
+    bounding_boxes_[ii] =
+        bounding_boxes_[2 * ii].merged(bounding_boxes_[2 * ii + 1]);
+  }
+}
+
+float Polyline2::SquaredDistanceLowerBound(const Point2& query, size_t first,
+                                           size_t last) const {
+  // Walk up the tree from both ends of the range, only considering nodes
+  // which are entirely contained in the range.
+  float bound = constants::kInfinity;
+  for (first += segments_.size(), last += segments_.size(); first < last;
+       first /= 2, last /= 2) {
+    if (first & 1) {
+      bound = std::min(
+          bound, bounding_boxes_[first++].squaredExteriorDistance(query));
+    }
+    if (last & 1) {
+      bound = std::min(bound,
+                       bounding_boxes_[--last].squaredExteriorDistance(query));
+    }
+  }
+
+  return bound;
 }
 
 Point2 Polyline2::PointAt(float route_pos, bool* is_vertex,
@@ -105,35 +192,121 @@ Point2 Polyline2::PointAt(float route_pos, bool* is_vertex,
 Point2 Polyline2::ClosestPoint(const Point2& query, bool* is_vertex,
                                LineSegment2* segment,
                                float* signed_squared_distance,
-                               bool* is_endpoint) const {
-  // Walk along each line segment and remember which was closest.
-  float closest_signed_squared_distance = constants::kInfinity;
-  Point2 closest_point;
-
-  float current_signed_squared_distance;
-  int segment_ind = 0;
-  int segment_counter = 0;
-  for (const auto& s : segments_) {
-    bool is_segment_endpoint;
-    const Point2 current_point = s.ClosestPoint(
-        query, &is_segment_endpoint, &current_signed_squared_distance);
-
-    if (std::abs(current_signed_squared_distance) <
-        std::abs(closest_signed_squared_distance)) {
-      closest_signed_squared_distance = current_signed_squared_distance;
-      closest_point = current_point;
-
-      if (is_vertex) *is_vertex = is_segment_endpoint;
-      if (segment) *segment = s;
-      segment_ind = segment_counter;
+                               bool* is_endpoint, size_t* segment_idx) const {
+  const size_t idx = ClosestSegmentIndex(query);
+  if (segment_idx) *segment_idx = idx;
+
+  return ClosestPointOnSegment(query, idx, is_vertex, segment,
+                               signed_squared_distance, is_endpoint);
+}
+
+Point2 Polyline2::ClosestPointWithHint(const Point2& query,
+                                       size_t* segment_hint, bool* is_vertex,
+                                       LineSegment2* segment,
+                                       float* signed_squared_distance,
+                                       bool* is_endpoint) const {
+  CHECK_NOTNULL(segment_hint);
+
+  *segment_hint = ClosestSegmentIndex(query, *segment_hint);
+  return ClosestPointOnSegment(query, *segment_hint, is_vertex, segment,
+                               signed_squared_distance, is_endpoint);
+}
+
+size_t Polyline2::ClosestSegmentIndex(const Point2& query) const {
+  const size_t num_segments = segments_.size();
+  ClosestSegment closest(num_segments);
+
+  // Depth-first branch and bound through the tree of bounding boxes, starting
+  // at the root and visiting the nearer child first. Skip any subtree whose
+  // bounding box is farther away than the closest segment found so far.
+  // NOTE: the stack never holds more than one entry per level of the tree.
+  std::array<std::pair<size_t, float>, kMaxTreeDepth> stack;
+  size_t stack_size = 0;
+  stack[stack_size++] = {1, bounding_boxes_[1].squaredExteriorDistance(query)};
+  while (stack_size > 0) {
+    const size_t node = stack[--stack_size].first;
+    const float node_squared_distance = stack[stack_size].second;
+
+    if (node_squared_distance > closest.squared_distance) continue;
+
+    // Leaves correspond to individual segments.
+    if (node >= num_segments) {
+      const size_t idx = node - num_segments;
+      closest.Update(idx, SquaredDistance(query, idx));
+      continue;
+    }
+
+    // Push the farther child first so that the nearer one is popped first.
+    const size_t left = 2 * node;
+    const size_t right = 2 * node + 1;
+    const float left_squared_distance =
+        bounding_boxes_[left].squaredExteriorDistance(query);
+    const float right_squared_distance =
+        bounding_boxes_[right].squaredExteriorDistance(query);
+    if (left_squared_distance < right_squared_distance) {
+      stack[stack_size++] = {right, right_squared_distance};
+      stack[stack_size++] = {left, left_squared_distance};
+    } else {
+      stack[stack_size++] = {left, left_squared_distance};
+      stack[stack_size++] = {right, right_squared_distance};
+    }
+  }
+
+  return closest.idx;
+}
+
+size_t Polyline2::ClosestSegmentIndex(const Point2& query,
+                                      size_t segment_hint) const {
+  const size_t num_segments = segments_.size();
+  ClosestSegment closest(num_segments);
+
+  // Start at the hint and grow the searched range [first, last) outward,
+  // doubling the number of new segments on each side every time. Stop once
+  // bounding boxes show that no segment outside the range can be closer.
+  const size_t hint = std::min(segment_hint, num_segments - 1);
+  closest.Update(hint, SquaredDistance(query, hint));
+
+  size_t first = hint;
+  size_t last = hint + 1;
+  for (size_t step = 1; first > 0 || last < num_segments; step *= 2) {
+    const bool is_done_before = SquaredDistanceLowerBound(query, 0, first) >
+                                closest.squared_distance;
+    const bool is_done_after =
+        SquaredDistanceLowerBound(query, last, num_segments) >
+        closest.squared_distance;
+    if (is_done_before && is_done_after) break;
+
+    if (!is_done_before) {
+      const size_t new_first = (first > step) ? first - step : 0;
+      for (size_t ii = new_first; ii < first; ii++)
+        closest.Update(ii, SquaredDistance(query, ii));
+      first = new_first;
     }
 
-    segment_counter++;
+    if (!is_done_after) {
+      const size_t new_last = std::min(last + step, num_segments);
+      for (size_t ii = last; ii < new_last; ii++)
+        closest.Update(ii, SquaredDistance(query, ii));
+      last = new_last;
+    }
   }
 
-  // Maybe set signed_squared_distance.
-  if (signed_squared_distance)
-    *signed_squared_distance = closest_signed_squared_distance;
+  return closest.idx;
+}
+
+float Polyline2::SquaredDistance(const Point2& query, size_t idx) const {
+  float signed_squared_distance;
+  segments_[idx].ClosestPoint(query, nullptr, &signed_squared_distance);
+  return std::abs(signed_squared_distance);
+}
+
+Point2 Polyline2::ClosestPointOnSegment(const Point2& query, size_t idx,
+                                        bool* is_vertex, LineSegment2* segment,
+                                        float* signed_squared_distance,
+                                        bool* is_endpoint) const {
+  const Point2 closest_point =
+      segments_[idx].ClosestPoint(query, is_vertex, signed_squared_distance);
+  if (segment) *segment = segments_[idx];
 
   // Check if the closest point occurs at an endpoint for the polyline.
   if (is_endpoint) {
@@ -147,6 +320,6 @@ Point2 Polyline2::ClosestPoint(const Point2& query, bool* is_vertex,
   }
 
   return closest_point;
-}  // namespace ilqgames
+}
 
 }  // namespace ilqgames
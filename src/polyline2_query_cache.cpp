@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Cache of closest point queries on Polyline2s, indexed by polyline, the input
+// dimensions corresponding to (x, y)-position, and time step.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
+#include <ilqgames/utils/types.h>
+
+#include <tuple>
+#include <vector>
+
+namespace ilqgames {
+
+thread_local Polyline2QueryCache* Polyline2QueryCache::in_scope_ = nullptr;
+
+Polyline2QueryCache::ClosestPointQuery Polyline2QueryCache::ClosestPoint(
+    const Polyline2& polyline, Dimension xidx, Dimension yidx,
+    size_t time_index, const Point2& query) {
+  auto& queries = queries_[std::make_tuple(polyline.Id(), xidx, yidx)];
+  if (time_index >= queries.size()) queries.resize(time_index + 1);
+
+  // Reuse the last query at this time step if it came from the same position.
+  ClosestPointQuery& cached = queries[time_index];
+  if (cached.is_valid && cached.query == query) return cached;
+
+  // Otherwise, warm start from the last closest segment at this time step.
+  cached.closest_point = polyline.ClosestPointWithHint(
+      query, &cached.segment_idx, &cached.is_vertex, nullptr,
+      &cached.signed_squared_distance, &cached.is_endpoint);
+  cached.query = query;
+  cached.is_valid = true;
+
+  return cached;
+}
+
+Polyline2QueryCache::ClosestPointQuery Polyline2QueryCache::ClosestPointInScope(
+    const Polyline2& polyline, Dimension xidx, Dimension yidx,
+    size_t time_index, const Point2& query) {
+  if (in_scope_)
+    return in_scope_->ClosestPoint(polyline, xidx, yidx, time_index, query);
+
+  // Without a cache, there is no hint, so search the whole tree of bounding
+  // boxes. Results are identical.
+  ClosestPointQuery result;
+  result.closest_point = polyline.ClosestPoint(
+      query, &result.is_vertex, nullptr, &result.signed_squared_distance,
+      &result.is_endpoint, &result.segment_idx);
+  result.query = query;
+  result.is_valid = true;
+
+  return result;
+}
+
+}  // namespace ilqgames
@@ -44,6 +44,7 @@
 
 #include <ilqgames/constraint/polyline2_signed_distance_constraint.h>
 #include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
 #include <ilqgames/utils/types.h>
 
 #include <string>
@@ -51,15 +52,15 @@
 
 namespace ilqgames {
 
-bool Polyline2SignedDistanceConstraint::IsSatisfied(const VectorXf& input,
+bool Polyline2SignedDistanceConstraint::IsSatisfied(Time t,
+                                                    const VectorXf& input,
                                                     float* level) const {
   CHECK_LT(xidx_, input.size());
   CHECK_LT(yidx_, input.size());
 
   // Compute signed squared distance by finding closest point.
-  float signed_distance_sq;
-  polyline_.ClosestPoint(Point2(input(xidx_), input(yidx_)), nullptr, nullptr,
-                         &signed_distance_sq);
+  const float signed_distance_sq =
+      ClosestPoint(t, input).signed_squared_distance;
 
   // Maybe set level.
   const float sign = (oriented_right_) ? 1.0 : -1.0;
@@ -69,7 +70,8 @@ bool Polyline2SignedDistanceConstraint::IsSatisfied(const VectorXf& input,
                            : signed_distance_sq < signed_threshold_sq_;
 }
 
-void Polyline2SignedDistanceConstraint::Quadraticize(const VectorXf& input,
+void Polyline2SignedDistanceConstraint::Quadraticize(Time t,
+                                                     const VectorXf& input,
                                                      MatrixXf* hess,
                                                      VectorXf* grad) const {
   CHECK_LT(xidx_, input.size());
@@ -84,13 +86,11 @@ void Polyline2SignedDistanceConstraint::Quadraticize(const VectorXf& input,
   // Unpack current position and find closest point / segment.
   const Point2 current_position(input(xidx_), input(yidx_));
 
-  float signed_distance_sq;
-  bool is_vertex;
-  bool is_endpoint;
-  LineSegment2 segment(Point2(0.0, 0.0), Point2(1.0, 1.0));
-  const Point2 closest_point =
-      polyline_.ClosestPoint(current_position, &is_vertex, &segment,
-                             &signed_distance_sq, &is_endpoint);
+  const auto closest = ClosestPoint(t, input);
+  const float signed_distance_sq = closest.signed_squared_distance;
+  const bool is_vertex = closest.is_vertex;
+  const LineSegment2& segment = polyline_.Segments()[closest.segment_idx];
+  const Point2 closest_point = closest.closest_point;
 
   // Sign corresponding to orientation of this constraint and of the signed
   // distance itself.
@@ -41,20 +41,85 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/cost/cost.h>
+#include <ilqgames/dynamics/integrator.h>
+#include <ilqgames/dynamics/multi_player_integrable_system.h>
 #include <ilqgames/solver/game_solver.h>
 #include <ilqgames/solver/problem.h>
+#include <ilqgames/solver/solution_splicer.h>
+#include <ilqgames/solver/solver_params.h>
+#include <ilqgames/utils/cancellation_token.h>
 #include <ilqgames/utils/solver_log.h>
 #include <ilqgames/utils/strategy.h>
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
 #include <algorithm>
+#include <future>
 #include <memory>
 #include <vector>
 
 namespace ilqgames {
 
-std::shared_ptr<SolverLog> Problem::Solve(Time max_runtime) {
+namespace {
+
+// Find the index of the state among time steps [begin, end) nearest to x,
+// evaluating the distance metric once per state, and record that distance.
+// States are read through the given accessor, i.e., state(kk) is the state at
+// time step kk.
+template <typename StateAccessor>
+size_t NearestTimeStep(const MultiPlayerIntegrableSystem& dynamics,
+                       const StateAccessor& state, const VectorXf& x,
+                       size_t begin, size_t end, float* distance) {
+  CHECK_LT(begin, end);
+
+  size_t nearest_timestep = begin;
+  *distance = dynamics.DistanceBetween(x, state(begin));
+  for (size_t kk = begin + 1; kk < end; kk++) {
+    const float distance_kk = dynamics.DistanceBetween(x, state(kk));
+    if (distance_kk < *distance) {
+      *distance = distance_kk;
+      nearest_timestep = kk;
+    }
+  }
+
+  return nearest_timestep;
+}
+
+// Find the index of the state among the given number of time steps nearest to
+// x. Elapsed time tells us which time step that should be, so first search a
+// window around that time step, and only search all time steps if no state in
+// the window is close enough.
+template <typename StateAccessor>
+size_t NearestTimeStep(const MultiPlayerIntegrableSystem& dynamics,
+                       const SolverParams& params, const StateAccessor& state,
+                       size_t num_time_steps, size_t expected_timestep,
+                       const VectorXf& x) {
+  CHECK_LT(expected_timestep, num_time_steps);
+
+  const size_t window_begin =
+      (expected_timestep < params.nearest_state_search_radius)
+          ? 0
+          : expected_timestep - params.nearest_state_search_radius;
+  const size_t window_end =
+      std::min(num_time_steps,
+               expected_timestep + params.nearest_state_search_radius + 1);
+
+  float nearest_distance;
+  const size_t nearest_timestep = NearestTimeStep(
+      dynamics, state, x, window_begin, window_end, &nearest_distance);
+  if (nearest_distance <= params.nearest_state_distance_threshold)
+    return nearest_timestep;
+
+  return NearestTimeStep(dynamics, state, x, 0, num_time_steps,
+                         &nearest_distance);
+}
+
+}  // anonymous namespace
+
+std::shared_ptr<SolverLog> Problem::Solve(
+    Time max_runtime, const CancellationToken* cancellation_token,
+    const GameSolver::ProgressCallback& progress_callback) {
   CHECK_NOTNULL(solver_.get());
   CHECK_NOTNULL(strategies_.get());
   CHECK_NOTNULL(operating_point_.get());
@@ -67,15 +132,21 @@ std::shared_ptr<SolverLog> Problem::Solve(Time max_runtime) {
   std::vector<Strategy> final_strategies(*strategies_);
   if (!solver_->Solve(x0_, *operating_point_, *strategies_,
                       &final_operating_point, &final_strategies, log.get(),
-                      max_runtime)) {
-    LOG(WARNING) << "Solver failed. Not updating operating point and "
-                    "strategies to failed solution.";
+                      max_runtime, cancellation_token, progress_callback)) {
+    if (solver_->Statistics().was_cancelled) {
+      LOG(INFO) << "Solver cancelled. Not updating operating point and "
+                   "strategies to partial solution.";
+    } else {
+      LOG(WARNING) << "Solver failed. Not updating operating point and "
+                      "strategies to failed solution.";
+    }
     return log;
   }
 
   // Store these new strategies/operating point.
   strategies_->swap(final_strategies);
   operating_point_->swap(final_operating_point);
+  solution_log_ = log;
 
   CHECK_LT((x0_ - operating_point_->xs[0]).cwiseAbs().maxCoeff(),
            constants::kSmallNumber);
@@ -84,25 +155,198 @@ std::shared_ptr<SolverLog> Problem::Solve(Time max_runtime) {
   return log;
 }
 
+std::future<std::shared_ptr<SolverLog>> Problem::SolveAsync(
+    Time max_runtime,
+    const std::shared_ptr<const CancellationToken>& cancellation_token,
+    const GameSolver::ProgressCallback& progress_callback) {
+  // Capture the token by value to keep it alive for the duration of the solve.
+  return std::async(std::launch::async, [this, max_runtime, cancellation_token,
+                                         progress_callback]() {
+    return this->Solve(max_runtime, cancellation_token.get(),
+                       progress_callback);
+  });
+}
+
 void Problem::SetUpNextRecedingHorizon(const VectorXf& x0, Time t0,
                                        Time planner_runtime) {
   CHECK_NOTNULL(strategies_.get());
   CHECK_NOTNULL(operating_point_.get());
-  CHECK_GE(planner_runtime, 0.0);
-  CHECK_LE(
-      planner_runtime + t0,
-      operating_point_->t0 + solver_->TimeStep() * operating_point_->xs.size());
-  CHECK_GE(t0, operating_point_->t0);
   CHECK_GE(operating_point_->xs.size(), solver_->NumTimeSteps());
 
   const MultiPlayerIntegrableSystem& dynamics = solver_->Dynamics();
+  const SolverParams& params = solver_->Params();
+  num_time_steps_written_ = 0;
+  solution_log_.reset();
 
   // Integrate x0 forward from t0 by approximately planner_runtime to get
-  // actual initial state. Integrate up to the next discrete timestep, then
-  // integrate for an integer number of discrete timesteps until by the *next*
-  // timestep at least 'planner_runtime' has elapsed (done by rounding).
+  // actual initial state, copying time steps out of the existing plan.
+  const auto copy_time_steps = [this](size_t first_timestep,
+                                      size_t num_time_steps,
+                                      OperatingPoint* operating_point,
+                                      std::vector<Strategy>* strategies) {
+    operating_point->t0 =
+        operating_point_->t0 + first_timestep * solver_->TimeStep();
+    for (size_t kk = 0; kk < num_time_steps; kk++) {
+      operating_point->xs[kk] = operating_point_->xs[first_timestep + kk];
+      operating_point->us[kk] = operating_point_->us[first_timestep + kk];
+      for (PlayerIndex ii = 0; ii < strategies->size(); ii++) {
+        (*strategies)[ii].Ps[kk] = (*strategies_)[ii].Ps[first_timestep + kk];
+        (*strategies)[ii].alphas[kk] =
+            (*strategies_)[ii].alphas[first_timestep + kk];
+      }
+    }
+  };  // copy_time_steps
+
+  Time new_t0;
+  const VectorXf x = IntegrateThroughPlannerRuntime(
+      x0, t0, planner_runtime, operating_point_->t0,
+      operating_point_->xs.size(), copy_time_steps, &new_t0);
+
+  // Find index of nearest state in the existing plan to this state.
+  const size_t num_existing_timesteps = operating_point_->xs.size();
+  const size_t expected_timestep = std::min(
+      num_existing_timesteps - 1,
+      static_cast<size_t>(
+          constants::kSmallNumber +  // Add to avoid truncation error.
+          (new_t0 - operating_point_->t0) / solver_->TimeStep()));
+  const auto state = [this](size_t kk) -> const VectorXf& {
+    return operating_point_->xs[kk];
+  };  // state
+  const size_t first_timestep_in_new_problem =
+      NearestTimeStep(dynamics, params, state, num_existing_timesteps,
+                      expected_timestep, x);
+
+  // Set initial state to this state.
+  x0_ = dynamics.Stitch(state(first_timestep_in_new_problem), x);
+
+  // Update all costs to have the correct initial time.
+  operating_point_->t0 = new_t0;
+  Cost::ResetInitialTime(operating_point_->t0);
+
+  // Shift the remainder of the existing plan to the front, and extend it to
+  // the full horizon.
+  const size_t num_kept_timesteps =
+      std::min(solver_->NumTimeSteps(),
+               num_existing_timesteps - first_timestep_in_new_problem);
+  ShiftSolution(first_timestep_in_new_problem, num_kept_timesteps);
+  ExtendSolution(num_kept_timesteps, SolverIntegrator());
+
+  // Invariants.
+  CHECK_EQ(operating_point_->xs.size(), solver_->NumTimeSteps());
+  CHECK_LE(std::abs(t0 + planner_runtime - operating_point_->t0),
+           solver_->TimeStep());
+}
+
+void Problem::SetUpNextRecedingHorizon(const SolutionSplicer& splicer,
+                                       const VectorXf& x0, Time t0,
+                                       Time planner_runtime) {
+  CHECK_NOTNULL(strategies_.get());
+  CHECK_NOTNULL(operating_point_.get());
+  CHECK_GE(splicer.NumTimeSteps(), solver_->NumTimeSteps());
+  CHECK_GE(operating_point_->xs.size(), solver_->NumTimeSteps());
+
+  const MultiPlayerIntegrableSystem& dynamics = solver_->Dynamics();
+  const SolverParams& params = solver_->Params();
+  num_time_steps_written_ = 0;
+
+  // Integrate x0 forward from t0 by approximately planner_runtime, exactly as
+  // above, copying time steps out of the splicer.
+  const auto copy_time_steps = [&splicer](size_t first_timestep,
+                                          size_t num_time_steps,
+                                          OperatingPoint* operating_point,
+                                          std::vector<Strategy>* strategies) {
+    splicer.CopyTimeSteps(first_timestep, num_time_steps, operating_point,
+                          strategies);
+  };  // copy_time_steps
+
+  Time new_t0;
+  const VectorXf x = IntegrateThroughPlannerRuntime(
+      x0, t0, planner_runtime, splicer.InitialTime(), splicer.NumTimeSteps(),
+      copy_time_steps, &new_t0);
+
+  // Find index of nearest state in the spliced plan to this state, reading
+  // states directly from the splicer.
+  const size_t expected_timestep = std::min(
+      splicer.NumTimeSteps() - 1,
+      static_cast<size_t>(
+          constants::kSmallNumber +  // Add to avoid truncation error.
+          (new_t0 - splicer.InitialTime()) / solver_->TimeStep()));
+  const auto state = [&splicer](size_t kk) -> const VectorXf& {
+    return splicer.State(kk);
+  };  // state
+  const size_t first_timestep_in_new_problem =
+      NearestTimeStep(dynamics, params, state, splicer.NumTimeSteps(),
+                      expected_timestep, x);
+
+  // Set initial state to this state, and update all costs to have the correct
+  // initial time.
+  x0_ = dynamics.Stitch(splicer.State(first_timestep_in_new_problem), x);
+  Cost::ResetInitialTime(new_t0);
+
+  // If this problem's solution was spliced in last, then it makes up the
+  // spliced plan from its initial time onward, so shift the remainder of it to
+  // the front rather than copying it out of the splicer.
+  const size_t num_existing_timesteps =
+      std::min(solver_->NumTimeSteps(),
+               splicer.NumTimeSteps() - first_timestep_in_new_problem);
+  size_t num_kept_timesteps = 0;
+  if (solution_log_ && splicer.LastSplicedLog() == solution_log_ &&
+      std::abs(operating_point_->t0 -
+               solution_log_->FinalOperatingPoint().t0) <
+          constants::kSmallNumber) {
+    const size_t solution_timestep = static_cast<size_t>(
+        constants::kSmallNumber +  // Add to avoid truncation error.
+        (operating_point_->t0 - splicer.InitialTime()) / solver_->TimeStep());
+    if (first_timestep_in_new_problem >= solution_timestep) {
+      const size_t num_elapsed_timesteps =
+          first_timestep_in_new_problem - solution_timestep;
+      CHECK_LT(num_elapsed_timesteps, operating_point_->xs.size());
+
+      num_kept_timesteps =
+          std::min(num_existing_timesteps,
+                   operating_point_->xs.size() - num_elapsed_timesteps);
+      ShiftSolution(num_elapsed_timesteps, num_kept_timesteps);
+    }
+  }
+
+  solution_log_.reset();
+  TruncateSolution();
+
+  // Copy the rest of the spliced plan into place, and extend it to the full
+  // horizon.
+  for (size_t kk = num_kept_timesteps; kk < num_existing_timesteps; kk++) {
+    splicer.CopyTimeStep(first_timestep_in_new_problem + kk, kk,
+                         operating_point_.get(), strategies_.get());
+  }
+  num_time_steps_written_ += num_existing_timesteps - num_kept_timesteps;
+
+  operating_point_->t0 = new_t0;
+  ExtendSolution(num_existing_timesteps, SolverIntegrator());
+
+  // Invariants.
+  CHECK_EQ(operating_point_->xs.size(), solver_->NumTimeSteps());
+  CHECK_LE(std::abs(t0 + planner_runtime - operating_point_->t0),
+           solver_->TimeStep());
+}
+
+VectorXf Problem::IntegrateThroughPlannerRuntime(
+    const VectorXf& x0, Time t0, Time planner_runtime, Time plan_t0,
+    size_t plan_num_time_steps, const CopyTimeStepsFunction& copy_time_steps,
+    Time* new_t0) {
+  CHECK_NOTNULL(new_t0);
+  CHECK_GE(planner_runtime, 0.0);
+  CHECK_GE(t0, plan_t0);
+  CHECK_LE(planner_runtime + t0,
+           plan_t0 + solver_->TimeStep() * plan_num_time_steps);
+
+  const MultiPlayerIntegrableSystem& dynamics = solver_->Dynamics();
+  Integrator* integrator = SolverIntegrator();
+
+  // Integrate up to the next discrete timestep, then integrate for an integer
+  // number of discrete timesteps until by the *next* timestep at least
+  // 'planner_runtime' has elapsed (done by rounding).
   constexpr float kRoundingError = 0.9;
-  const Time relative_t0 = t0 - operating_point_->t0;
+  const Time relative_t0 = t0 - plan_t0;
   size_t current_timestep =
       static_cast<size_t>(relative_t0 / solver_->TimeStep());
   Time remaining_time_this_step =
@@ -114,81 +358,69 @@ void Problem::SetUpNextRecedingHorizon(const VectorXf& x0, Time t0,
 
   CHECK_LT(remaining_time_this_step, solver_->TimeStep());
 
-  // Initially, set x to the integrated version of x0 at the next timestep.
-  VectorXf x =
-      dynamics.IntegrateToNextTimeStep(t0, x0, *operating_point_, *strategies_);
-  operating_point_->t0 = t0 + remaining_time_this_step;
-  if (remaining_time_this_step <= planner_runtime) {
-    const size_t num_steps_to_integrate = static_cast<size_t>(
-        constants::kSmallNumber +  // Add to avoid truncation error.
-        (planner_runtime - remaining_time_this_step) / solver_->TimeStep());
-    const size_t last_integration_timestep =
-        current_timestep + num_steps_to_integrate;
+  const size_t num_steps_to_integrate =
+      (remaining_time_this_step <= planner_runtime)
+          ? static_cast<size_t>(
+                constants::kSmallNumber +  // Add to avoid truncation error.
+                (planner_runtime - remaining_time_this_step) /
+                    solver_->TimeStep())
+          : 0;
+  const size_t last_integration_timestep =
+      current_timestep + num_steps_to_integrate;
 
-    x = dynamics.Integrate(current_timestep + 1, last_integration_timestep, x,
-                           *operating_point_, *strategies_);
-    operating_point_->t0 += solver_->TimeStep() * num_steps_to_integrate;
+  // Only copy the time steps spanned by this integration, starting one early
+  // in case of rounding and ending one late for interpolation.
+  const size_t window_begin =
+      (relative_t0 < solver_->TimeStep())
+          ? 0
+          : static_cast<size_t>(relative_t0 / solver_->TimeStep()) - 1;
+  const size_t window_end =
+      std::min(plan_num_time_steps, last_integration_timestep + 2);
+  const size_t window_size = window_end - window_begin;
+  if (!window_operating_point_) {
+    window_operating_point_.reset(
+        new OperatingPoint(0, dynamics.NumPlayers(), plan_t0));
+    for (PlayerIndex ii = 0; ii < dynamics.NumPlayers(); ii++)
+      window_strategies_.emplace_back(0, dynamics.XDim(), dynamics.UDim(ii));
   }
 
-  // Find index of nearest state in the existing plan to this state.
-  const auto nearest_iter =
-      std::min_element(operating_point_->xs.begin(), operating_point_->xs.end(),
-                       [&dynamics, &x](const VectorXf& x1, const VectorXf& x2) {
-                         return dynamics.DistanceBetween(x, x1) <
-                                dynamics.DistanceBetween(x, x2);
-                       });
-
-  // Set initial time to first timestamp in new problem.
-  const size_t first_timestep_in_new_problem =
-      std::distance(operating_point_->xs.begin(), nearest_iter);
-
-  // Set initial state to this state.
-  x0_ = dynamics.Stitch(*nearest_iter, x);
-  //  x0_ = *nearest_iter;
-
-  // Update all costs to have the correct initial time.
-  Cost::ResetInitialTime(operating_point_->t0);
+  window_operating_point_->xs.resize(window_size);
+  window_operating_point_->us.resize(window_size);
+  for (auto& strategy : window_strategies_) {
+    strategy.Ps.resize(window_size);
+    strategy.alphas.resize(window_size);
+  }
 
-  // Set final timestep to consider in current operating point.
-  const size_t after_final_timestep =
-      first_timestep_in_new_problem + solver_->NumTimeSteps();
-  const size_t timestep_iterator_end =
-      std::min(after_final_timestep, operating_point_->xs.size());
+  copy_time_steps(window_begin, window_size, window_operating_point_.get(),
+                  &window_strategies_);
 
-  // Populate strategies and opeating point for the remainder of the
-  // existing plan, reusing the old operating point when possible.
-  for (size_t kk = first_timestep_in_new_problem; kk < timestep_iterator_end;
-       kk++) {
-    const size_t kk_new_problem = kk - first_timestep_in_new_problem;
+  VectorXf x = dynamics.IntegrateToNextTimeStep(
+      t0, x0, *window_operating_point_, window_strategies_, integrator);
+  if (num_steps_to_integrate > 0) {
+    x = dynamics.Integrate(current_timestep + 1 - window_begin,
+                           last_integration_timestep - window_begin, x,
+                           *window_operating_point_, window_strategies_,
+                           integrator);
+  }
 
-    // Set current state and controls in operating point.
-    operating_point_->xs[kk_new_problem].swap(operating_point_->xs[kk]);
-    operating_point_->us[kk_new_problem].swap(operating_point_->us[kk]);
-    CHECK_EQ(operating_point_->us[kk_new_problem].size(),
-             dynamics.NumPlayers());
+  *new_t0 = t0 + remaining_time_this_step +
+            solver_->TimeStep() * num_steps_to_integrate;
+  return x;
+}
 
-    // Set current stategy.
-    for (auto& strategy : *strategies_) {
-      strategy.Ps[kk_new_problem].swap(strategy.Ps[kk]);
-      strategy.alphas[kk_new_problem].swap(strategy.alphas[kk]);
-    }
-  }
+void Problem::ExtendSolution(size_t num_existing_timesteps,
+                             Integrator* integrator) {
+  CHECK_GT(num_existing_timesteps, 0);
+  const MultiPlayerIntegrableSystem& dynamics = solver_->Dynamics();
 
   // Make sure operating point is the right size.
   CHECK_GE(operating_point_->xs.size(), solver_->NumTimeSteps());
-  if (operating_point_->xs.size() > solver_->NumTimeSteps()) {
-    operating_point_->xs.resize(solver_->NumTimeSteps());
-    operating_point_->us.resize(solver_->NumTimeSteps());
-    for (PlayerIndex ii = 0; ii < dynamics.NumPlayers(); ii++) {
-      (*strategies_)[ii].Ps.resize(solver_->NumTimeSteps());
-      (*strategies_)[ii].alphas.resize(solver_->NumTimeSteps());
-    }
-  }
+  TruncateSolution();
 
   // Set new operating point controls and strategies to zero and propagate
   // state forward accordingly.
-  for (size_t kk = timestep_iterator_end - first_timestep_in_new_problem;
-       kk < solver_->NumTimeSteps(); kk++) {
+  for (size_t kk = num_existing_timesteps; kk < solver_->NumTimeSteps();
+       kk++) {
     operating_point_->us[kk].resize(dynamics.NumPlayers());
     for (size_t ii = 0; ii < dynamics.NumPlayers(); ii++) {
       (*strategies_)[ii].Ps[kk].setZero(dynamics.UDim(ii), dynamics.XDim());
@@ -199,13 +431,44 @@ void Problem::SetUpNextRecedingHorizon(const VectorXf& x0, Time t0,
     operating_point_->xs[kk] = dynamics.Integrate(
         operating_point_->t0 + solver_->ComputeTimeStamp(kk - 1),
         solver_->TimeStep(), operating_point_->xs[kk - 1],
-        operating_point_->us[kk - 1]);
+        operating_point_->us[kk - 1], integrator);
+    num_time_steps_written_++;
   }
+}
 
-  // Invariants.
-  CHECK_EQ(operating_point_->xs.size(), solver_->NumTimeSteps());
-  CHECK_LE(std::abs(t0 + planner_runtime - operating_point_->t0),
-           solver_->TimeStep());
+void Problem::TruncateSolution() {
+  if (operating_point_->xs.size() <= solver_->NumTimeSteps()) return;
+
+  operating_point_->xs.resize(solver_->NumTimeSteps());
+  operating_point_->us.resize(solver_->NumTimeSteps());
+  for (auto& strategy : *strategies_) {
+    strategy.Ps.resize(solver_->NumTimeSteps());
+    strategy.alphas.resize(solver_->NumTimeSteps());
+  }
+}
+
+void Problem::ShiftSolution(size_t first_timestep, size_t num_time_steps) {
+  CHECK_LE(first_timestep + num_time_steps, operating_point_->xs.size());
+  if (first_timestep == 0) return;
+
+  for (size_t kk = 0; kk < num_time_steps; kk++) {
+    operating_point_->xs[kk].swap(operating_point_->xs[first_timestep + kk]);
+    operating_point_->us[kk].swap(operating_point_->us[first_timestep + kk]);
+    for (auto& strategy : *strategies_) {
+      strategy.Ps[kk].swap(strategy.Ps[first_timestep + kk]);
+      strategy.alphas[kk].swap(strategy.alphas[first_timestep + kk]);
+    }
+  }
+}
+
+Integrator* Problem::SolverIntegrator() {
+  if (!integrator_) {
+    const SolverParams& params = solver_->Params();
+    integrator_.reset(new Integrator(params.integration_method,
+                                     params.num_integration_substeps));
+  }
+
+  return integrator_.get();
 }
 
 void Problem::OverwriteSolution(const OperatingPoint& operating_point,
@@ -215,6 +478,7 @@ void Problem::OverwriteSolution(const OperatingPoint& operating_point,
 
   *operating_point_ = operating_point;
   *strategies_ = strategies;
+  solution_log_.reset();
 }
 
 std::shared_ptr<SolverLog> Problem::CreateNewLog() const {
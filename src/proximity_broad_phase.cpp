@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Broad-phase for pairwise proximity terms. Positions are given by pairs of
+// input dimensions, and each registered pair of positions interacts only
+// within a given radius. Candidate pairs are found by sorting positions along
+// the x-axis and sweeping (i.e., sweep and prune), so that far-apart pairs are
+// never examined individually.
+//
+// A single broad-phase is meant to be shared by all players' costs, so that
+// active pairs are found once per state and pairs registered by several players
+// are only checked once. Sorting reuses preallocated buffers, so this class is
+// not thread-safe and each solver should own its own instance.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/geometry/proximity_broad_phase.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace ilqgames {
+
+size_t ProximityBroadPhase::AddPair(
+    const std::pair<Dimension, Dimension>& position_idxs1,
+    const std::pair<Dimension, Dimension>& position_idxs2, float radius) {
+  CHECK_GE(radius, 0.0);
+
+  size_t position1 = PositionIndex(position_idxs1);
+  size_t position2 = PositionIndex(position_idxs2);
+  if (position1 > position2) std::swap(position1, position2);
+
+  // Re-index the table of pairs between positions if new positions were added.
+  const size_t num_positions = positions_.size();
+  if (pairs_between_positions_.size() != num_positions * num_positions) {
+    std::vector<std::vector<size_t>> pairs_between_positions(num_positions *
+                                                             num_positions);
+    for (size_t ii = 0; ii < pairs_.size(); ii++) {
+      const Pair& pair = pairs_[ii];
+      pairs_between_positions[pair.position1 * num_positions + pair.position2]
+          .push_back(ii);
+    }
+
+    pairs_between_positions_.swap(pairs_between_positions);
+  }
+
+  // Reuse an identical pair if there is one.
+  auto& pairs_between =
+      pairs_between_positions_[position1 * num_positions + position2];
+  const float radius_sq = radius * radius;
+  for (size_t ii : pairs_between) {
+    if (pairs_[ii].radius_sq == radius_sq) return ii;
+  }
+
+  pairs_between.push_back(pairs_.size());
+  pairs_.push_back({position1, position2, radius_sq});
+  max_radius_ = std::max(max_radius_, radius);
+
+  return pairs_.size() - 1;
+}
+
+void ProximityBroadPhase::FindActivePairs(const VectorXf& input,
+                                          std::vector<bool>* active) {
+  CHECK_NOTNULL(active);
+
+  // Pairs of identical positions are always active.
+  active->resize(pairs_.size());
+  for (size_t ii = 0; ii < pairs_.size(); ii++)
+    (*active)[ii] = pairs_[ii].position1 == pairs_[ii].position2;
+
+  // Unpack positions. If any are not finite, we cannot sort them, so
+  // conservatively flag all pairs as active.
+  const size_t num_positions = positions_.size();
+  points_.resize(num_positions);
+  for (size_t ii = 0; ii < num_positions; ii++) {
+    points_[ii] = Point2(input(positions_[ii].first),
+                         input(positions_[ii].second));
+    if (!points_[ii].allFinite()) {
+      active->assign(pairs_.size(), true);
+      return;
+    }
+  }
+
+  // Sort positions along the x-axis.
+  order_.resize(num_positions);
+  std::iota(order_.begin(), order_.end(), 0);
+  std::sort(order_.begin(), order_.end(), [this](size_t a, size_t b) {
+    return points_[a].x() < points_[b].x();
+  });
+
+  // Sweep, only considering positions within the largest radius along x.
+  for (auto iter1 = order_.begin(); iter1 != order_.end(); iter1++) {
+    const Point2& point1 = points_[*iter1];
+
+    for (auto iter2 = iter1 + 1; iter2 != order_.end(); iter2++) {
+      const Point2& point2 = points_[*iter2];
+      const float dx = point2.x() - point1.x();
+      if (dx > max_radius_) break;
+
+      const float dy = point2.y() - point1.y();
+      if (std::abs(dy) > max_radius_) continue;
+
+      const float delta_sq = dx * dx + dy * dy;
+      const size_t position1 = std::min(*iter1, *iter2);
+      const size_t position2 = std::max(*iter1, *iter2);
+      for (size_t ii :
+           pairs_between_positions_[position1 * num_positions + position2]) {
+        if (delta_sq <= pairs_[ii].radius_sq) (*active)[ii] = true;
+      }
+    }
+  }
+}
+
+size_t ProximityBroadPhase::PositionIndex(
+    const std::pair<Dimension, Dimension>& position_idxs) {
+  const auto iter =
+      std::find(positions_.begin(), positions_.end(), position_idxs);
+  if (iter != positions_.end()) return std::distance(positions_.begin(), iter);
+
+  positions_.push_back(position_idxs);
+  return positions_.size() - 1;
+}
+
+}  // namespace ilqgames
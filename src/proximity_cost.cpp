@@ -42,10 +42,13 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/cost/compiled_costs.h>
 #include <ilqgames/cost/proximity_cost.h>
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <cmath>
+#include <utility>
 
 namespace ilqgames {
 
@@ -60,6 +63,13 @@ float ProximityCost::Evaluate(const VectorXf& input) const {
   return 0.5 * weight_ * gap * gap;
 }
 
+bool ProximityCost::IsActive(const VectorXf& input, float margin) const {
+  const float dx = input(xidx1_) - input(xidx2_);
+  const float dy = input(yidx1_) - input(yidx2_);
+  const float radius = threshold_ + margin;
+  return dx * dx + dy * dy < radius * radius;
+}
+
 void ProximityCost::Quadraticize(const VectorXf& input, MatrixXf* hess,
                                  VectorXf* grad) const {
   CHECK_NOTNULL(hess);
@@ -120,4 +130,25 @@ void ProximityCost::Quadraticize(const VectorXf& input, MatrixXf* hess,
   (*grad)(yidx2_) -= ddy1;
 }
 
+bool ProximityCost::ProximityPair(
+    std::pair<Dimension, Dimension>* position_idxs1,
+    std::pair<Dimension, Dimension>* position_idxs2, float* radius) const {
+  CHECK_NOTNULL(position_idxs1);
+  CHECK_NOTNULL(position_idxs2);
+  CHECK_NOTNULL(radius);
+
+  *position_idxs1 = {xidx1_, yidx1_};
+  *position_idxs2 = {xidx2_, yidx2_};
+  *radius = threshold_;
+  return true;
+}
+
+bool ProximityCost::Compile(size_t proximity_pair,
+                            CompiledCosts* compiled) const {
+  CHECK_NOTNULL(compiled);
+  compiled->AddProximityTerm({xidx1_, yidx1_, xidx2_, yidx2_, weight_,
+                              threshold_, threshold_sq_, proximity_pair});
+  return true;
+}
+
 }  // namespace ilqgames
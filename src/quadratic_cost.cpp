@@ -40,6 +40,7 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/cost/compiled_costs.h>
 #include <ilqgames/cost/quadratic_cost.h>
 #include <ilqgames/utils/types.h>
 
@@ -86,4 +87,15 @@ void QuadraticCost::Quadraticize(const VectorXf& input, MatrixXf* hess,
   }
 }
 
+bool QuadraticCost::Compile(size_t proximity_pair,
+                            CompiledCosts* compiled) const {
+  CHECK_NOTNULL(compiled);
+
+  // Only single dimension costs are compiled.
+  if (dimension_ < 0) return false;
+
+  compiled->AddQuadraticTerm({dimension_, weight_, nominal_});
+  return true;
+}
+
 }  // namespace ilqgames
@@ -43,23 +43,22 @@
 #include <ilqgames/cost/quadratic_polyline2_cost.h>
 #include <ilqgames/cost/time_invariant_cost.h>
 #include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
 #include <ilqgames/utils/types.h>
 
 #include <tuple>
 
 namespace ilqgames {
 
-float QuadraticPolyline2Cost::Evaluate(const VectorXf& input) const {
+float QuadraticPolyline2Cost::Evaluate(Time t, const VectorXf& input) const {
   CHECK_LT(xidx_, input.size());
   CHECK_LT(yidx_, input.size());
 
   // Compute signed squared distance by finding closest point.
-  float signed_squared_distance;
-  bool is_endpoint;
-  polyline_.ClosestPoint(Point2(input(xidx_), input(yidx_)), nullptr, nullptr,
-                         &signed_squared_distance, &is_endpoint);
+  const auto closest = ClosestPoint(t, input);
+  float signed_squared_distance = closest.signed_squared_distance;
 
-  if (is_endpoint) {
+  if (closest.is_endpoint) {
     // If the is_endpoint flag is raised, we set the signed_squared_distance to
     // 0.0.
     signed_squared_distance = 0.0;
@@ -68,7 +67,8 @@ float QuadraticPolyline2Cost::Evaluate(const VectorXf& input) const {
   return 0.5 * weight_ * std::abs(signed_squared_distance);
 }
 
-void QuadraticPolyline2Cost::Quadraticize(const VectorXf& input, MatrixXf* hess,
+void QuadraticPolyline2Cost::Quadraticize(Time t, const VectorXf& input,
+                                          MatrixXf* hess,
                                           VectorXf* grad) const {
   CHECK_LT(xidx_, input.size());
   CHECK_LT(yidx_, input.size());
@@ -82,11 +82,11 @@ void QuadraticPolyline2Cost::Quadraticize(const VectorXf& input, MatrixXf* hess,
   // Unpack current position and find closest point / segment.
   const Point2 current_position(input(xidx_), input(yidx_));
 
-  bool is_vertex;
-  bool is_endpoint;
-  LineSegment2 segment(Point2(0.0, 0.0), Point2(1.0, 1.0));
-  const Point2 closest_point = polyline_.ClosestPoint(
-      current_position, &is_vertex, &segment, nullptr, &is_endpoint);
+  const auto closest = ClosestPoint(t, input);
+  const bool is_vertex = closest.is_vertex;
+  const bool is_endpoint = closest.is_endpoint;
+  const LineSegment2& segment = polyline_.Segments()[closest.segment_idx];
+  const Point2 closest_point = closest.closest_point;
 
   // First check whether the closest point is a endpoint of the polyline.
   if (is_endpoint) return;
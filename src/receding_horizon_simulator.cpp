@@ -43,18 +43,38 @@
 // problem in which short horizon problems are solved asynchronously throughout
 // operation.
 //
+// By default, time advances by the measured wall-clock time of each solve.
+// Alternatively, time may advance by the time a given model charges each solve
+// (e.g., a fixed budget, or a calibrated time per solver iteration), in which
+// case closed-loop runs are reproducible regardless of machine load.
+//
+// By default, the simulator replans on a fixed schedule. Alternatively, it may
+// replan only when triggered by the state deviating from the current plan or
+// the current plan running out, and otherwise keep executing the current plan.
+//
+// By default, every solve is given the same planner runtime. Alternatively,
+// each solve may be given time for a target number of solver iterations, as
+// predicted from the runtimes of recent iterations.
+//
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/dynamics/integrator.h>
+#include <ilqgames/dynamics/multi_player_integrable_system.h>
 #include <ilqgames/examples/receding_horizon_simulator.h>
 #include <ilqgames/solver/ilq_solver.h>
 #include <ilqgames/solver/problem.h>
 #include <ilqgames/solver/solution_splicer.h>
+#include <ilqgames/solver/solver_params.h>
+#include <ilqgames/utils/operating_point.h>
+#include <ilqgames/utils/runtime_predictor.h>
 #include <ilqgames/utils/solver_log.h>
 #include <ilqgames/utils/strategy.h>
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <chrono>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -62,57 +82,183 @@ namespace ilqgames {
 
 using clock = std::chrono::system_clock;
 
+namespace {
+
+// Check whether any of the given triggers fire, given the current state and
+// time and the plan being executed.
+bool ShouldReplan(const ReplanningTriggers& triggers,
+                  const MultiPlayerIntegrableSystem& dynamics,
+                  const SolutionSplicer& splicer, const VectorXf& x, Time t,
+                  Time planner_runtime) {
+  // Check how much of the current plan would remain after solving.
+  const Time time_step = dynamics.TimeStep();
+  const Time plan_final_time =
+      splicer.InitialTime() +
+      time_step * static_cast<Time>(splicer.NumTimeSteps());
+  if (plan_final_time - t - planner_runtime < triggers.min_remaining_horizon) {
+    VLOG(1) << "t = " << t << ": Replanning before current plan runs out.";
+    return true;
+  }
+
+  // Predict the current state by interpolating the current plan.
+  const Time relative_time =
+      std::max<Time>(0.0, (t - splicer.InitialTime()) / time_step);
+  const size_t kk = std::min(static_cast<size_t>(relative_time),
+                             splicer.NumTimeSteps() - 1);
+  const size_t next_kk = std::min(kk + 1, splicer.NumTimeSteps() - 1);
+  const float fraction = relative_time - static_cast<Time>(kk);
+  const VectorXf predicted_x = (1.0 - fraction) * splicer.State(kk) +
+                               fraction * splicer.State(next_kk);
+
+  // Check each player's deviation from that prediction. Distances between
+  // states are squared, so compare against squared thresholds.
+  const auto& thresholds = triggers.player_distance_thresholds;
+  if (thresholds.empty()) return false;
+  CHECK(thresholds.size() == 1 || thresholds.size() == dynamics.NumPlayers());
+  for (PlayerIndex ii = 0; ii < dynamics.NumPlayers(); ii++) {
+    const float threshold =
+        (thresholds.size() == 1) ? thresholds.front() : thresholds[ii];
+    if (dynamics.PlayerDistanceBetween(ii, x, predicted_x) >
+        threshold * threshold) {
+      VLOG(1) << "t = " << t << ": Replanning since player " << ii
+              << " deviated from current plan.";
+      return true;
+    }
+  }
+
+  return false;
+}
+
+}  // anonymous namespace
+
+SolveTimeModel FixedSolveTimeModel(Time solve_time) {
+  CHECK_GE(solve_time, 0.0);
+  return [solve_time](const SolverLog& log) { return solve_time; };
+}
+
+SolveTimeModel PerIterationSolveTimeModel(Time time_per_iteration,
+                                          Time overhead) {
+  CHECK_GE(time_per_iteration, 0.0);
+  CHECK_GE(overhead, 0.0);
+  return [time_per_iteration, overhead](const SolverLog& log) {
+    return overhead + time_per_iteration * static_cast<Time>(log.NumIterates());
+  };
+}
+
+Time BudgetPlannerRuntime(const PlannerRuntimeBudget& budget,
+                          const RuntimePredictor& predictor) {
+  CHECK_GE(budget.overhead, 0.0);
+  CHECK_LE(budget.min_planner_runtime, budget.max_planner_runtime);
+
+  const Time runtime =
+      budget.overhead +
+      static_cast<Time>(budget.num_iterations) *
+          predictor.IterationRuntime(budget.latency_quantile);
+  return std::min(budget.max_planner_runtime,
+                  std::max(budget.min_planner_runtime, runtime));
+}
+
 std::vector<std::shared_ptr<const SolverLog>> RecedingHorizonSimulator(
-    Time final_time, Time planner_runtime, Problem* problem) {
+    Time final_time, Time planner_runtime, Problem* problem,
+    const SolveTimeModel& solve_time_model,
+    const ReplanningTriggers* replanning_triggers,
+    const PlannerRuntimeBudget* planner_runtime_budget) {
   CHECK_NOTNULL(problem);
+  CHECK(!solve_time_model || !planner_runtime_budget);
+
+  // Time to integrate forward before checking whether to replan.
+  constexpr Time kExtraTime = 0.05;
+
+  // The loop ends once less than a time step of the current plan would remain
+  // after solving, so the trigger for the plan running out must fire earlier,
+  // even though time advances between checks.
+  if (replanning_triggers) {
+    CHECK_GT(replanning_triggers->min_remaining_horizon,
+             problem->Solver().TimeStep() + kExtraTime);
+  }
 
   // Set up a list of solver logs, one per solver invocation.
   std::vector<std::shared_ptr<const SolverLog>> logs;
 
+  // Solve with the given maximum runtime and return the time used, either as
+  // measured or as charged by the solve time model. Solves are only cut short
+  // by wall-clock time when using measured time. A modeled solve charged more
+  // than the maximum runtime would have been stopped then, before reaching its
+  // solution, so it is charged the maximum runtime and flagged as overrunning.
+  bool overran = false;
+  auto solve = [&logs, problem, &solve_time_model,
+                &overran](Time max_runtime) {
+    overran = false;
+    if (solve_time_model) {
+      logs.push_back(problem->Solve());
+
+      const Time solve_time = solve_time_model(*logs.back());
+      if (solve_time > max_runtime) {
+        overran = true;
+        return max_runtime;
+      }
+
+      return solve_time;
+    }
+
+    const auto solver_call_time = clock::now();
+    logs.push_back(problem->Solve(max_runtime));
+    return std::chrono::duration<Time>(clock::now() - solver_call_time)
+        .count();
+  };  // solve
+
   // Initial run of the solver. Keep track of time in order to know how much to
   // integrate dynamics forward.
-  auto solver_call_time = clock::now();
-  logs.push_back(problem->Solve());
-  Time elapsed_time =
-      std::chrono::duration<Time>(clock::now() - solver_call_time).count();
+  Time elapsed_time = solve(std::numeric_limits<Time>::infinity());
 
   VLOG(0) << "Solved initial problem in " << elapsed_time << " seconds, with "
           << logs.back()->NumIterates() << " iterations.";
   const auto& dynamics = problem->Solver().Dynamics();
 
+  // Integrate the simulated system as the solver does, reusing one integrator
+  // throughout.
+  const SolverParams& params = problem->Solver().Params();
+  Integrator integrator(params.integration_method,
+                        params.num_integration_substeps);
+
   // Keep a solution splicer to incorporate new receding horizon solutions.
-  SolutionSplicer splicer(*logs.front());
+  SolutionSplicer splicer(logs.front());
 
   // Repeatedly integrate dynamics forward, reset problem initial conditions,
   // and resolve.
   VectorXf x(problem->InitialState());
-  Time t = splicer.CurrentOperatingPoint().t0;
+  Time t = splicer.InitialTime();
 
   while (true) {
+    // Maybe choose this solve's planner runtime from predicted iteration
+    // runtimes.
+    if (planner_runtime_budget) {
+      planner_runtime = BudgetPlannerRuntime(*planner_runtime_budget,
+                                             problem->Solver().Runtimes());
+    }
+
     // Break the loop if it's been long enough.
     // Integrate a little more.
-    constexpr Time kExtraTime = 0.05;
     t += kExtraTime;  // + planner_runtime;
 
     if (t >= final_time || !splicer.ContainsTime(t + planner_runtime +
                                                  problem->Solver().TimeStep()))
       break;
 
-    x = dynamics.Integrate(t - kExtraTime, t, x,
-                           splicer.CurrentOperatingPoint(),
-                           splicer.CurrentStrategies());
+    x = splicer.Integrate(dynamics, t - kExtraTime, t, x, &integrator);
 
-    // Overwrite problem with spliced solution.
-    problem->OverwriteSolution(splicer.CurrentOperatingPoint(),
-                               splicer.CurrentStrategies());
+    // In event-triggered mode, keep executing the current plan unless a
+    // trigger fires.
+    if (replanning_triggers &&
+        !ShouldReplan(*replanning_triggers, dynamics, splicer, x, t,
+                      planner_runtime))
+      continue;
 
-    // Set up next receding horizon problem and solve.
-    problem->SetUpNextRecedingHorizon(x, t, planner_runtime);
+    // Set up next receding horizon problem from the spliced solution and
+    // solve.
+    problem->SetUpNextRecedingHorizon(splicer, x, t, planner_runtime);
 
-    solver_call_time = clock::now();
-    logs.push_back(problem->Solve(planner_runtime));
-    elapsed_time =
-        std::chrono::duration<Time>(clock::now() - solver_call_time).count();
+    elapsed_time = solve(planner_runtime);
 
     CHECK_LE(elapsed_time, planner_runtime);
     VLOG(0) << "t = " << t << ": Solved warm-started problem in "
@@ -123,12 +269,16 @@ std::vector<std::shared_ptr<const SolverLog>> RecedingHorizonSimulator(
     if (t >= final_time || !splicer.ContainsTime(t)) break;
 
     // Integrate dynamics forward to account for solve time.
-    x = dynamics.Integrate(t - elapsed_time, t, x,
-                           splicer.CurrentOperatingPoint(),
-                           splicer.CurrentStrategies());
+    x = splicer.Integrate(dynamics, t - elapsed_time, t, x, &integrator);
 
-    // Add new solution to splicer if it converged.
-    if (logs.back()->WasConverged()) splicer.Splice(*logs.back());
+    // Add new solution to splicer if it converged within the planner runtime.
+    // Overrunning solves are treated as unconverged.
+    if (overran) {
+      VLOG(0) << "t = " << t << ": Discarding solve charged more than the "
+              << "planner runtime of " << planner_runtime << " seconds.";
+    } else if (logs.back()->WasConverged()) {
+      splicer.Splice(logs.back());
+    }
   }
 
   return logs;
@@ -50,14 +50,34 @@
 
 namespace ilqgames {
 
+void RouteProgressCost::Precompute(size_t num_time_steps) {
+  desired_route_points_.resize(num_time_steps);
+  for (size_t kk = 0; kk < num_time_steps; kk++) {
+    const float desired_route_pos =
+        initial_route_pos_ +
+        time_step_ * static_cast<Time>(kk) * nominal_speed_;
+    desired_route_points_[kk] =
+        polyline_.PointAt(desired_route_pos, nullptr, nullptr);
+  }
+
+  SetPrecomputedTimeGrid();
+}
+
+Point2 RouteProgressCost::DesiredRoutePoint(Time t) const {
+  size_t kk;
+  if (PrecomputedTimeIndex(t, desired_route_points_.size(), &kk))
+    return desired_route_points_[kk];
+
+  const float desired_route_pos =
+      initial_route_pos_ + (t - initial_time_) * nominal_speed_;
+  return polyline_.PointAt(desired_route_pos, nullptr, nullptr);
+}
+
 float RouteProgressCost::Evaluate(Time t, const VectorXf& input) const {
   CHECK_LT(xidx_, input.size());
   CHECK_LT(yidx_, input.size());
 
-  const float desired_route_pos =
-      initial_route_pos_ + (t - initial_time_) * nominal_speed_;
-  const Point2 desired =
-      polyline_.PointAt(desired_route_pos, nullptr, nullptr);
+  const Point2 desired = DesiredRoutePoint(t);
 
   const float dx = input(xidx_) - desired.x();
   const float dy = input(yidx_) - desired.y();
@@ -75,14 +95,9 @@ void RouteProgressCost::Quadraticize(Time t, const VectorXf& input,
   CHECK_EQ(input.size(), hess->cols());
   CHECK_EQ(input.size(), grad->size());
 
-  // Unpack current position and find closest point / segment.
+  // Unpack current position and find desired route point.
   const Point2 current_position(input(xidx_), input(yidx_));
-  const float desired_route_pos =
-      initial_route_pos_ + (t - initial_time_) * nominal_speed_;
-
-  bool is_endpoint;
-  const Point2 route_point =
-      polyline_.PointAt(desired_route_pos, nullptr, nullptr, &is_endpoint);
+  const Point2 route_point = DesiredRoutePoint(t);
 
   (*hess)(xidx_, xidx_) += weight_;
   (*hess)(yidx_, yidx_) += weight_;
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Predicts the runtime of the next solver iteration from the observed runtimes
+// of each phase of recent iterations (linearization, quadraticization, LQ
+// solve, and linesearch). To adapt to changing processor activity, estimates
+// quantiles of each phase's runtime over a moving window of specified length.
+// The predicted iteration runtime at a given quantile is the sum of the phases'
+// runtimes at that quantile, which is conservative since phases seldom all run
+// slow at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/utils/runtime_predictor.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+namespace ilqgames {
+
+RuntimePredictor::RuntimePredictor(size_t max_samples)
+    : max_samples_(max_samples) {
+  CHECK_GT(max_samples, 0);
+  for (auto& samples : samples_) samples.reserve(max_samples_);
+  scratch_.reserve(max_samples_);
+  oldest_.fill(0);
+
+  // For defined behavior, starting with a Tic() for every phase.
+  for (size_t ii = 0; ii < kNumSolverPhases; ii++)
+    Tic(static_cast<SolverPhase>(ii));
+}
+
+void RuntimePredictor::Tic(SolverPhase phase) {
+  starts_[static_cast<size_t>(phase)] =
+      std::chrono::high_resolution_clock::now();
+}
+
+void RuntimePredictor::Toc(SolverPhase phase) {
+  // Elapsed time in seconds.
+  const Time elapsed =
+      (std::chrono::duration<Time>(std::chrono::high_resolution_clock::now() -
+                                   starts_[static_cast<size_t>(phase)]))
+          .count();
+  Record(phase, elapsed);
+}
+
+void RuntimePredictor::Record(SolverPhase phase, Time runtime) {
+  DCHECK_GE(runtime, 0.0);
+
+  // Append until full, and then overwrite the oldest sample.
+  auto& samples = samples_[static_cast<size_t>(phase)];
+  if (samples.size() < max_samples_) {
+    samples.push_back(runtime);
+    return;
+  }
+
+  size_t& oldest = oldest_[static_cast<size_t>(phase)];
+  samples[oldest] = runtime;
+  oldest = (oldest + 1) % max_samples_;
+}
+
+void RuntimePredictor::Clear() {
+  for (auto& samples : samples_) samples.clear();
+  oldest_.fill(0);
+}
+
+Time RuntimePredictor::PhaseRuntime(SolverPhase phase, float quantile,
+                                    Time initial_guess) const {
+  CHECK_GE(quantile, 0.0);
+  CHECK_LE(quantile, 1.0);
+
+  // Handle not enough data.
+  const auto& samples = samples_[static_cast<size_t>(phase)];
+  if (samples.empty()) return initial_guess;
+
+  // Select the nearest-rank quantile without sorting the window.
+  const size_t rank = static_cast<size_t>(
+      std::ceil(quantile * static_cast<float>(samples.size())));
+  const size_t idx = (rank == 0) ? 0 : rank - 1;
+
+  scratch_.assign(samples.begin(), samples.end());
+  std::nth_element(scratch_.begin(), scratch_.begin() + idx, scratch_.end());
+  return scratch_[idx];
+}
+
+Time RuntimePredictor::IterationRuntime(float quantile,
+                                        Time initial_guess) const {
+  // Handle not enough data.
+  for (const auto& samples : samples_) {
+    if (samples.empty()) return initial_guess;
+  }
+
+  Time runtime = 0.0;
+  for (size_t ii = 0; ii < kNumSolverPhases; ii++)
+    runtime += PhaseRuntime(static_cast<SolverPhase>(ii), quantile);
+
+  return runtime;
+}
+
+}  // namespace ilqgames
@@ -40,6 +40,7 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/cost/compiled_costs.h>
 #include <ilqgames/cost/semiquadratic_cost.h>
 #include <ilqgames/utils/types.h>
 
@@ -58,6 +59,13 @@ float SemiquadraticCost::Evaluate(const VectorXf& input) const {
   return 0.0;
 }
 
+bool SemiquadraticCost::IsActive(const VectorXf& input, float margin) const {
+  CHECK_LT(dimension_, input.size());
+
+  const float diff = input(dimension_) - threshold_;
+  return (oriented_right_) ? diff > -margin : diff < margin;
+}
+
 // Quadraticize this cost at the given input, and add to the running
 // sum of gradients and Hessians (if non-null).
 void SemiquadraticCost::Quadraticize(const VectorXf& input, MatrixXf* hess,
@@ -80,4 +88,13 @@ void SemiquadraticCost::Quadraticize(const VectorXf& input, MatrixXf* hess,
   (*grad)(dimension_) += weight_ * diff;
 }
 
+// Add this cost to the corresponding group of compiled costs.
+bool SemiquadraticCost::Compile(size_t proximity_pair,
+                                CompiledCosts* compiled) const {
+  CHECK_NOTNULL(compiled);
+  compiled->AddSemiquadraticTerm(
+      {dimension_, weight_, threshold_, oriented_right_});
+  return true;
+}
+
 }  // namespace ilqgames
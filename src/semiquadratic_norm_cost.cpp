@@ -60,6 +60,15 @@ float SemiquadraticNormCost::Evaluate(const VectorXf& input) const {
   return 0.0;
 }
 
+bool SemiquadraticNormCost::IsActive(const VectorXf& input,
+                                     float margin) const {
+  CHECK_LT(dim1_, input.size());
+  CHECK_LT(dim2_, input.size());
+
+  const float diff = std::hypot(input(dim1_), input(dim2_)) - threshold_;
+  return (oriented_right_) ? diff > -margin : diff < margin;
+}
+
 void SemiquadraticNormCost::Quadraticize(const VectorXf& input, MatrixXf* hess,
                                          VectorXf* grad) const {
   CHECK_LT(dim1_, input.size());
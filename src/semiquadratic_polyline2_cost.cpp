@@ -43,22 +43,22 @@
 #include <ilqgames/cost/semiquadratic_polyline2_cost.h>
 #include <ilqgames/cost/time_invariant_cost.h>
 #include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/geometry/polyline2_query_cache.h>
 #include <ilqgames/utils/types.h>
 
 #include <tuple>
 
 namespace ilqgames {
 
-float SemiquadraticPolyline2Cost::Evaluate(const VectorXf& input) const {
+float SemiquadraticPolyline2Cost::Evaluate(Time t,
+                                           const VectorXf& input) const {
   CHECK_LT(xidx_, input.size());
   CHECK_LT(yidx_, input.size());
 
   // Compute signed squared distance by finding closest point.
-  float signed_squared_distance;
-  bool is_endpoint;
-  polyline_.ClosestPoint(Point2(input(xidx_), input(yidx_)), nullptr, nullptr,
-                         &signed_squared_distance, &is_endpoint);
-  if (is_endpoint) {
+  const auto closest = ClosestPoint(t, input);
+  const float signed_squared_distance = closest.signed_squared_distance;
+  if (closest.is_endpoint) {
     // If the is_endpoint flag is raised, we return 0.0.
     return 0.0;
   }
@@ -72,7 +72,23 @@ float SemiquadraticPolyline2Cost::Evaluate(const VectorXf& input) const {
   return 0.5 * weight_ * diff * diff;
 }
 
-void SemiquadraticPolyline2Cost::Quadraticize(const VectorXf& input,
+bool SemiquadraticPolyline2Cost::IsActive(Time t, const VectorXf& input,
+                                          float margin) const {
+  CHECK_LT(xidx_, input.size());
+  CHECK_LT(yidx_, input.size());
+
+  // Cost vanishes beyond the endpoints of the polyline.
+  const auto closest = ClosestPoint(t, input);
+  if (closest.is_endpoint) return false;
+
+  const float signed_distance =
+      sgn(closest.signed_squared_distance) *
+      std::sqrt(std::abs(closest.signed_squared_distance));
+  const float diff = signed_distance - threshold_;
+  return (oriented_right_) ? diff > -margin : diff < margin;
+}
+
+void SemiquadraticPolyline2Cost::Quadraticize(Time t, const VectorXf& input,
                                               MatrixXf* hess,
                                               VectorXf* grad) const {
   CHECK_LT(xidx_, input.size());
@@ -87,13 +103,12 @@ void SemiquadraticPolyline2Cost::Quadraticize(const VectorXf& input,
   // Unpack current position and find closest point / segment.
   const Point2 current_position(input(xidx_), input(yidx_));
 
-  float signed_squared_distance;
-  bool is_vertex;
-  bool is_endpoint;
-  LineSegment2 segment(Point2(0.0, 0.0), Point2(1.0, 1.0));
-  const Point2 closest_point =
-      polyline_.ClosestPoint(current_position, &is_vertex, &segment,
-                             &signed_squared_distance, &is_endpoint);
+  const auto closest = ClosestPoint(t, input);
+  const float signed_squared_distance = closest.signed_squared_distance;
+  const bool is_vertex = closest.is_vertex;
+  const bool is_endpoint = closest.is_endpoint;
+  const LineSegment2& segment = polyline_.Segments()[closest.segment_idx];
+  const Point2 closest_point = closest.closest_point;
 
   // Check if cost is active.
   if (!IsActive(signed_squared_distance)) return;
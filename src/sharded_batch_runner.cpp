@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Utility for running closed-loop receding horizon simulations in shards, each
+// in its own worker process, so that a crash (e.g., a failed CHECK) in one
+// simulation does not take down the rest of the batch.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/examples/closed_loop_batch_runner.h>
+#include <ilqgames/examples/sharded_batch_runner.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ilqgames {
+
+namespace {
+
+// A contiguous range of scenarios, and the number of times it has crashed.
+struct Shard {
+  size_t begin;
+  size_t end;
+  size_t num_crashes;
+};  // struct Shard
+
+// A shard being simulated by a worker process, the time by which the worker
+// must finish, and whether it has been killed for running past that time.
+struct RunningShard {
+  Shard shard;
+  std::chrono::steady_clock::time_point deadline;
+  bool timed_out;
+};  // struct RunningShard
+
+// Interval at which to poll workers for completion when enforcing timeouts.
+static constexpr std::chrono::milliseconds kPollInterval(10);
+
+// Parse a complete token as a number. Returns whether parsing succeeded.
+bool ParseNumber(const std::string& token, double* value) {
+  char* end;
+  *value = std::strtod(token.c_str(), &end);
+  return !token.empty() && end == token.c_str() + token.size();
+}
+
+bool ParseNumber(const std::string& token, size_t* value) {
+  char* end;
+  *value = std::strtoull(token.c_str(), &end, 10);
+  return !token.empty() && end == token.c_str() + token.size();
+}
+
+// File to which a worker writes the results of the given shard.
+std::string ShardFilename(const std::string& work_directory,
+                          const Shard& shard) {
+  return work_directory + "/shard_" + std::to_string(shard.begin) + "_" +
+         std::to_string(shard.end) + ".txt";
+}
+
+// Simulate the given shard in this (worker) process, and write results to
+// file. Returns whether results were written.
+bool RunShard(const Shard& shard, const ScenarioFactory& factory,
+              const ClosedLoopBatchParams& params,
+              const std::string& filename) {
+  const ScenarioFactory shard_factory = [&factory, &shard](size_t ii) {
+    return factory(shard.begin + ii);
+  };  // shard_factory
+
+  // Run on a single thread, since there are already as many workers as cores.
+  ClosedLoopBatchParams shard_params = params;
+  shard_params.num_threads = 1;
+  std::vector<ClosedLoopRunStatistics> runs =
+      RunClosedLoopBatch(shard.end - shard.begin, shard_factory, shard_params);
+
+  // Write to a temporary file and then rename it, so that results are never
+  // read partially written.
+  const std::string temporary_filename = filename + ".tmp";
+  std::ofstream file(temporary_filename);
+  if (!file.is_open()) return false;
+
+  for (auto& run : runs) {
+    run.scenario += shard.begin;
+    WriteClosedLoopRun(run, &file);
+  }
+
+  file.close();
+  return file.good() &&
+         std::rename(temporary_filename.c_str(), filename.c_str()) == 0;
+}
+
+// Read the results of the given shard from file. Returns whether results for
+// every scenario in the shard were read.
+bool ReadShard(const std::string& filename, const Shard& shard,
+               std::vector<ClosedLoopRunStatistics>* runs) {
+  std::ifstream file(filename);
+  if (!file.is_open()) return false;
+
+  ClosedLoopRunStatistics run;
+  while (ReadClosedLoopRun(&file, &run)) runs->push_back(run);
+  return runs->size() == shard.end - shard.begin;
+}
+
+}  // anonymous namespace
+
+ShardedBatchResults RunShardedClosedLoopBatch(
+    size_t num_scenarios, const ScenarioFactory& factory,
+    const ShardedBatchParams& params) {
+  CHECK(factory);
+  CHECK_GT(params.shard_size, 0);
+  CHECK_GT(params.max_attempts, 0);
+  CHECK_GT(params.shard_timeout, 0.0);
+  CHECK(!params.work_directory.empty());
+
+  // Merged results and quarantined scenarios are written as they arrive, so
+  // that they survive the coordinator being interrupted.
+  const std::string results_filename = params.work_directory + "/runs.txt";
+  const std::string quarantine_filename =
+      params.work_directory + "/quarantined.txt";
+  std::ofstream results_file(results_filename);
+  std::ofstream quarantine_file(quarantine_filename);
+  CHECK(results_file.is_open()) << "Could not open " << results_filename;
+  CHECK(quarantine_file.is_open()) << "Could not open " << quarantine_filename;
+
+  std::deque<Shard> pending;
+  for (size_t begin = 0; begin < num_scenarios; begin += params.shard_size) {
+    const size_t end = std::min(num_scenarios, begin + params.shard_size);
+    pending.push_back({begin, end, 0});
+  }
+
+  size_t num_workers = params.num_workers;
+  if (num_workers == 0)
+    num_workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+  const bool has_timeout = std::isfinite(params.shard_timeout);
+
+  ShardedBatchResults results;
+  std::map<pid_t, RunningShard> running;
+  while (!pending.empty() || !running.empty()) {
+    // Keep all workers busy.
+    while (running.size() < num_workers && !pending.empty()) {
+      const Shard shard = pending.front();
+      pending.pop_front();
+
+      const std::string filename = ShardFilename(params.work_directory, shard);
+      std::remove(filename.c_str());
+
+      // Flush buffered output so that it is not duplicated by the worker.
+      std::cout.flush();
+      std::cerr.flush();
+      std::fflush(nullptr);
+
+      const pid_t pid = fork();
+      CHECK_GE(pid, 0) << "Could not fork worker: " << std::strerror(errno);
+      if (pid == 0) {
+        // Worker process. Exit immediately when done, without running any of
+        // the coordinator's exit handlers.
+        _exit(RunShard(shard, factory, params.batch, filename) ? EXIT_SUCCESS
+                                                               : EXIT_FAILURE);
+      }
+
+      auto deadline = std::chrono::steady_clock::time_point::max();
+      if (has_timeout) {
+        deadline = std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::duration<Time>(params.shard_timeout));
+      }
+
+      running.emplace(pid, RunningShard{shard, deadline, false});
+    }
+
+    // Wait for any worker to finish. If enforcing timeouts, poll instead, and
+    // kill workers which run past their deadline. Killed workers are reaped
+    // here like any other.
+    int status;
+    const pid_t pid = waitpid(-1, &status, (has_timeout) ? WNOHANG : 0);
+    if (pid < 0) {
+      CHECK_EQ(errno, EINTR) << "Could not wait for workers: "
+                             << std::strerror(errno);
+      continue;
+    }
+
+    if (pid == 0) {
+      const auto now = std::chrono::steady_clock::now();
+      for (auto& entry : running) {
+        RunningShard& running_shard = entry.second;
+        if (running_shard.timed_out || now < running_shard.deadline) continue;
+
+        kill(entry.first, SIGKILL);
+        running_shard.timed_out = true;
+      }
+
+      std::this_thread::sleep_for(kPollInterval);
+      continue;
+    }
+
+    const auto iter = running.find(pid);
+    if (iter == running.end()) continue;
+    const Shard shard = iter->second.shard;
+    const bool timed_out = iter->second.timed_out;
+    running.erase(iter);
+
+    // Merge results if the worker succeeded.
+    const std::string filename = ShardFilename(params.work_directory, shard);
+    std::vector<ClosedLoopRunStatistics> shard_runs;
+    if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS &&
+        ReadShard(filename, shard, &shard_runs)) {
+      for (const auto& run : shard_runs) WriteClosedLoopRun(run, &results_file);
+      results_file.flush();
+
+      results.runs.insert(results.runs.end(), shard_runs.begin(),
+                          shard_runs.end());
+      std::remove(filename.c_str());
+      continue;
+    }
+
+    if (timed_out) {
+      LOG(WARNING) << "Worker for scenarios [" << shard.begin << ", "
+                   << shard.end << ") was killed after timing out.";
+    } else if (WIFSIGNALED(status)) {
+      LOG(WARNING) << "Worker for scenarios [" << shard.begin << ", "
+                   << shard.end << ") was killed by signal "
+                   << WTERMSIG(status) << ".";
+    } else {
+      LOG(WARNING) << "Worker for scenarios [" << shard.begin << ", "
+                   << shard.end << ") failed.";
+    }
+
+    // Split crashed (or timed out) shards to isolate the crashing scenarios,
+    // then retry single scenarios until they have crashed too many times.
+    if (shard.end - shard.begin > 1) {
+      const size_t middle = shard.begin + (shard.end - shard.begin) / 2;
+      pending.push_back({shard.begin, middle, 0});
+      pending.push_back({middle, shard.end, 0});
+    } else if (shard.num_crashes + 1 < params.max_attempts) {
+      pending.push_back({shard.begin, shard.end, shard.num_crashes + 1});
+    } else {
+      LOG(ERROR) << "Quarantining scenario " << shard.begin << ".";
+      results.quarantined_scenarios.push_back(shard.begin);
+      quarantine_file << shard.begin << std::endl;
+    }
+  }
+
+  std::sort(results.runs.begin(), results.runs.end(),
+            [](const ClosedLoopRunStatistics& run1,
+               const ClosedLoopRunStatistics& run2) {
+              return run1.scenario < run2.scenario;
+            });
+  std::sort(results.quarantined_scenarios.begin(),
+            results.quarantined_scenarios.end());
+  return results;
+}
+
+void WriteClosedLoopRun(const ClosedLoopRunStatistics& run,
+                        std::ostream* stream) {
+  CHECK_NOTNULL(stream);
+
+  // Write with enough precision to read back exactly.
+  std::ostringstream line;
+  line << std::setprecision(std::numeric_limits<Time>::max_digits10)
+       << run.scenario << " " << run.num_converged << " " << run.min_distance
+       << " " << run.mean_total_cost << " " << run.solve_times.size();
+  for (const Time solve_time : run.solve_times) line << " " << solve_time;
+
+  *stream << line.str() << std::endl;
+}
+
+bool ReadClosedLoopRun(std::istream* stream, ClosedLoopRunStatistics* run) {
+  CHECK_NOTNULL(stream);
+  CHECK_NOTNULL(run);
+
+  std::string line;
+  if (!std::getline(*stream, line)) return false;
+
+  // Parse each token separately, since streams do not read back infinite or
+  // NaN values.
+  std::istringstream tokens(line);
+  std::string scenario, num_converged, min_distance, mean_total_cost,
+      num_solves;
+  if (!(tokens >> scenario >> num_converged >> min_distance >>
+        mean_total_cost >> num_solves))
+    return false;
+
+  double value;
+  size_t num_solve_times;
+  if (!ParseNumber(scenario, &run->scenario) ||
+      !ParseNumber(num_converged, &run->num_converged) ||
+      !ParseNumber(num_solves, &num_solve_times))
+    return false;
+
+  if (!ParseNumber(min_distance, &value)) return false;
+  run->min_distance = value;
+  if (!ParseNumber(mean_total_cost, &value)) return false;
+  run->mean_total_cost = value;
+
+  run->solve_times.resize(num_solve_times);
+  std::string solve_time;
+  for (size_t ii = 0; ii < num_solve_times; ii++) {
+    if (!(tokens >> solve_time) || !ParseNumber(solve_time, &value))
+      return false;
+    run->solve_times[ii] = value;
+  }
+
+  return true;
+}
+
+}  // namespace ilqgames
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// Proximity costs shared between players, whose geometric core is computed
+// once per pair and relative position.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/cost/shared_proximity_terms.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <cmath>
+#include <tuple>
+#include <utility>
+
+namespace ilqgames {
+
+SharedProximityTerms::Core SharedProximityTerms::ComputeCore(
+    float dx, float dy, float threshold, float threshold_sq) {
+  Core core;
+  const float delta_sq = dx * dx + dy * dy;
+  if (delta_sq >= threshold_sq) return core;
+
+  const float delta = std::sqrt(delta_sq);
+  const float gap = threshold - delta;
+  const float inv_delta = 1.0 / delta;
+  const float dx_delta = dx * inv_delta;
+  const float dy_delta = dy * inv_delta;
+
+  core.is_active = true;
+  core.value = 0.5 * gap * gap;
+  core.grad_x = -gap * dx_delta;
+  core.grad_y = -gap * dy_delta;
+  core.hess_xx = inv_delta * (dx_delta * (gap * dx_delta + dx) - gap);
+  core.hess_yy = inv_delta * (dy_delta * (gap * dy_delta + dy) - gap);
+  core.hess_xy = inv_delta * (dx_delta * (gap * dy_delta + dy));
+  return core;
+}
+
+size_t SharedProximityTerms::Add(
+    std::pair<Dimension, Dimension>* position_idxs1,
+    std::pair<Dimension, Dimension>* position_idxs2, float threshold) {
+  CHECK_NOTNULL(position_idxs1);
+  CHECK_NOTNULL(position_idxs2);
+
+  if (*position_idxs2 < *position_idxs1)
+    std::swap(*position_idxs1, *position_idxs2);
+
+  const auto key =
+      std::make_tuple(position_idxs1->first, position_idxs1->second,
+                      position_idxs2->first, position_idxs2->second, threshold);
+  const auto iter = term_idxs_.find(key);
+  if (iter != term_idxs_.end()) return iter->second;
+
+  Term term;
+  term.xidx1 = position_idxs1->first;
+  term.yidx1 = position_idxs1->second;
+  term.xidx2 = position_idxs2->first;
+  term.yidx2 = position_idxs2->second;
+  term.threshold = threshold;
+  term.threshold_sq = threshold * threshold;
+  terms_.push_back(term);
+
+  term_idxs_.emplace(key, terms_.size() - 1);
+  return terms_.size() - 1;
+}
+
+const SharedProximityTerms::Core& SharedProximityTerms::Evaluate(
+    size_t term_idx, const VectorXf& input) {
+  CHECK_LT(term_idx, terms_.size());
+  Term& term = terms_[term_idx];
+
+  // Reuse the last core if it was computed at the same relative position.
+  const float dx = input(term.xidx1) - input(term.xidx2);
+  const float dy = input(term.yidx1) - input(term.yidx2);
+  if (term.is_valid && term.dx == dx && term.dy == dy) return term.core;
+
+  term.core = ComputeCore(dx, dy, term.threshold, term.threshold_sq);
+  term.dx = dx;
+  term.dy = dy;
+  term.is_valid = true;
+  num_computations_++;
+
+  return term.core;
+}
+
+}  // namespace ilqgames
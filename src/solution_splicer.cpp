@@ -40,92 +40,155 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/dynamics/integrator.h>
 #include <ilqgames/dynamics/multi_player_integrable_system.h>
 #include <ilqgames/solver/solution_splicer.h>
 #include <ilqgames/utils/operating_point.h>
 #include <ilqgames/utils/solver_log.h>
 #include <ilqgames/utils/strategy.h>
+#include <ilqgames/utils/time_ring_buffer.h>
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 namespace ilqgames {
 
-SolutionSplicer::SolutionSplicer(const SolverLog& log)
-    : strategies_(log.FinalStrategies()),
-      operating_point_(log.FinalOperatingPoint()),
-      time_step_(log.TimeStep()) {}
+namespace {
+
+// HACK! If we're close enough to the beginning of the old trajectory, just
+// save the first few steps along it in case a lower-level path follower uses
+// this information.
+static constexpr size_t kNumPreviousTimeStepsToSave = 5;
+
+}  // anonymous namespace
+
+SolutionSplicer::SolutionSplicer(const std::shared_ptr<const SolverLog>& log)
+    : steps_(log->FinalOperatingPoint().xs.size() +
+             kNumPreviousTimeStepsToSave),
+      t0_(log->FinalOperatingPoint().t0),
+      time_step_(log->TimeStep()),
+      last_spliced_log_(log),
+      window_operating_point_(0, log->FinalStrategies().size(),
+                              log->FinalOperatingPoint().t0) {
+  for (size_t kk = 0; kk < log->FinalOperatingPoint().xs.size(); kk++)
+    PushBack(*log, kk);
+
+  // Integration windows only span a few time steps, so start them empty.
+  for (const auto& strategy : log->FinalStrategies()) {
+    window_strategies_.emplace_back(0, strategy.Ps.front().cols(),
+                                    strategy.Ps.front().rows());
+  }
+}
 
-void SolutionSplicer::Splice(const SolverLog& log) {
-  CHECK_GE(log.FinalOperatingPoint().t0, operating_point_.t0);
-  CHECK_GE(operating_point_.xs.size(), log.NumTimeSteps());
-  CHECK_EQ(log.FinalOperatingPoint().xs.size(), log.NumTimeSteps());
+void SolutionSplicer::Splice(const std::shared_ptr<const SolverLog>& log) {
+  CHECK_NOTNULL(log.get());
+  CHECK_GE(log->FinalOperatingPoint().t0, t0_);
+  CHECK_GE(steps_.Size(), log->NumTimeSteps());
+  CHECK_EQ(log->FinalOperatingPoint().xs.size(), log->NumTimeSteps());
 
   const size_t current_timestep = static_cast<size_t>(
       1e-4 +  // Add a little so that conversion doesn't end up subtracting 1.
-      (log.FinalOperatingPoint().t0 - operating_point_.t0) / log.TimeStep());
+      (log->FinalOperatingPoint().t0 - t0_) / log->TimeStep());
+  CHECK_LE(current_timestep, steps_.Size());
 
-  // HACK! If we're close enough to the beginning of the old trajectory, just
-  // save the first few steps along it in case a lower-level path follower uses
-  // this information.
-  constexpr size_t kNumPreviousTimeStepsToSave = 5;
   const size_t initial_timestep =
-      (static_cast<int>(current_timestep) <
-       static_cast<int>(kNumPreviousTimeStepsToSave))
+      (current_timestep < kNumPreviousTimeStepsToSave)
           ? 0
           : current_timestep - kNumPreviousTimeStepsToSave;
 
-  // HACK! Make sure the new solution starts several timesteps after the
-  // nearest match to guard against off-by-one issues.
-  constexpr size_t kNumExtraTimeStepsBeforeSplicingIn = 0;
-  const size_t first_timestep_new_solution =
-      kNumExtraTimeStepsBeforeSplicingIn + current_timestep;
-
-  // (2) Copy over saved part of existing plan.
-  for (size_t kk = initial_timestep; kk < first_timestep_new_solution; kk++) {
-    const size_t kk_new_solution = kk - initial_timestep;
-    operating_point_.xs[kk_new_solution].swap(operating_point_.xs[kk]);
-    operating_point_.us[kk_new_solution].swap(operating_point_.us[kk]);
-
-    for (auto& strategy : strategies_) {
-      strategy.Ps[kk_new_solution].swap(strategy.Ps[kk]);
-      strategy.alphas[kk_new_solution].swap(strategy.alphas[kk]);
-    }
+  // Drop elapsed time steps other than the few we save, by moving the head of
+  // the buffer, and then drop the rest of the existing plan from where the new
+  // solution begins.
+  steps_.PopFront(initial_timestep);
+  t0_ += initial_timestep * log->TimeStep();
+  steps_.Truncate(current_timestep - initial_timestep);
+
+  // Append the new solution, reusing the storage of dropped time steps.
+  CHECK_LE(steps_.Size() + log->NumTimeSteps(), steps_.Capacity());
+  for (size_t kk = 0; kk < log->NumTimeSteps(); kk++) PushBack(*log, kk);
+  last_spliced_log_ = log;
+}
+
+VectorXf SolutionSplicer::Integrate(const MultiPlayerIntegrableSystem& dynamics,
+                                    Time t0, Time t, const VectorXf& x0,
+                                    Integrator* integrator) {
+  CHECK_GE(t, t0);
+  CHECK_GE(t0, t0_);
+
+  // Copy out the time steps spanned, starting one early so that rounding t0
+  // down cannot fall before the window, and ending one late so that states
+  // may be interpolated up to t.
+  const size_t current_timestep =
+      static_cast<size_t>((t0 - t0_) / time_step_);
+  const size_t first_timestep =
+      (current_timestep > 0) ? current_timestep - 1 : 0;
+  const size_t end_timestep = std::min(
+      steps_.Size(), static_cast<size_t>((t - t0_) / time_step_) + 2);
+  CHECK_LT(first_timestep, end_timestep);
+
+  const size_t num_time_steps = end_timestep - first_timestep;
+  window_operating_point_.xs.resize(num_time_steps);
+  window_operating_point_.us.resize(num_time_steps);
+  for (auto& strategy : window_strategies_) {
+    strategy.Ps.resize(num_time_steps);
+    strategy.alphas.resize(num_time_steps);
   }
 
-  // Resize to be the appropriate length.
-  // NOTE: makes use of default behavior of std::vector<T>.resize() in that it
-  // does not delete earlier entries.
-  const size_t num_spliced_timesteps =
-      current_timestep - initial_timestep + log.NumTimeSteps();
-  CHECK_LE(num_spliced_timesteps,
-           log.NumTimeSteps() + kNumPreviousTimeStepsToSave);
-
-  operating_point_.xs.resize(num_spliced_timesteps);
-  operating_point_.us.resize(num_spliced_timesteps);
-  operating_point_.t0 += initial_timestep * log.TimeStep();
-
-  for (auto& strategy : strategies_) {
-    strategy.Ps.resize(num_spliced_timesteps);
-    strategy.alphas.resize(num_spliced_timesteps);
+  CopyTimeSteps(first_timestep, num_time_steps, &window_operating_point_,
+                &window_strategies_);
+  return dynamics.Integrate(t0, t, x0, window_operating_point_,
+                            window_strategies_, integrator);
+}
+
+void SolutionSplicer::CopyTimeSteps(size_t first_timestep,
+                                    size_t num_time_steps,
+                                    OperatingPoint* operating_point,
+                                    std::vector<Strategy>* strategies) const {
+  CHECK_NOTNULL(operating_point);
+  CHECK_NOTNULL(strategies);
+  CHECK_LE(first_timestep + num_time_steps, steps_.Size());
+  CHECK_LE(num_time_steps, operating_point->xs.size());
+  CHECK_LE(num_time_steps, operating_point->us.size());
+
+  operating_point->t0 = t0_ + first_timestep * time_step_;
+  for (size_t kk = 0; kk < num_time_steps; kk++)
+    CopyTimeStep(first_timestep + kk, kk, operating_point, strategies);
+}
+
+void SolutionSplicer::CopyTimeStep(size_t timestep, size_t kk,
+                                   OperatingPoint* operating_point,
+                                   std::vector<Strategy>* strategies) const {
+  CHECK_NOTNULL(operating_point);
+  CHECK_NOTNULL(strategies);
+  CHECK_LT(timestep, steps_.Size());
+  CHECK_LT(kk, operating_point->xs.size());
+
+  const TimeStep& step = steps_[timestep];
+  CHECK_EQ(strategies->size(), step.Ps.size());
+
+  operating_point->xs[kk] = step.x;
+  operating_point->us[kk] = step.us;
+  for (PlayerIndex ii = 0; ii < strategies->size(); ii++) {
+    (*strategies)[ii].Ps[kk] = step.Ps[ii];
+    (*strategies)[ii].alphas[kk] = step.alphas[ii];
   }
+}
 
-  // Copy over new solution to overwrite existing log after first timestep.
-  CHECK_EQ(current_timestep + log.NumTimeSteps() - initial_timestep,
-           operating_point_.xs.size());
-  for (size_t kk = kNumExtraTimeStepsBeforeSplicingIn; kk < log.NumTimeSteps();
-       kk++) {
-    const size_t kk_new_solution = current_timestep + kk - initial_timestep;
-    operating_point_.xs[kk_new_solution] = log.FinalOperatingPoint().xs[kk];
-    operating_point_.us[kk_new_solution] = log.FinalOperatingPoint().us[kk];
-
-    for (PlayerIndex ii = 0; ii < log.NumPlayers(); ii++) {
-      strategies_[ii].Ps[kk_new_solution] = log.FinalStrategies()[ii].Ps[kk];
-      strategies_[ii].alphas[kk_new_solution] =
-          log.FinalStrategies()[ii].alphas[kk];
-    }
+void SolutionSplicer::PushBack(const SolverLog& log, size_t kk) {
+  const OperatingPoint& operating_point = log.FinalOperatingPoint();
+  const std::vector<Strategy>& strategies = log.FinalStrategies();
+
+  TimeStep& step = steps_.PushBack();
+  step.x = operating_point.xs[kk];
+  step.us = operating_point.us[kk];
+  step.Ps.resize(strategies.size());
+  step.alphas.resize(strategies.size());
+  for (PlayerIndex ii = 0; ii < strategies.size(); ii++) {
+    step.Ps[ii] = strategies[ii].Ps[kk];
+    step.alphas[ii] = strategies[ii].alphas[kk];
   }
 }
 
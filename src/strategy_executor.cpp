@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Executes the most recently published strategies at arbitrary query times,
+// holding solutions in a double buffer.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/solver/strategy_executor.h>
+#include <ilqgames/utils/operating_point.h>
+#include <ilqgames/utils/strategy.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace ilqgames {
+
+StrategyExecutor::StrategyExecutor(Time time_step)
+    : time_step_(time_step), current_(0), num_published_(0) {
+  CHECK_GT(time_step_, 0.0);
+  num_readers_[0] = 0;
+  num_readers_[1] = 0;
+}
+
+void StrategyExecutor::Publish(const OperatingPoint& operating_point,
+                               const std::vector<Strategy>& strategies) {
+  CHECK_EQ(operating_point.us.size(), operating_point.xs.size());
+  for (const auto& strategy : strategies)
+    CHECK_EQ(strategy.Ps.size(), operating_point.xs.size());
+
+  // Wait for any readers still holding the retired buffer from before the last
+  // swap. Readers which arrive later will see that it is not current and move
+  // on without reading it.
+  const size_t retired = 1 - current_.load();
+  while (num_readers_[retired].load() > 0) std::this_thread::yield();
+
+  // Fill the retired buffer, reusing memory where possible, and make it
+  // current.
+  Solution& solution = buffers_[retired];
+  solution.operating_point.t0 = operating_point.t0;
+  solution.operating_point.xs = operating_point.xs;
+  solution.operating_point.us = operating_point.us;
+  solution.strategies = strategies;
+
+  current_.store(retired);
+  num_published_++;
+}
+
+size_t StrategyExecutor::Acquire() const {
+  // Register as a reader of the current buffer, and check that it is still
+  // current, since the publisher only waits for registered readers.
+  while (true) {
+    const size_t buffer = current_.load();
+    num_readers_[buffer]++;
+    if (current_.load() == buffer) return buffer;
+
+    Release(buffer);
+  }
+}
+
+bool StrategyExecutor::ContainsTime(Time t) const {
+  if (num_published_.load() == 0) return false;
+
+  const size_t buffer = Acquire();
+  size_t kk;
+  float frac;
+  const bool contains_time = FindTimeStep(buffers_[buffer], t, &kk, &frac);
+  Release(buffer);
+
+  return contains_time;
+}
+
+bool StrategyExecutor::Control(Time t, const VectorXf& x, PlayerIndex player,
+                               VectorXf* u) const {
+  CHECK_NOTNULL(u);
+  if (num_published_.load() == 0) return false;
+
+  const size_t buffer = Acquire();
+  const bool success = Control(buffers_[buffer], t, x, player, u);
+  Release(buffer);
+
+  return success;
+}
+
+bool StrategyExecutor::Controls(Time t, const VectorXf& x,
+                                std::vector<VectorXf>* us) const {
+  CHECK_NOTNULL(us);
+  if (num_published_.load() == 0) return false;
+
+  // Hold the same buffer for all players, so that they are consistent.
+  const size_t buffer = Acquire();
+  const Solution& solution = buffers_[buffer];
+  CHECK_EQ(us->size(), solution.strategies.size());
+
+  bool success = true;
+  for (PlayerIndex ii = 0; ii < us->size() && success; ii++)
+    success = Control(solution, t, x, ii, &(*us)[ii]);
+  Release(buffer);
+
+  return success;
+}
+
+bool StrategyExecutor::FindTimeStep(const Solution& solution, Time t,
+                                    size_t* kk, float* frac) const {
+  const auto& xs = solution.operating_point.xs;
+  const Time relative_t = t - solution.operating_point.t0;
+  if (xs.empty() || relative_t < 0.0) return false;
+
+  // Add a little so that conversion doesn't end up subtracting 1.
+  *kk = static_cast<size_t>(constants::kSmallNumber + relative_t / time_step_);
+  if (*kk >= xs.size()) return false;
+
+  *frac = std::max(0.0, relative_t / time_step_ - static_cast<Time>(*kk));
+  if (*kk + 1 == xs.size()) {
+    // Only the final time itself is contained.
+    if (*frac > constants::kSmallNumber) return false;
+    *frac = 0.0;
+  }
+
+  return true;
+}
+
+bool StrategyExecutor::Control(const Solution& solution, Time t,
+                               const VectorXf& x, PlayerIndex player,
+                               VectorXf* u) const {
+  CHECK_LT(player, solution.strategies.size());
+
+  size_t kk;
+  float frac;
+  if (!FindTimeStep(solution, t, &kk, &frac)) return false;
+
+  const Strategy& strategy = solution.strategies[player];
+  const OperatingPoint& op = solution.operating_point;
+  CHECK_EQ(u->size(), op.us[kk][player].size());
+
+  // Evaluate u_ref - P (x - x_ref) - alpha, interpolating the reference and
+  // feedforward terms. Products are accumulated directly into the output so
+  // that no temporaries are allocated.
+  const MatrixXf& P = strategy.Ps[kk];
+  u->noalias() = op.us[kk][player] - strategy.alphas[kk];
+  u->noalias() -= P * x;
+  if (frac == 0.0) {
+    u->noalias() += P * op.xs[kk];
+    return true;
+  }
+
+  const float one_minus_frac = 1.0 - frac;
+  *u *= one_minus_frac;
+  u->noalias() += frac * (op.us[kk + 1][player] - strategy.alphas[kk + 1]);
+  u->noalias() -= frac * (P * x);
+  u->noalias() += one_minus_frac * (P * op.xs[kk]);
+  u->noalias() += frac * (P * op.xs[kk + 1]);
+  return true;
+}
+
+}  // namespace ilqgames
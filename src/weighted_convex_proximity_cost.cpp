@@ -45,20 +45,32 @@
 #include <ilqgames/utils/types.h>
 
 #include <glog/logging.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
 
 namespace ilqgames {
 
 float WeightedConvexProximityCost::Evaluate(const VectorXf& input) const {
   const float dx = input(xidx1_) - input(xidx2_);
   const float dy = input(yidx1_) - input(yidx2_);
+  const float abs_dx = std::abs(dx);
+  const float abs_dy = std::abs(dy);
+  if (abs_dx >= threshold_ || abs_dy >= threshold_) return 0.0;
+
+  // Both deltas are positive, so the smaller delta (from the larger
+  // difference) has the smaller square.
+  const float delta = threshold_ - std::max(abs_dx, abs_dy);
   const float vv =
       input(vidx1_) * input(vidx1_) + input(vidx2_) * input(vidx2_);
+  return 0.5 * weight_ * vv * delta * delta;
+}
 
-  if (dx * dx >= threshold_sq_ || dy * dy >= threshold_sq_) return 0.0;
-
-  const float delta_x = (threshold_ - std::abs(dx));
-  const float delta_y = (threshold_ - std::abs(dy));
-  return 0.5 * weight_ * vv * std::min(delta_x * delta_x, delta_y * delta_y);
+bool WeightedConvexProximityCost::IsActive(const VectorXf& input,
+                                           float margin) const {
+  const float radius = threshold_ + margin;
+  return std::abs(input(xidx1_) - input(xidx2_)) < radius &&
+         std::abs(input(yidx1_) - input(yidx2_)) < radius;
 }
 
 void WeightedConvexProximityCost::Quadraticize(const VectorXf& input,
@@ -72,87 +84,70 @@ void WeightedConvexProximityCost::Quadraticize(const VectorXf& input,
   CHECK_EQ(input.size(), hess->cols());
   CHECK_EQ(input.size(), grad->size());
 
-  // Compute Hessian and gradient.
   const float dx = input(xidx1_) - input(xidx2_);
   const float dy = input(yidx1_) - input(yidx2_);
-  const float vv =
-      input(vidx1_) * input(vidx1_) + input(vidx2_) * input(vidx2_);
+  const float abs_dx = std::abs(dx);
+  const float abs_dy = std::abs(dy);
+  if (abs_dx >= threshold_ || abs_dy >= threshold_) return;
+
+  // Which dimension is active, x or y? It is the one with the larger
+  // difference, i.e., the smaller delta. Ties go to x, as in Evaluate.
+  const bool is_x_active = abs_dx >= abs_dy;
+  const Dimension idx1 = (is_x_active) ? xidx1_ : yidx1_;
+  const Dimension idx2 = (is_x_active) ? xidx2_ : yidx2_;
+  const float delta = threshold_ - ((is_x_active) ? abs_dx : abs_dy);
+  const float sign = sgn((is_x_active) ? dx : dy);
+
+  const float v1 = input(vidx1_);
+  const float v2 = input(vidx2_);
+  const float vv = v1 * v1 + v2 * v2;
+
+  // Gradient. Note that d(delta) / d(idx1) = -sign.
+  const float dd1 = -weight_ * vv * delta * sign;
+  (*grad)(idx1) += dd1;
+  (*grad)(idx2) -= dd1;
+  (*grad)(vidx1_) += weight_ * v1 * delta * delta;
+  (*grad)(vidx2_) += weight_ * v2 * delta * delta;
+
+  // Hessian: position block.
+  const float hess_pos = weight_ * vv;
+  (*hess)(idx1, idx1) += hess_pos;
+  (*hess)(idx1, idx2) -= hess_pos;
+  (*hess)(idx2, idx1) -= hess_pos;
+  (*hess)(idx2, idx2) += hess_pos;
+
+  // Hessian: speed block.
+  const float hess_vv = weight_ * delta * delta;
+  (*hess)(vidx1_, vidx1_) += hess_vv;
+  (*hess)(vidx2_, vidx2_) += hess_vv;
+
+  // Hessian: position/speed cross terms, added symmetrically.
+  const float hess_1v1 = -2.0 * weight_ * v1 * delta * sign;
+  const float hess_1v2 = -2.0 * weight_ * v2 * delta * sign;
+  (*hess)(idx1, vidx1_) += hess_1v1;
+  (*hess)(vidx1_, idx1) += hess_1v1;
+  (*hess)(idx1, vidx2_) += hess_1v2;
+  (*hess)(vidx2_, idx1) += hess_1v2;
+  (*hess)(idx2, vidx1_) -= hess_1v1;
+  (*hess)(vidx1_, idx2) -= hess_1v1;
+  (*hess)(idx2, vidx2_) -= hess_1v2;
+  (*hess)(vidx2_, idx2) -= hess_1v2;
+}
+
+bool WeightedConvexProximityCost::ProximityPair(
+    std::pair<Dimension, Dimension>* position_idxs1,
+    std::pair<Dimension, Dimension>* position_idxs2, float* radius) const {
+  CHECK_NOTNULL(position_idxs1);
+  CHECK_NOTNULL(position_idxs2);
+  CHECK_NOTNULL(radius);
+
+  *position_idxs1 = {xidx1_, yidx1_};
+  *position_idxs2 = {xidx2_, yidx2_};
 
-  if (dx * dx >= threshold_sq_ || dy * dy >= threshold_sq_) return;
-
-  // Which dimension is active, x or y?
-  const float delta_x = threshold_ - std::abs(dx);
-  const float delta_y = threshold_ - std::abs(dy);
-
-  const bool is_x_active = delta_x * delta_x < delta_y * delta_y;
-
-  if (is_x_active) {
-    // Hessian.
-    const float hess_v1v1 = weight_ * delta_x * delta_x;
-    (*hess)(vidx1_, vidx1_) += hess_v1v1;
-    (*hess)(vidx2_, vidx2_) += hess_v1v1;
-
-    const float hess_x1v1 = -2.0 * weight_ * input(vidx1_) * sgn(dx);
-    const float hess_x1v2 = -2.0 * weight_ * input(vidx2_) * sgn(dx);
-    const float hess_x2v1 = 2.0 * weight_ * input(vidx1_) * sgn(dx);
-    const float hess_x2v2 = 2.0 * weight_ * input(vidx2_) * sgn(dx);
-    (*hess)(xidx1_, vidx1_) += hess_x1v1;
-    (*hess)(xidx1_, vidx2_) += hess_x1v2;
-    (*hess)(xidx2_, vidx1_) += hess_x2v1;
-    (*hess)(xidx2_, vidx2_) += hess_x2v2;
-    (*hess)(vidx1_, xidx1_) += (*hess)(xidx1_, vidx1_);
-    (*hess)(vidx1_, xidx2_) += (*hess)(xidx2_, vidx1_);
-    (*hess)(vidx2_, xidx1_) += (*hess)(xidx1_, vidx2_);
-    (*hess)(vidx2_, xidx2_) += (*hess)(xidx2_, vidx2_);
-
-    (*hess)(xidx1_, xidx1_) += weight_;
-    (*hess)(xidx1_, xidx2_) -= weight_;
-    (*hess)(xidx2_, xidx1_) -= weight_;
-    (*hess)(xidx2_, xidx2_) += weight_;
-
-    // Gradient.
-    const float ddx1 = -weight_ * delta_x * vv;
-    (*grad)(xidx1_) += ddx1;
-    (*grad)(xidx2_) -= ddx1;
-
-    const float ddv1 = weight_ * input(vidx1_) * delta_x * delta_x;
-    const float ddv2 = weight_ * input(vidx2_) * delta_x * delta_x;
-    (*grad)(vidx1_) += ddv1;
-    (*grad)(vidx2_) += ddv2;
-  } else {
-    // Hessian.
-    const float hess_v1v1 = weight_ * delta_y * delta_y;
-    (*hess)(vidx1_, vidx1_) += hess_v1v1;
-    (*hess)(vidx2_, vidx2_) += hess_v1v1;
-
-    const float hess_y1v1 = -2.0 * weight_ * input(vidx1_) * sgn(dy);
-    const float hess_y1v2 = -2.0 * weight_ * input(vidx2_) * sgn(dy);
-    const float hess_y2v1 = 2.0 * weight_ * input(vidx1_) * sgn(dy);
-    const float hess_y2v2 = 2.0 * weight_ * input(vidx2_) * sgn(dy);
-    (*hess)(yidx1_, vidx1_) += hess_y1v1;
-    (*hess)(yidx1_, vidx2_) += hess_y1v2;
-    (*hess)(yidx2_, vidx1_) += hess_y2v1;
-    (*hess)(yidx2_, vidx2_) += hess_y2v2;
-    (*hess)(vidx1_, yidx1_) += (*hess)(yidx1_, vidx1_);
-    (*hess)(vidx1_, yidx2_) += (*hess)(yidx2_, vidx1_);
-    (*hess)(vidx2_, yidx1_) += (*hess)(yidx1_, vidx2_);
-    (*hess)(vidx2_, yidx2_) += (*hess)(yidx2_, vidx2_);
-
-    (*hess)(yidx1_, yidx1_) += weight_;
-    (*hess)(yidx1_, yidx2_) -= weight_;
-    (*hess)(yidx2_, yidx1_) -= weight_;
-    (*hess)(yidx2_, yidx2_) += weight_;
-
-    // Gradient.
-    const float ddy1 = -weight_ * delta_y * vv;
-    (*grad)(yidx1_) += ddy1;
-    (*grad)(yidx2_) -= ddy1;
-
-    const float ddv1 = weight_ * input(vidx1_) * delta_y * delta_y;
-    const float ddv2 = weight_ * input(vidx2_) * delta_y * delta_y;
-    (*grad)(vidx1_) += ddv1;
-    (*grad)(vidx2_) += ddv2;
-  }
+  // Both coordinates must be within the threshold, so the positions must be
+  // within a circle circumscribing the corresponding square.
+  *radius = std::sqrt(2.0) * threshold_;
+  return true;
 }
 
 }  // namespace ilqgames
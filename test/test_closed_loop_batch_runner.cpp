@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for the closed-loop batch runners, in threads and in sharded worker
+// processes, on an example problem.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/cost/cost.h>
+#include <ilqgames/examples/closed_loop_batch_runner.h>
+#include <ilqgames/examples/receding_horizon_simulator.h>
+#include <ilqgames/examples/sharded_batch_runner.h>
+#include <ilqgames/examples/two_player_collision_example.h>
+#include <ilqgames/solver/solver_params.h>
+#include <ilqgames/solver/top_down_renderable_problem.h>
+#include <ilqgames/utils/types.h>
+
+#include <glog/logging.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ilqgames;
+
+namespace {
+// Batch parameters.
+static constexpr size_t kNumScenarios = 4;
+static constexpr size_t kShardSize = 2;
+static constexpr size_t kNumWorkers = 2;
+static constexpr Time kFinalTime = 2.0;
+static constexpr Time kPlannerRuntime = 0.25;
+static constexpr size_t kMaxSolverIters = 100;
+static constexpr float kAlphaScalingDecrement = 0.05;
+
+// Create an example, with a different linesearch step size in each scenario.
+std::unique_ptr<TopDownRenderableProblem> CreateScenario(size_t scenario) {
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  params.initial_alpha_scaling -= kAlphaScalingDecrement * scenario;
+  return std::unique_ptr<TopDownRenderableProblem>(
+      new TwoPlayerCollisionExample(params));
+}
+
+// Batch parameters for running on the given number of threads.
+ClosedLoopBatchParams BatchParams(size_t num_threads) {
+  ClosedLoopBatchParams params;
+  params.final_time = kFinalTime;
+  params.planner_runtime = kPlannerRuntime;
+  params.solve_time_model = FixedSolveTimeModel(kPlannerRuntime);
+  params.num_threads = num_threads;
+  return params;
+}
+
+// Run a batch of examples on the given number of threads.
+std::vector<ClosedLoopRunStatistics> RunBatch(size_t num_threads) {
+  return RunClosedLoopBatch(kNumScenarios, CreateScenario,
+                            BatchParams(num_threads));
+}
+
+// Run a sharded batch in a new temporary work directory, and clean up. Batch
+// parameters, shard size, number of workers, and work directory are set here.
+ShardedBatchResults RunShardedBatch(
+    const ScenarioFactory& factory,
+    ShardedBatchParams params = ShardedBatchParams()) {
+  char work_directory[] = "/tmp/ilqgames_shards_XXXXXX";
+  CHECK_NOTNULL(mkdtemp(work_directory));
+
+  params.batch = BatchParams(1);
+  params.shard_size = kShardSize;
+  params.num_workers = kNumWorkers;
+  params.work_directory = work_directory;
+  const ShardedBatchResults results =
+      RunShardedClosedLoopBatch(kNumScenarios, factory, params);
+
+  std::remove((params.work_directory + "/runs.txt").c_str());
+  std::remove((params.work_directory + "/quarantined.txt").c_str());
+  rmdir(work_directory);
+  return results;
+}
+
+}  // anonymous namespace
+
+// Check that running scenarios concurrently matches running them one at a
+// time, i.e., that concurrent simulations do not interfere.
+TEST(ClosedLoopBatchRunnerTest, ConcurrentMatchesSequential) {
+  const auto sequential = RunBatch(1);
+  const auto concurrent = RunBatch(kNumScenarios);
+  Cost::ResetInitialTime(0.0);
+
+  ASSERT_EQ(sequential.size(), kNumScenarios);
+  ASSERT_EQ(concurrent.size(), kNumScenarios);
+  for (size_t ii = 0; ii < kNumScenarios; ii++) {
+    EXPECT_EQ(sequential[ii].scenario, ii);
+    EXPECT_EQ(concurrent[ii].scenario, ii);
+    EXPECT_GT(sequential[ii].solve_times.size(), 1);
+    EXPECT_EQ(concurrent[ii].solve_times.size(),
+              sequential[ii].solve_times.size());
+    EXPECT_EQ(concurrent[ii].num_converged, sequential[ii].num_converged);
+    EXPECT_EQ(concurrent[ii].min_distance, sequential[ii].min_distance);
+    EXPECT_EQ(concurrent[ii].mean_total_cost, sequential[ii].mean_total_cost);
+
+    EXPECT_GE(sequential[ii].ConvergenceRate(), 0.0);
+    EXPECT_LE(sequential[ii].ConvergenceRate(), 1.0);
+    EXPECT_LT(sequential[ii].min_distance, constants::kInfinity);
+  }
+}
+
+// Check percentiles against the nearest-rank definition.
+TEST(ClosedLoopBatchRunnerTest, PercentileUsesNearestRank) {
+  const std::vector<Time> times = {10.0, 3.0, 7.0, 1.0, 5.0,
+                                   2.0,  9.0, 4.0, 8.0, 6.0};
+  EXPECT_EQ(Percentile(times, 0.0), 1.0);
+  EXPECT_EQ(Percentile(times, 50.0), 5.0);
+  EXPECT_EQ(Percentile(times, 90.0), 9.0);
+  EXPECT_EQ(Percentile(times, 95.0), 10.0);
+  EXPECT_EQ(Percentile(times, 100.0), 10.0);
+  EXPECT_EQ(Percentile({}, 50.0), 0.0);
+}
+
+// Check that statistics survive being written and read back, including
+// infinite values.
+TEST(ShardedBatchRunnerTest, RunStatisticsRoundTrip) {
+  ClosedLoopRunStatistics run;
+  run.scenario = 7;
+  run.solve_times = {0.1, 1.0 / 3.0, 2.5e-4};
+  run.num_converged = 2;
+  run.mean_total_cost = 12345.678;
+
+  std::stringstream stream;
+  WriteClosedLoopRun(run, &stream);
+
+  ClosedLoopRunStatistics read;
+  ASSERT_TRUE(ReadClosedLoopRun(&stream, &read));
+  EXPECT_EQ(read.scenario, run.scenario);
+  EXPECT_EQ(read.solve_times, run.solve_times);
+  EXPECT_EQ(read.num_converged, run.num_converged);
+  EXPECT_TRUE(std::isinf(read.min_distance));
+  EXPECT_EQ(read.mean_total_cost, run.mean_total_cost);
+  EXPECT_FALSE(ReadClosedLoopRun(&stream, &read));
+}
+
+// Check that sharded runs match running all scenarios in this process.
+TEST(ShardedBatchRunnerTest, MatchesInProcessBatch) {
+  Cost::ResetInitialTime(0.0);
+  const auto expected = RunBatch(1);
+  const ShardedBatchResults results = RunShardedBatch(CreateScenario);
+  Cost::ResetInitialTime(0.0);
+
+  EXPECT_TRUE(results.quarantined_scenarios.empty());
+  ASSERT_EQ(results.runs.size(), kNumScenarios);
+  for (size_t ii = 0; ii < kNumScenarios; ii++) {
+    EXPECT_EQ(results.runs[ii].scenario, ii);
+    EXPECT_EQ(results.runs[ii].solve_times.size(),
+              expected[ii].solve_times.size());
+    EXPECT_EQ(results.runs[ii].num_converged, expected[ii].num_converged);
+    EXPECT_EQ(results.runs[ii].min_distance, expected[ii].min_distance);
+    EXPECT_EQ(results.runs[ii].mean_total_cost, expected[ii].mean_total_cost);
+  }
+}
+
+// Check that a crashing scenario is quarantined without losing the others.
+TEST(ShardedBatchRunnerTest, QuarantinesCrashingScenario) {
+  constexpr size_t kCrashingScenario = 2;
+  const ScenarioFactory factory = [](size_t scenario) {
+    if (scenario == kCrashingScenario) std::abort();
+    return CreateScenario(scenario);
+  };  // factory
+
+  const ShardedBatchResults results = RunShardedBatch(factory);
+  Cost::ResetInitialTime(0.0);
+
+  ASSERT_EQ(results.quarantined_scenarios.size(), 1);
+  EXPECT_EQ(results.quarantined_scenarios.front(), kCrashingScenario);
+  ASSERT_EQ(results.runs.size(), kNumScenarios - 1);
+  for (const auto& run : results.runs) {
+    EXPECT_NE(run.scenario, kCrashingScenario);
+    EXPECT_GT(run.solve_times.size(), 0);
+  }
+}
+
+// Check that a hanging scenario is killed and quarantined without losing the
+// others.
+TEST(ShardedBatchRunnerTest, QuarantinesHangingScenario) {
+  constexpr size_t kHangingScenario = 1;
+  constexpr Time kShardTimeout = 3.0;
+  const ScenarioFactory factory = [](size_t scenario) {
+    if (scenario == kHangingScenario) {
+      for (;;) std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+
+    return CreateScenario(scenario);
+  };  // factory
+
+  ShardedBatchParams params;
+  params.max_attempts = 1;
+  params.shard_timeout = kShardTimeout;
+  const ShardedBatchResults results = RunShardedBatch(factory, params);
+  Cost::ResetInitialTime(0.0);
+
+  ASSERT_EQ(results.quarantined_scenarios.size(), 1);
+  EXPECT_EQ(results.quarantined_scenarios.front(), kHangingScenario);
+  ASSERT_EQ(results.runs.size(), kNumScenarios - 1);
+  for (const auto& run : results.runs) {
+    EXPECT_NE(run.scenario, kHangingScenario);
+    EXPECT_GT(run.solve_times.size(), 0);
+  }
+}
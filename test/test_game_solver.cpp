@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for the iterative game solver on an example problem.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/cost/cost.h>
+#include <ilqgames/examples/two_player_collision_example.h>
+#include <ilqgames/solver/game_solver.h>
+#include <ilqgames/solver/solution_splicer.h>
+#include <ilqgames/solver/solver_params.h>
+#include <ilqgames/solver/solver_statistics.h>
+#include <ilqgames/utils/cancellation_token.h>
+#include <ilqgames/utils/operating_point.h>
+#include <ilqgames/utils/solver_log.h>
+#include <ilqgames/utils/types.h>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+using namespace ilqgames;
+
+namespace {
+// Maximum number of solver iterations.
+static constexpr size_t kMaxSolverIters = 100;
+
+// Solve the example with the given parameters, and return the problem.
+std::unique_ptr<TwoPlayerCollisionExample> SolveExample(
+    const SolverParams& params) {
+  std::unique_ptr<TwoPlayerCollisionExample> problem(
+      new TwoPlayerCollisionExample(params));
+  problem->Solve();
+  return problem;
+}
+
+// Maximum elementwise difference between states in two operating points.
+float MaxStateDifference(const OperatingPoint& op1, const OperatingPoint& op2) {
+  EXPECT_EQ(op1.xs.size(), op2.xs.size());
+
+  float difference = 0.0;
+  for (size_t kk = 0; kk < op1.xs.size(); kk++) {
+    difference =
+        std::max(difference, (op1.xs[kk] - op2.xs[kk]).cwiseAbs().maxCoeff());
+  }
+
+  return difference;
+}
+
+}  // anonymous namespace
+
+// Check that incremental approximation with zero tolerance only reuses exact
+// approximations, and so reproduces the full solve.
+TEST(GameSolverTest, IncrementalApproximationMatchesWithZeroTolerance) {
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  const auto full = SolveExample(params);
+  const SolverStatistics& full_stats = full->Solver().Statistics();
+  EXPECT_GT(full_stats.num_iterations, 0);
+  EXPECT_GT(full_stats.num_linearizations, 0);
+  EXPECT_EQ(full_stats.num_linearization_hits, 0);
+  EXPECT_EQ(full_stats.num_quadraticization_hits, 0);
+
+  params.incremental_approximation = true;
+  params.incremental_tolerance = 0.0;
+  const auto incremental = SolveExample(params);
+  const SolverStatistics& incremental_stats =
+      incremental->Solver().Statistics();
+  EXPECT_EQ(incremental_stats.num_iterations, full_stats.num_iterations);
+  EXPECT_EQ(incremental_stats.num_quadraticizations,
+            full_stats.num_quadraticizations);
+  EXPECT_EQ(MaxStateDifference(full->CurrentOperatingPoint(),
+                               incremental->CurrentOperatingPoint()),
+            0.0);
+}
+
+// Check that a loose tolerance results in cached approximations being reused.
+TEST(GameSolverTest, IncrementalApproximationReusesUnchangedTimeSteps) {
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  params.incremental_approximation = true;
+  params.incremental_tolerance = 1e-2;
+  const auto problem = SolveExample(params);
+
+  const SolverStatistics& stats = problem->Solver().Statistics();
+  EXPECT_GT(stats.num_iterations, 1);
+  EXPECT_GT(stats.LinearizationHitRate(), 0.0);
+  EXPECT_GT(stats.QuadraticizationHitRate(), 0.0);
+  EXPECT_LE(stats.LinearizationHitRate(), 1.0);
+  EXPECT_LE(stats.QuadraticizationHitRate(), 1.0);
+}
+
+// Check that skipping inactive cost terms does not change the solution.
+TEST(GameSolverTest, SkippingInactiveCostsMatchesFullQuadraticization) {
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  params.skip_inactive_costs = false;
+  const auto full = SolveExample(params);
+  EXPECT_EQ(full->Solver().Statistics().num_activity_terms, 0);
+
+  params.skip_inactive_costs = true;
+  const auto skipping = SolveExample(params);
+  const SolverStatistics& stats = skipping->Solver().Statistics();
+  EXPECT_EQ(stats.num_iterations, full->Solver().Statistics().num_iterations);
+  EXPECT_GT(stats.SkipRatio(), 0.0);
+  EXPECT_LE(stats.SkipRatio(), 1.0);
+  EXPECT_LT(MaxStateDifference(full->CurrentOperatingPoint(),
+                               skipping->CurrentOperatingPoint()),
+            constants::kSmallNumber);
+}
+
+// Check that a solve cancelled from the progress callback stops at the next
+// iteration, and leaves the problem's solution unchanged.
+TEST(GameSolverTest, CancellationStopsSolve) {
+  constexpr size_t kCancelAfterIters = 2;
+
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  TwoPlayerCollisionExample problem(params);
+  const OperatingPoint initial_operating_point(problem.CurrentOperatingPoint());
+
+  CancellationToken token;
+  size_t num_callbacks = 0;
+  problem.Solve(std::numeric_limits<Time>::infinity(), &token,
+                [&token, &num_callbacks](size_t num_iterations,
+                                         const OperatingPoint& op,
+                                         const std::vector<float>& costs) {
+                  num_callbacks++;
+                  EXPECT_EQ(num_iterations, num_callbacks);
+                  EXPECT_EQ(costs.size(), 2);
+                  if (num_iterations == kCancelAfterIters) token.Cancel();
+                });
+
+  const SolverStatistics& stats = problem.Solver().Statistics();
+  EXPECT_TRUE(stats.was_cancelled);
+  EXPECT_EQ(stats.num_iterations, kCancelAfterIters);
+  EXPECT_EQ(num_callbacks, kCancelAfterIters);
+  EXPECT_EQ(MaxStateDifference(initial_operating_point,
+                               problem.CurrentOperatingPoint()),
+            0.0);
+}
+
+// Check that an asynchronous solve matches a blocking solve, and reports
+// progress at every iteration.
+TEST(GameSolverTest, AsynchronousSolveMatchesBlockingSolve) {
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  const auto blocking = SolveExample(params);
+
+  TwoPlayerCollisionExample problem(params);
+  std::atomic<size_t> num_callbacks(0);
+  auto future = problem.SolveAsync(
+      std::numeric_limits<Time>::infinity(),
+      std::make_shared<CancellationToken>(),
+      [&num_callbacks](size_t num_iterations, const OperatingPoint& op,
+                       const std::vector<float>& costs) { num_callbacks++; });
+  const std::shared_ptr<SolverLog> log = future.get();
+
+  const SolverStatistics& stats = problem.Solver().Statistics();
+  EXPECT_FALSE(stats.was_cancelled);
+  EXPECT_EQ(stats.num_iterations,
+            blocking->Solver().Statistics().num_iterations);
+  EXPECT_EQ(num_callbacks.load(), stats.num_iterations);
+  EXPECT_EQ(log->NumIterates(), stats.num_iterations + 1);
+  EXPECT_EQ(MaxStateDifference(blocking->CurrentOperatingPoint(),
+                               problem.CurrentOperatingPoint()),
+            0.0);
+}
+
+// Check that setting up the next receding horizon problem by searching for the
+// nearest state within a window, or within a window and then (upon exceeding
+// the distance threshold) the entire plan, matches searching the entire plan.
+TEST(GameSolverTest, WindowedNearestStateSearchMatchesFullSearch) {
+  constexpr size_t kElapsedTimeSteps = 10;
+  constexpr Time kTimeOffset = 0.02;
+  constexpr Time kPlannerRuntime = 0.25;
+
+  // Set up the next problem from a state along the existing plan. Setting up
+  // the next problem resets the initial time for all costs, so reset it before
+  // each solve.
+  auto set_up_next_problem = [](const SolverParams& params) {
+    Cost::ResetInitialTime(0.0);
+    auto problem = SolveExample(params);
+    const OperatingPoint& op = problem->CurrentOperatingPoint();
+    const VectorXf x = op.xs[kElapsedTimeSteps];
+    const Time t = op.t0 + kTimeOffset +
+                   problem->Solver().ComputeTimeStamp(kElapsedTimeSteps);
+    problem->SetUpNextRecedingHorizon(x, t, kPlannerRuntime);
+    return problem;
+  };
+
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  params.nearest_state_search_radius = std::numeric_limits<size_t>::max() / 2;
+  const auto full = set_up_next_problem(params);
+
+  params.nearest_state_search_radius = 2;
+  const auto windowed = set_up_next_problem(params);
+
+  params.nearest_state_search_radius = 0;
+  params.nearest_state_distance_threshold = 0.0;
+  const auto fallback = set_up_next_problem(params);
+
+  for (const auto& problem : {windowed.get(), fallback.get()}) {
+    EXPECT_TRUE(problem->InitialState() == full->InitialState());
+    EXPECT_EQ(problem->CurrentOperatingPoint().t0,
+              full->CurrentOperatingPoint().t0);
+    EXPECT_EQ(MaxStateDifference(problem->CurrentOperatingPoint(),
+                                 full->CurrentOperatingPoint()),
+              0.0);
+  }
+
+  Cost::ResetInitialTime(0.0);
+}
+
+// Check that setting up the next receding horizon problem by reading the
+// existing plan directly from a solution splicer matches setting it up from the
+// problem's own copy of that plan.
+TEST(GameSolverTest, SplicedSetUpMatchesContiguousSetUp) {
+  constexpr size_t kElapsedTimeSteps = 10;
+  constexpr Time kTimeOffset = 0.02;
+  constexpr Time kPlannerRuntime = 0.25;
+
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  Cost::ResetInitialTime(0.0);
+  TwoPlayerCollisionExample spliced(params);
+  const SolutionSplicer splicer(spliced.Solve());
+
+  Cost::ResetInitialTime(0.0);
+  const auto contiguous = SolveExample(params);
+
+  const OperatingPoint& op = contiguous->CurrentOperatingPoint();
+  const VectorXf x = op.xs[kElapsedTimeSteps];
+  const Time t = op.t0 + kTimeOffset +
+                 contiguous->Solver().ComputeTimeStamp(kElapsedTimeSteps);
+  contiguous->SetUpNextRecedingHorizon(x, t, kPlannerRuntime);
+  spliced.SetUpNextRecedingHorizon(splicer, x, t, kPlannerRuntime);
+
+  EXPECT_LT((spliced.InitialState() - contiguous->InitialState())
+                .cwiseAbs()
+                .maxCoeff(),
+            constants::kSmallNumber);
+  EXPECT_NEAR(spliced.CurrentOperatingPoint().t0,
+              contiguous->CurrentOperatingPoint().t0, constants::kSmallNumber);
+  EXPECT_LT(MaxStateDifference(spliced.CurrentOperatingPoint(),
+                               contiguous->CurrentOperatingPoint()),
+            constants::kSmallNumber);
+
+  Cost::ResetInitialTime(0.0);
+}
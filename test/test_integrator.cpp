@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for Integrator.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/dynamics/concatenated_dynamical_system.h>
+#include <ilqgames/dynamics/integrator.h>
+#include <ilqgames/dynamics/single_player_unicycle_4d.h>
+#include <ilqgames/utils/types.h>
+
+#include <gtest/gtest.h>
+#include <math.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ilqgames;
+
+namespace {
+
+// Harmonic oscillator with a time-varying forcing term, so that the exact
+// solution is known in closed form.
+void Oscillator(Time t, const VectorXf& x, VectorXf* x_dot) {
+  x_dot->resize(2);
+  (*x_dot)(0) = x(1);
+  (*x_dot)(1) = -x(0) + std::cos(t);
+}
+
+// Exact solution from x(0) = (1, 0).
+VectorXf ExactOscillator(Time t) {
+  VectorXf x(2);
+  x(0) = std::cos(t) + 0.5 * t * std::sin(t);
+  x(1) = -0.5 * std::sin(t) + 0.5 * t * std::cos(t);
+  return x;
+}
+
+// Integrate the oscillator with the given method, and return the error.
+float IntegrationError(IntegrationMethod method, size_t num_substeps) {
+  constexpr Time kTimeInterval = 2.0;
+  Integrator integrator(method, num_substeps);
+
+  VectorXf x = VectorXf::Zero(2);
+  x(0) = 1.0;
+  integrator.Integrate(Oscillator, 0.0, kTimeInterval, &x);
+  return (x - ExactOscillator(kTimeInterval)).lpNorm<Eigen::Infinity>();
+}
+
+}  // anonymous namespace
+
+// Check that each method converges at the expected rate.
+TEST(IntegratorTest, FixedStepMethodsConverge) {
+  constexpr size_t kNumSubsteps = 20;
+
+  // Euler is first order, Heun second order, and RK4 fourth order, so
+  // doubling the number of substeps should shrink the error accordingly.
+  const float euler_ratio =
+      IntegrationError(IntegrationMethod::EULER, kNumSubsteps) /
+      IntegrationError(IntegrationMethod::EULER, 2 * kNumSubsteps);
+  const float heun_ratio =
+      IntegrationError(IntegrationMethod::HEUN, kNumSubsteps) /
+      IntegrationError(IntegrationMethod::HEUN, 2 * kNumSubsteps);
+  const float rk4_ratio =
+      IntegrationError(IntegrationMethod::RK4, kNumSubsteps / 4) /
+      IntegrationError(IntegrationMethod::RK4, kNumSubsteps / 2);
+  EXPECT_NEAR(euler_ratio, 2.0, 0.5);
+  EXPECT_NEAR(heun_ratio, 4.0, 1.0);
+  EXPECT_NEAR(rk4_ratio, 16.0, 4.0);
+
+  EXPECT_LT(IntegrationError(IntegrationMethod::RK4, kNumSubsteps),
+            IntegrationError(IntegrationMethod::HEUN, kNumSubsteps));
+  EXPECT_LT(IntegrationError(IntegrationMethod::HEUN, kNumSubsteps),
+            IntegrationError(IntegrationMethod::EULER, kNumSubsteps));
+}
+
+// Check that adaptive integration meets its tolerance even from a single
+// initial substep.
+TEST(IntegratorTest, AdaptiveMethodMeetsTolerance) {
+  EXPECT_LT(IntegrationError(IntegrationMethod::RK45, 1), 1e-3);
+}
+
+// Check that adaptive integration reuses the last stage of each step as the
+// first stage of the next, so each step costs six derivative evaluations.
+TEST(IntegratorTest, AdaptiveMethodReusesLastStage) {
+  size_t num_evaluations = 0;
+  const auto oscillator = [&num_evaluations](Time t, const VectorXf& x,
+                                             VectorXf* x_dot) {
+    num_evaluations++;
+    Oscillator(t, x, x_dot);
+  };  // oscillator
+
+  Integrator integrator(IntegrationMethod::RK45, 1);
+  VectorXf x = VectorXf::Zero(2);
+  x(0) = 1.0;
+  integrator.Integrate(oscillator, 0.0, 2.0, &x);
+  EXPECT_GT(num_evaluations, 1);
+  EXPECT_EQ((num_evaluations - 1) % 6, 0);
+}
+
+// Check that adaptive integration fails loudly rather than stopping short of
+// the final time when its tolerances cannot be met.
+TEST(IntegratorTest, AdaptiveMethodChecksFinalTimeReached) {
+  Integrator integrator(IntegrationMethod::RK45, 1);
+  integrator.SetTolerances(1e-12, 0.0);
+
+  VectorXf x = VectorXf::Zero(2);
+  x(0) = 1.0;
+  ASSERT_DEATH(integrator.Integrate(Oscillator, 0.0, 2.0, &x),
+               "did not reach final time");
+}
+
+// Check that integrating shared dynamics with a caller's own integrator does
+// not affect other callers, and that default integration is safe to call
+// concurrently.
+TEST(IntegratorTest, SharedDynamicsIntegrateIndependently) {
+  constexpr Time kTimeStep = 0.1;
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kNumIntegrations = 1000;
+  const ConcatenatedDynamicalSystem dynamics(
+      {std::make_shared<SinglePlayerUnicycle4D>(),
+       std::make_shared<SinglePlayerUnicycle4D>()},
+      kTimeStep);
+
+  const VectorXf x0 = VectorXf::Random(dynamics.XDim());
+  std::vector<VectorXf> us;
+  for (PlayerIndex ii = 0; ii < dynamics.NumPlayers(); ii++)
+    us.emplace_back(VectorXf::Random(dynamics.UDim(ii)));
+
+  // By default, integrate with RK4 and two substeps.
+  const VectorXf expected = dynamics.Integrate(0.0, kTimeStep, x0, us);
+  Integrator rk4(IntegrationMethod::RK4, 2);
+  EXPECT_TRUE(dynamics.Integrate(0.0, kTimeStep, x0, us, &rk4) == expected);
+
+  // Another caller's integrator should not change the default.
+  Integrator euler(IntegrationMethod::EULER, 1);
+  EXPECT_FALSE(dynamics.Integrate(0.0, kTimeStep, x0, us, &euler) == expected);
+  EXPECT_TRUE(dynamics.Integrate(0.0, kTimeStep, x0, us) == expected);
+
+  // Integrate concurrently, with and without integrators of each thread's own.
+  std::atomic<size_t> num_mismatches(0);
+  std::vector<std::thread> threads;
+  for (size_t ii = 0; ii < kNumThreads; ii++) {
+    threads.emplace_back([&, ii]() {
+      Integrator integrator(IntegrationMethod::RK4, 2);
+      for (size_t kk = 0; kk < kNumIntegrations; kk++) {
+        const VectorXf x =
+            (ii % 2 == 0)
+                ? dynamics.Integrate(0.0, kTimeStep, x0, us)
+                : dynamics.Integrate(0.0, kTimeStep, x0, us, &integrator);
+        if (!(x == expected)) num_mismatches++;
+      }
+    });
+  }
+
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(num_mismatches, 0);
+}
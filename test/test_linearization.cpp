@@ -41,17 +41,24 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <ilqgames/dynamics/concatenated_dynamical_system.h>
+#include <ilqgames/dynamics/concatenated_flat_system.h>
 #include <ilqgames/dynamics/single_player_car_5d.h>
 #include <ilqgames/dynamics/single_player_car_6d.h>
 #include <ilqgames/dynamics/single_player_car_7d.h>
+#include <ilqgames/dynamics/single_player_dubins_car.h>
+#include <ilqgames/dynamics/single_player_flat_car_6d.h>
+#include <ilqgames/dynamics/single_player_flat_unicycle_4d.h>
 #include <ilqgames/dynamics/single_player_unicycle_4d.h>
 #include <ilqgames/dynamics/single_player_unicycle_5d.h>
 #include <ilqgames/dynamics/two_player_unicycle_4d.h>
+#include <ilqgames/utils/quadratic_cost_approximation.h>
 #include <ilqgames/utils/types.h>
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <memory>
 #include <random>
+#include <thread>
 
 using namespace ilqgames;
 
@@ -232,3 +239,184 @@ TEST(ConcatenatedDynamicalSystemTest, LinearizesCorrectly) {
       kTimeStep);
   CheckLinearization(system);
 }
+
+TEST(ConcatenatedDynamicalSystemTest, LinearizesBatchCorrectly) {
+  const ConcatenatedDynamicalSystem system(
+      {std::make_shared<SinglePlayerUnicycle4D>(),
+       std::make_shared<SinglePlayerUnicycle5D>(),
+       std::make_shared<SinglePlayerCar5D>(1.0),
+       std::make_shared<SinglePlayerCar6D>(1.0),
+       std::make_shared<SinglePlayerCar7D>(1.0),
+       std::make_shared<SinglePlayerDubinsCar>(2.0)},
+      kTimeStep);
+
+  // Random trajectory.
+  constexpr size_t kNumTimeSteps = 25;
+  constexpr Time kInitialTime = 1.0;
+  std::vector<VectorXf> xs(kNumTimeSteps);
+  std::vector<std::vector<VectorXf>> us(kNumTimeSteps);
+  for (size_t kk = 0; kk < kNumTimeSteps; kk++) {
+    xs[kk] = VectorXf::Random(system.XDim());
+    for (PlayerIndex ii = 0; ii < system.NumPlayers(); ii++)
+      us[kk].push_back(VectorXf::Random(system.UDim(ii)));
+  }
+
+  // Start from stale linearizations to make sure they are reset.
+  std::vector<LinearDynamicsApproximation> batch(
+      kNumTimeSteps, LinearDynamicsApproximation(system));
+  for (auto& lin : batch) {
+    lin.A.setRandom();
+    for (auto& B : lin.Bs) B.setRandom();
+  }
+
+  system.LinearizeBatch(kInitialTime, xs, us, &batch);
+  ASSERT_EQ(batch.size(), kNumTimeSteps);
+  for (size_t kk = 0; kk < kNumTimeSteps; kk++) {
+    const LinearDynamicsApproximation expected = system.Linearize(
+        kInitialTime + kTimeStep * static_cast<Time>(kk), xs[kk], us[kk]);
+    EXPECT_LT((batch[kk].A - expected.A).cwiseAbs().maxCoeff(),
+              constants::kSmallNumber);
+    for (PlayerIndex ii = 0; ii < system.NumPlayers(); ii++)
+      EXPECT_LT((batch[kk].Bs[ii] - expected.Bs[ii]).cwiseAbs().maxCoeff(),
+                constants::kSmallNumber);
+  }
+}
+
+TEST(ConcatenatedFlatSystemTest, DiscretizesExactly) {
+  const ConcatenatedFlatSystem system(
+      {std::make_shared<SinglePlayerFlatUnicycle4D>(),
+       std::make_shared<SinglePlayerFlatCar6D>(1.0)},
+      kTimeStep);
+
+  // Compare a single exact discrete time step with integrating the continuous
+  // time system over two half steps.
+  for (size_t ii = 0; ii < 10; ii++) {
+    const VectorXf xi(VectorXf::Random(system.XDim()));
+    std::vector<VectorXf> vs(system.NumPlayers());
+    for (size_t jj = 0; jj < system.NumPlayers(); jj++)
+      vs[jj] = VectorXf::Random(system.UDim(jj));
+
+    const VectorXf exact = system.Integrate(kTimeStep, xi, vs);
+    const VectorXf integrated = system.Integrate(
+        0.5 * kTimeStep, system.Integrate(0.5 * kTimeStep, xi, vs), vs);
+    EXPECT_NEAR((exact - integrated).cwiseAbs().maxCoeff(), 0.0,
+                constants::kSmallNumber);
+  }
+}
+
+TEST(ConcatenatedFlatSystemTest, ChangesCostCoordinatesCorrectly) {
+  const ConcatenatedFlatSystem system(
+      {std::make_shared<SinglePlayerFlatUnicycle4D>(),
+       std::make_shared<SinglePlayerFlatCar6D>(1.0)},
+      kTimeStep);
+
+  // Quadratic cost in x, i.e., f(x) = l^T (x - x0) + 0.5 (x - x0)^T Q (x - x0).
+  const MatrixXf root(MatrixXf::Random(system.XDim(), system.XDim()));
+  const MatrixXf Q = root.transpose() * root;
+  const VectorXf l(VectorXf::Random(system.XDim()));
+
+  // Gradient of f with respect to xi at the given point, computed by changing
+  // cost coordinates of the quadratic expansion of f at x(xi), reusing the
+  // same buffers each time.
+  CostCoordinateBuffers buffers;
+  auto change_coordinates = [&system, &Q, &l, &buffers](const VectorXf& x0,
+                                                        const VectorXf& xi) {
+    const VectorXf dx = system.FromLinearSystemState(xi) - x0;
+    std::vector<QuadraticCostApproximation> q(
+        system.NumPlayers(), QuadraticCostApproximation(system.XDim()));
+    for (auto& quad : q) {
+      quad.state.hess = Q;
+      quad.state.grad = l + Q * dx;
+    }
+
+    system.ChangeCostCoordinates(xi, &q, &buffers);
+    return q.front().state;
+  };
+
+  constexpr float kStepSize = 1e-2;
+  for (size_t ii = 0; ii < 10; ii++) {
+    // Keep velocities well away from the singularity at zero.
+    VectorXf xi(VectorXf::Random(system.XDim()));
+    xi(SinglePlayerFlatUnicycle4D::kVxIdx) += 2.0;
+    xi(system.SubsystemStartDim(1) + SinglePlayerFlatCar6D::kVxIdx) += 2.0;
+
+    const VectorXf x0 = system.FromLinearSystemState(xi);
+    const SingleCostApproximation transformed = change_coordinates(x0, xi);
+
+    // Check gradient against central differences of f, and Hessian against
+    // central differences of the gradient.
+    auto cost = [&system, &Q, &l, &x0](const VectorXf& xi) {
+      const VectorXf dx = system.FromLinearSystemState(xi) - x0;
+      return l.dot(dx) + 0.5 * dx.dot(Q * dx);
+    };
+
+    VectorXf numerical_grad(system.XDim());
+    MatrixXf numerical_hess(system.XDim(), system.XDim());
+    for (Dimension jj = 0; jj < system.XDim(); jj++) {
+      VectorXf xi_plus(xi), xi_minus(xi);
+      xi_plus(jj) += kStepSize;
+      xi_minus(jj) -= kStepSize;
+
+      numerical_grad(jj) = (cost(xi_plus) - cost(xi_minus)) / (2.0 * kStepSize);
+      numerical_hess.col(jj) = (change_coordinates(x0, xi_plus).grad -
+                                change_coordinates(x0, xi_minus).grad) /
+                               (2.0 * kStepSize);
+    }
+
+    const float grad_scale = 1.0 + numerical_grad.cwiseAbs().maxCoeff();
+    EXPECT_LT((transformed.grad - numerical_grad).cwiseAbs().maxCoeff(),
+              1e-2 * grad_scale);
+
+    const float hess_scale = 1.0 + numerical_hess.cwiseAbs().maxCoeff();
+    EXPECT_LT((transformed.hess - numerical_hess).cwiseAbs().maxCoeff(),
+              1e-2 * hess_scale);
+  }
+}
+
+TEST(ConcatenatedFlatSystemTest, ChangesCostCoordinatesConcurrently) {
+  constexpr size_t kNumThreads = 4;
+  constexpr size_t kNumChanges = 100;
+  const ConcatenatedFlatSystem system(
+      {std::make_shared<SinglePlayerFlatUnicycle4D>(),
+       std::make_shared<SinglePlayerFlatUnicycle4D>()},
+      kTimeStep);
+
+  // Keep velocities well away from the singularity at zero.
+  VectorXf xi(VectorXf::Random(system.XDim()));
+  xi(SinglePlayerFlatUnicycle4D::kVxIdx) += 2.0;
+  xi(system.SubsystemStartDim(1) + SinglePlayerFlatUnicycle4D::kVxIdx) += 2.0;
+
+  const MatrixXf root(MatrixXf::Random(system.XDim(), system.XDim()));
+  std::vector<QuadraticCostApproximation> original(
+      system.NumPlayers(), QuadraticCostApproximation(system.XDim()));
+  for (auto& quad : original) {
+    quad.state.hess = root.transpose() * root;
+    quad.state.grad = VectorXf::Random(system.XDim());
+  }
+
+  std::vector<QuadraticCostApproximation> expected(original);
+  system.ChangeCostCoordinates(xi, &expected);
+
+  // Change coordinates concurrently, with and without buffers of each thread's
+  // own.
+  std::atomic<size_t> num_mismatches(0);
+  std::vector<std::thread> threads;
+  for (size_t ii = 0; ii < kNumThreads; ii++) {
+    threads.emplace_back([&, ii]() {
+      CostCoordinateBuffers buffers;
+      for (size_t kk = 0; kk < kNumChanges; kk++) {
+        std::vector<QuadraticCostApproximation> q(original);
+        system.ChangeCostCoordinates(xi, &q,
+                                     (ii % 2 == 0) ? nullptr : &buffers);
+        for (PlayerIndex jj = 0; jj < system.NumPlayers(); jj++) {
+          if (!(q[jj].state.hess == expected[jj].state.hess) ||
+              !(q[jj].state.grad == expected[jj].state.grad))
+            num_mismatches++;
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(num_mismatches, 0);
+}
@@ -40,14 +40,29 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <ilqgames/cost/final_time_cost.h>
+#include <ilqgames/cost/nominal_path_length_cost.h>
+#include <ilqgames/cost/locally_convex_proximity_cost.h>
 #include <ilqgames/cost/player_cost.h>
+#include <ilqgames/cost/proximity_cost.h>
 #include <ilqgames/cost/quadratic_cost.h>
+#include <ilqgames/cost/quadratic_polyline2_cost.h>
+#include <ilqgames/cost/route_progress_cost.h>
+#include <ilqgames/cost/semiquadratic_cost.h>
+#include <ilqgames/cost/semiquadratic_polyline2_cost.h>
+#include <ilqgames/cost/shared_proximity_terms.h>
+#include <ilqgames/cost/weighted_convex_proximity_cost.h>
+#include <ilqgames/geometry/polyline2.h>
+#include <ilqgames/geometry/proximity_broad_phase.h>
 #include <ilqgames/utils/quadratic_cost_approximation.h>
 #include <ilqgames/utils/types.h>
 
 #include <gtest/gtest.h>
 #include <math.h>
+#include <algorithm>
 #include <memory>
+#include <utility>
+#include <vector>
 
 using namespace ilqgames;
 
@@ -56,6 +71,75 @@ namespace {
 static constexpr float kCostWeight = 1.0;
 static constexpr size_t kNumPlayers = 2;
 static constexpr Dimension kVectorDimension = 5;
+
+// Dimension of each agent's state (x, y, v) in multi-agent tests.
+static constexpr Dimension kAgentDimension = 3;
+
+// Input dimensions of the given agent's position and speed.
+std::pair<Dimension, Dimension> PositionIdxs(size_t agent) {
+  const Dimension xidx = kAgentDimension * static_cast<Dimension>(agent);
+  return {xidx, xidx + 1};
+}
+Dimension SpeedIdx(size_t agent) {
+  return kAgentDimension * static_cast<Dimension>(agent) + 2;
+}
+
+// Controls for each player, for tests with only state costs.
+std::vector<VectorXf> ZeroControls() {
+  return std::vector<VectorXf>(kNumPlayers, VectorXf::Zero(1));
+}
+
+// Expect the given cost and quadraticization to match the expected ones.
+void ExpectSameCostAndQuadraticization(
+    float value, const QuadraticCostApproximation& quad, float expected_value,
+    const QuadraticCostApproximation& expected) {
+  EXPECT_NEAR(value, expected_value, constants::kSmallNumber);
+  EXPECT_LT((quad.state.hess - expected.state.hess).lpNorm<Eigen::Infinity>(),
+            constants::kSmallNumber);
+  EXPECT_LT((quad.state.grad - expected.state.grad).lpNorm<Eigen::Infinity>(),
+            constants::kSmallNumber);
+
+  ASSERT_EQ(quad.control.size(), expected.control.size());
+  for (const auto& pair : expected.control) {
+    const auto& control = quad.control.at(pair.first);
+    EXPECT_LT((control.hess - pair.second.hess).lpNorm<Eigen::Infinity>(),
+              constants::kSmallNumber);
+    EXPECT_LT((control.grad - pair.second.grad).lpNorm<Eigen::Infinity>(),
+              constants::kSmallNumber);
+  }
+}
+
+// Expect the given player costs to match at the given time, state, and
+// controls.
+void ExpectSameCostAndQuadraticization(const PlayerCost& player_cost,
+                                       const PlayerCost& expected_player_cost,
+                                       Time t, const VectorXf& x,
+                                       const std::vector<VectorXf>& us) {
+  ExpectSameCostAndQuadraticization(
+      player_cost.Evaluate(t, x, us), player_cost.Quadraticize(t, x, us),
+      expected_player_cost.Evaluate(t, x, us),
+      expected_player_cost.Quadraticize(t, x, us));
+}
+
+// Expect the given player cost, which has only state costs, to match the sum
+// of the given costs evaluated on their own at the given time and state.
+void ExpectMatchesStandaloneCosts(
+    const PlayerCost& player_cost,
+    const std::vector<std::shared_ptr<Cost>>& costs, Time t,
+    const VectorXf& x) {
+  float expected_value = 0.0;
+  QuadraticCostApproximation expected(x.size());
+  for (const auto& cost : costs) {
+    expected_value += cost->Evaluate(t, x);
+    cost->Quadraticize(t, x, &expected.state.hess, &expected.state.grad);
+  }
+
+  const std::vector<VectorXf> us = ZeroControls();
+  ExpectSameCostAndQuadraticization(player_cost.Evaluate(t, x, us),
+                                    player_cost.Quadraticize(t, x, us),
+                                    expected_value, expected);
+}
+
 }  // anonymous namespace
 
 class PlayerCostTest : public ::testing::Test {
@@ -120,3 +204,268 @@ TEST_F(PlayerCostTest, QuadraticizeWorks) {
                 constants::kSmallNumber);
   }
 }
+
+// Check that costs sharing a closest point query cache through PlayerCost
+// agree with the same costs evaluated without a cache.
+TEST(PlayerCostPolyline2Test, SharedQueryCacheMatchesStandaloneCosts) {
+  const Polyline2 polyline({Point2(-2.0, -2.0), Point2(0.5, 1.0),
+                            Point2(2.0, -1.0), Point2(3.0, 3.0)});
+  const std::vector<std::shared_ptr<Cost>> costs = {
+      std::make_shared<QuadraticPolyline2Cost>(kCostWeight, polyline,
+                                               PositionIdxs(0)),
+      std::make_shared<SemiquadraticPolyline2Cost>(
+          kCostWeight, polyline, PositionIdxs(0), 0.5, true)};
+
+  PlayerCost player_cost;
+  for (const auto& cost : costs) player_cost.AddStateCost(cost);
+
+  for (size_t ii = 0; ii < 10; ii++) {
+    const VectorXf x = 3.0 * VectorXf::Random(kVectorDimension);
+
+    // Query twice to exercise cache hits.
+    ExpectMatchesStandaloneCosts(player_cost, costs, 0.0, x);
+    ExpectMatchesStandaloneCosts(player_cost, costs, 0.0, x);
+  }
+}
+
+// Check that precomputed time-indexed terms match those computed on the fly,
+// both on and off the time grid.
+TEST(PlayerCostPrecomputeTest, PrecomputedCostsMatchStandaloneCosts) {
+  constexpr Time kInitialTime = 1.0;
+  constexpr Time kTimeStep = 0.1;
+  constexpr size_t kNumTimeSteps = 20;
+  Cost::ResetInitialTime(kInitialTime);
+  Cost::ResetTimeStep(kTimeStep);
+
+  const Polyline2 polyline(
+      {Point2(-2.0, -2.0), Point2(0.5, 1.0), Point2(2.0, 2.0)});
+  const auto make_costs = [&polyline]() {
+    return std::vector<std::shared_ptr<Cost>>{
+        std::make_shared<RouteProgressCost>(kCostWeight, 0.5, polyline,
+                                            PositionIdxs(0)),
+        std::make_shared<NominalPathLengthCost>(kCostWeight, SpeedIdx(0),
+                                                0.5),
+        std::make_shared<FinalTimeCost>(
+            std::make_shared<RouteProgressCost>(kCostWeight, 1.0, polyline,
+                                                PositionIdxs(1)),
+            0.5)};
+  };
+
+  const auto standalone_costs = make_costs();
+  PlayerCost player_cost;
+  for (const auto& cost : make_costs()) player_cost.AddStateCost(cost);
+  player_cost.Precompute(kNumTimeSteps);
+
+  for (size_t kk = 0; kk < 2 * kNumTimeSteps; kk++) {
+    const Time t = kInitialTime + 0.5 * kTimeStep * static_cast<Time>(kk);
+    ExpectMatchesStandaloneCosts(player_cost, standalone_costs, t,
+                                 VectorXf::Random(2 * kAgentDimension));
+  }
+
+  Cost::ResetInitialTime(0.0);
+  Cost::ResetTimeStep(0.0);
+}
+
+// Check that compiled costs match the original, virtual path.
+TEST(PlayerCostCompileTest, CompiledCostsMatchVirtualCosts) {
+  constexpr size_t kNumAgents = 4;
+  constexpr float kThreshold = 3.0;
+  const Polyline2 polyline(
+      {Point2(-2.0, -2.0), Point2(0.5, 1.0), Point2(2.0, 2.0)});
+
+  // Mix costs of compiled and other types.
+  PlayerCost player_cost;
+  for (size_t ii = 0; ii < kNumAgents; ii++) {
+    player_cost.AddStateCost(
+        std::make_shared<QuadraticCost>(kCostWeight, SpeedIdx(ii), 1.0));
+    player_cost.AddStateCost(std::make_shared<SemiquadraticCost>(
+        kCostWeight, SpeedIdx(ii), 0.5, ii % 2 == 0));
+    player_cost.AddStateCost(std::make_shared<QuadraticPolyline2Cost>(
+        kCostWeight, polyline, PositionIdxs(ii)));
+
+    for (size_t jj = ii + 1; jj < kNumAgents; jj++) {
+      player_cost.AddStateCost(std::make_shared<ProximityCost>(
+          kCostWeight, PositionIdxs(ii), PositionIdxs(jj), kThreshold));
+      player_cost.AddStateCost(std::make_shared<WeightedConvexProximityCost>(
+          kCostWeight, PositionIdxs(ii), PositionIdxs(jj), SpeedIdx(ii),
+          SpeedIdx(jj), kThreshold));
+    }
+  }
+
+  for (PlayerIndex ii = 0; ii < kNumPlayers; ii++) {
+    player_cost.AddControlCost(
+        ii, std::make_shared<QuadraticCost>(kCostWeight, -1));
+    player_cost.AddControlCost(ii,
+                               std::make_shared<QuadraticCost>(kCostWeight, 0));
+    player_cost.AddControlCost(
+        ii, std::make_shared<SemiquadraticCost>(kCostWeight, 1, 0.0, true));
+  }
+
+  PlayerCost compiled_player_cost(player_cost);
+  compiled_player_cost.Compile();
+  ASSERT_TRUE(compiled_player_cost.IsCompiled());
+  ASSERT_FALSE(player_cost.IsCompiled());
+
+  for (size_t kk = 0; kk < 20; kk++) {
+    const VectorXf x = 3.0 * VectorXf::Random(kAgentDimension * kNumAgents);
+    std::vector<VectorXf> us;
+    for (PlayerIndex ii = 0; ii < kNumPlayers; ii++)
+      us.emplace_back(VectorXf::Random(2));
+
+    ExpectSameCostAndQuadraticization(compiled_player_cost, player_cost, 0.0,
+                                      x, us);
+    EXPECT_NEAR(compiled_player_cost.EvaluateOffset(0.0, 0.1, x, us),
+                player_cost.EvaluateOffset(0.0, 0.1, x, us),
+                constants::kSmallNumber);
+  }
+
+  // Adding a cost reverts to the virtual path.
+  compiled_player_cost.AddStateCost(
+      std::make_shared<QuadraticCost>(kCostWeight, 0));
+  EXPECT_FALSE(compiled_player_cost.IsCompiled());
+}
+
+// Check that proximity costs shared between players match standalone costs,
+// and that each shared term is computed at most once per relative position.
+TEST(PlayerCostSharedProximityTest, SharedTermsMatchStandaloneCosts) {
+  constexpr float kThreshold = 3.0;
+  constexpr float kOtherWeight = 2.5;
+  constexpr Dimension kStateDimension = 4;
+  const auto position_idxs1 = std::make_pair(0, 1);
+  const auto position_idxs2 = std::make_pair(2, 3);
+
+  // Each player penalizes proximity to the other, with positions listed in
+  // opposite orders and with different weights.
+  const std::vector<std::shared_ptr<Cost>> costs = {
+      std::make_shared<ProximityCost>(kCostWeight, position_idxs1,
+                                      position_idxs2, kThreshold),
+      std::make_shared<ProximityCost>(kOtherWeight, position_idxs2,
+                                      position_idxs1, kThreshold)};
+
+  std::vector<PlayerCost> player_costs(kNumPlayers);
+  const auto shared_proximity_terms = std::make_shared<SharedProximityTerms>();
+  for (PlayerIndex ii = 0; ii < kNumPlayers; ii++) {
+    player_costs[ii].AddStateCost(costs[ii]);
+    player_costs[ii].Compile(shared_proximity_terms);
+  }
+  EXPECT_EQ(shared_proximity_terms->NumTerms(), 1);
+
+  for (size_t kk = 0; kk < 20; kk++) {
+    const VectorXf x = 2.0 * VectorXf::Random(kStateDimension);
+    const size_t num_computations = shared_proximity_terms->NumComputations();
+
+    for (PlayerIndex ii = 0; ii < kNumPlayers; ii++)
+      ExpectMatchesStandaloneCosts(player_costs[ii], {costs[ii]}, 0.0, x);
+
+    // The core is computed at most once for both players.
+    EXPECT_LE(shared_proximity_terms->NumComputations(),
+              num_computations + 1);
+  }
+
+  EXPECT_GT(shared_proximity_terms->NumComputations(), 0);
+}
+
+// Check that a broad-phase shared between players registers each proximity
+// pair once, and that skipping the pairs it culls does not change costs.
+TEST(PlayerCostBroadPhaseTest, SharedBroadPhaseMatchesUnculledCosts) {
+  constexpr size_t kNumAgents = 4;
+  constexpr float kThreshold = 3.0;
+
+  // Both players penalize proximity between all agents.
+  std::vector<PlayerCost> player_costs(kNumPlayers);
+  for (PlayerCost& player_cost : player_costs) {
+    player_cost.AddStateCost(std::make_shared<QuadraticCost>(kCostWeight, -1));
+    for (size_t ii = 0; ii < kNumAgents; ii++) {
+      for (size_t jj = ii + 1; jj < kNumAgents; jj++) {
+        player_cost.AddStateCost(std::make_shared<ProximityCost>(
+            kCostWeight, PositionIdxs(ii), PositionIdxs(jj), kThreshold));
+      }
+    }
+  }
+
+  const std::vector<PlayerCost> unculled_player_costs(player_costs);
+  ProximityBroadPhase broad_phase;
+  for (PlayerCost& player_cost : player_costs)
+    player_cost.Compile(nullptr, &broad_phase);
+  EXPECT_EQ(broad_phase.NumPairs(), kNumAgents * (kNumAgents - 1) / 2);
+
+  const std::vector<VectorXf> us = ZeroControls();
+  std::vector<bool> active;
+  size_t num_culled = 0;
+  for (size_t kk = 0; kk < 20; kk++) {
+    const VectorXf x = 5.0 * VectorXf::Random(kAgentDimension * kNumAgents);
+    broad_phase.FindActivePairs(x, &active);
+    num_culled += std::count(active.begin(), active.end(), false);
+
+    for (PlayerIndex ii = 0; ii < kNumPlayers; ii++) {
+      ExpectSameCostAndQuadraticization(
+          player_costs[ii].Evaluate(0.0, x, us, &active),
+          player_costs[ii].Quadraticize(0.0, x, us, nullptr, &active),
+          unculled_player_costs[ii].Evaluate(0.0, x, us),
+          unculled_player_costs[ii].Quadraticize(0.0, x, us));
+    }
+  }
+
+  EXPECT_GT(num_culled, 0);
+}
+
+// Check that piecewise costs are only reported inactive where they vanish, and
+// that skipping inactive terms does not change quadraticizations.
+TEST(PlayerCostActivityTest, MaskedQuadraticizationMatchesFull) {
+  constexpr size_t kNumAgents = 3;
+  constexpr float kThreshold = 1.5;
+  constexpr float kMargin = 0.1;
+  const Polyline2 polyline(
+      {Point2(-2.0, -2.0), Point2(0.5, 1.0), Point2(2.0, 2.0)});
+
+  std::vector<std::shared_ptr<Cost>> piecewise_costs;
+  for (size_t ii = 0; ii < kNumAgents; ii++) {
+    piecewise_costs.emplace_back(std::make_shared<SemiquadraticCost>(
+        kCostWeight, SpeedIdx(ii), 0.5, ii % 2 == 0));
+    piecewise_costs.emplace_back(std::make_shared<SemiquadraticPolyline2Cost>(
+        kCostWeight, polyline, PositionIdxs(ii), 1.0, ii % 2 == 0));
+
+    for (size_t jj = ii + 1; jj < kNumAgents; jj++) {
+      piecewise_costs.emplace_back(std::make_shared<ProximityCost>(
+          kCostWeight, PositionIdxs(ii), PositionIdxs(jj), kThreshold));
+      piecewise_costs.emplace_back(
+          std::make_shared<LocallyConvexProximityCost>(
+              kCostWeight, PositionIdxs(ii), PositionIdxs(jj), kThreshold));
+      piecewise_costs.emplace_back(
+          std::make_shared<WeightedConvexProximityCost>(
+              kCostWeight, PositionIdxs(ii), PositionIdxs(jj), SpeedIdx(ii),
+              SpeedIdx(jj), kThreshold));
+    }
+  }
+
+  PlayerCost player_cost;
+  for (const auto& cost : piecewise_costs) player_cost.AddStateCost(cost);
+  player_cost.AddControlCost(
+      0, std::make_shared<QuadraticCost>(kCostWeight, -1));
+  player_cost.Compile();
+  ASSERT_EQ(player_cost.NumActivityTerms(), piecewise_costs.size());
+
+  const std::vector<VectorXf> us = ZeroControls();
+  size_t num_inactive = 0;
+  for (size_t kk = 0; kk < 50; kk++) {
+    const VectorXf x = 3.0 * VectorXf::Random(kAgentDimension * kNumAgents);
+
+    for (const auto& cost : piecewise_costs) {
+      if (!cost->IsActive(0.0, x, kMargin)) {
+        EXPECT_EQ(cost->Evaluate(0.0, x), 0.0);
+      }
+    }
+
+    // Record the activity mask before quadraticizing with it.
+    std::vector<bool> activity;
+    const float value = player_cost.Evaluate(0.0, x, us, kMargin, &activity);
+    ASSERT_EQ(activity.size(), piecewise_costs.size());
+    num_inactive += std::count(activity.begin(), activity.end(), false);
+
+    ExpectSameCostAndQuadraticization(
+        value, player_cost.Quadraticize(0.0, x, us, &activity),
+        player_cost.Evaluate(0.0, x, us), player_cost.Quadraticize(0.0, x, us));
+  }
+
+  EXPECT_GT(num_inactive, 0);
+}
@@ -123,3 +123,57 @@ TEST(Polyline2Test, ClosestPointWorks) {
   EXPECT_TRUE(closest.isApprox(p3));
   EXPECT_NEAR(signed_squared_distance, -2.0, constants::kSmallNumber);
 }
+
+// Check that searching the tree of bounding boxes and warm-starting from an
+// arbitrary hint both find the same closest point as an exhaustive search.
+TEST(Polyline2Test, ClosestPointMatchesExhaustiveSearch) {
+  std::default_random_engine rng(0);
+  std::uniform_real_distribution<float> unif(-1.0, 1.0);
+
+  // Random walk which loops back on itself.
+  constexpr size_t kNumPoints = 200;
+  PointList2 points = {Point2::Zero()};
+  for (size_t ii = 1; ii < kNumPoints; ii++)
+    points.push_back(points.back() + Point2(1.0 + unif(rng), 5.0 * unif(rng)));
+  const Polyline2 polyline(points);
+
+  constexpr size_t kNumQueries = 100;
+  for (size_t ii = 0; ii < kNumQueries; ii++) {
+    const Point2 query(100.0 * (1.0 + unif(rng)), 20.0 * unif(rng));
+
+    // Exhaustive search, breaking ties in favor of the first segment.
+    float expected_signed_squared_distance = constants::kInfinity;
+    Point2 expected;
+    for (const auto& s : polyline.Segments()) {
+      float signed_squared_distance;
+      const Point2 closest =
+          s.ClosestPoint(query, nullptr, &signed_squared_distance);
+      if (std::abs(signed_squared_distance) <
+          std::abs(expected_signed_squared_distance)) {
+        expected_signed_squared_distance = signed_squared_distance;
+        expected = closest;
+      }
+    }
+
+    float signed_squared_distance;
+    size_t segment_idx;
+    Point2 closest =
+        polyline.ClosestPoint(query, nullptr, nullptr, &signed_squared_distance,
+                              nullptr, &segment_idx);
+    EXPECT_TRUE(closest.isApprox(expected));
+    EXPECT_EQ(signed_squared_distance, expected_signed_squared_distance);
+
+    size_t segment_hint = ii % polyline.Segments().size();
+    closest = polyline.ClosestPointWithHint(
+        query, &segment_hint, nullptr, nullptr, &signed_squared_distance);
+    EXPECT_TRUE(closest.isApprox(expected));
+    EXPECT_EQ(signed_squared_distance, expected_signed_squared_distance);
+    EXPECT_EQ(segment_hint, segment_idx);
+
+    // Querying again from the new hint should give the same answer.
+    const size_t last_segment_hint = segment_hint;
+    EXPECT_TRUE(polyline.ClosestPointWithHint(query, &segment_hint)
+                    .isApprox(expected));
+    EXPECT_EQ(segment_hint, last_segment_hint);
+  }
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for ProximityBroadPhase.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/geometry/proximity_broad_phase.h>
+#include <ilqgames/utils/types.h>
+
+#include <gtest/gtest.h>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace ilqgames;
+
+// Check that the broad-phase flags exactly those pairs whose positions are
+// within their radius.
+TEST(ProximityBroadPhaseTest, MatchesExhaustiveSearch) {
+  constexpr size_t kNumPositions = 20;
+  constexpr size_t kNumTrials = 50;
+  std::default_random_engine rng(0);
+  std::uniform_real_distribution<float> coordinate_distribution(-50.0, 50.0);
+  std::uniform_real_distribution<float> radius_distribution(1.0, 20.0);
+
+  // Register all pairs of positions, and some pairs twice.
+  ProximityBroadPhase broad_phase;
+  std::vector<std::pair<size_t, size_t>> positions_in_pair;
+  std::vector<float> radii;
+  for (size_t ii = 0; ii < kNumPositions; ii++) {
+    for (size_t jj = ii + 1; jj < kNumPositions; jj++) {
+      for (size_t kk = 0; kk < 1 + (ii + jj) % 2; kk++) {
+        const float radius = radius_distribution(rng);
+        EXPECT_EQ(broad_phase.AddPair({2 * ii, 2 * ii + 1},
+                                      {2 * jj, 2 * jj + 1}, radius),
+                  radii.size());
+        positions_in_pair.emplace_back(ii, jj);
+        radii.push_back(radius);
+      }
+    }
+  }
+
+  EXPECT_EQ(broad_phase.NumPositions(), kNumPositions);
+  EXPECT_EQ(broad_phase.NumPairs(), radii.size());
+
+  std::vector<bool> active;
+  for (size_t trial = 0; trial < kNumTrials; trial++) {
+    VectorXf input(2 * kNumPositions);
+    for (size_t ii = 0; ii < 2 * kNumPositions; ii++)
+      input(ii) = coordinate_distribution(rng);
+
+    broad_phase.FindActivePairs(input, &active);
+    ASSERT_EQ(active.size(), radii.size());
+
+    for (size_t ii = 0; ii < radii.size(); ii++) {
+      const size_t position1 = positions_in_pair[ii].first;
+      const size_t position2 = positions_in_pair[ii].second;
+      const Point2 point1(input(2 * position1), input(2 * position1 + 1));
+      const Point2 point2(input(2 * position2), input(2 * position2 + 1));
+      EXPECT_EQ(active[ii],
+                (point1 - point2).squaredNorm() <= radii[ii] * radii[ii]);
+    }
+  }
+}
@@ -43,6 +43,7 @@
 #include <ilqgames/constraint/polyline2_signed_distance_constraint.h>
 #include <ilqgames/constraint/proximity_constraint.h>
 #include <ilqgames/constraint/single_dimension_constraint.h>
+#include <ilqgames/cost/autodiff_cost.h>
 #include <ilqgames/cost/curvature_cost.h>
 #include <ilqgames/cost/locally_convex_proximity_cost.h>
 #include <ilqgames/cost/nominal_path_length_cost.h>
@@ -64,6 +65,9 @@
 #include <ilqgames/utils/types.h>
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <memory>
 #include <random>
 
@@ -79,6 +83,32 @@ static constexpr float kGradForwardStep = 1e-3;
 static constexpr float kHessForwardStep = 1e-3;
 static constexpr float kNumericalPrecision = 0.15;
 
+// Reference for WeightedConvexProximityCost with derivatives computed by
+// automatic differentiation, on inputs (x1, y1, x2, y2, v1, v2).
+class AutodiffWeightedConvexProximityCost
+    : public AutodiffCost<AutodiffWeightedConvexProximityCost, 6> {
+ public:
+  AutodiffWeightedConvexProximityCost(float weight, float threshold)
+      : AutodiffCost(weight, {0, 1, 2, 3, 4, 5}), threshold_(threshold) {}
+
+  template <typename T>
+  T Function(Time t, const std::array<T, 6>& x) const {
+    using std::abs;
+    using std::max;
+
+    const T abs_dx = abs(x[0] - x[2]);
+    const T abs_dy = abs(x[1] - x[3]);
+    if (abs_dx >= threshold_ || abs_dy >= threshold_) return T(0.0);
+
+    const T delta = threshold_ - max(abs_dx, abs_dy);
+    const T vv = x[4] * x[4] + x[5] * x[5];
+    return (0.5 * weight_) * vv * (delta * delta);
+  }
+
+ private:
+  const float threshold_;
+};  //\class AutodiffWeightedConvexProximityCost
+
 // Function to compute numerical gradient of a cost.
 VectorXf NumericalGradient(const Cost& cost, Time t, const VectorXf& input) {
   VectorXf grad(input.size());
@@ -358,6 +388,63 @@ TEST(LocallyConvexProximityCostTest, QuadraticizesCorrectly) {
 TEST(WeightedConvexProximityCostTest, QuadraticizesCorrectly) {
   WeightedConvexProximityCost cost(kCostWeight, {0, 1}, {2, 3}, 4, 5, 0.0);
   CheckQuadraticization(cost);
+
+  // With a positive threshold, the cost is active at some of the test points.
+  WeightedConvexProximityCost active_cost(kCostWeight, {0, 1}, {2, 3}, 4, 5,
+                                          5.0);
+  CheckQuadraticization(active_cost);
+
+  // Check the value at a point where the y coordinates differ by more than the
+  // x coordinates, so the y term is the smaller one.
+  VectorXf input(VectorXf::Zero(kInputDimension));
+  input(0) = 1.0;
+  input(1) = 2.0;
+  input(4) = 1.0;
+  input(5) = 2.0;
+  EXPECT_FLOAT_EQ(active_cost.Evaluate(input),
+                  0.5 * kCostWeight * 5.0 * 9.0);
+}
+
+TEST(WeightedConvexProximityCostTest, MatchesAutodiff) {
+  constexpr float kThreshold = 5.0;
+  const WeightedConvexProximityCost cost(kCostWeight, {0, 1}, {2, 3}, 4, 5,
+                                         kThreshold);
+  const AutodiffWeightedConvexProximityCost autodiff_cost(kCostWeight,
+                                                          kThreshold);
+
+  // Random points, most of which lie within the threshold.
+  std::default_random_engine rng(0);
+  std::uniform_real_distribution<float> entry_distribution(-3.0, 3.0);
+
+  constexpr size_t kNumRandomPoints = 100;
+  constexpr float kPrecision = 1e-4;
+  size_t num_active = 0;
+  for (size_t ii = 0; ii < kNumRandomPoints; ii++) {
+    VectorXf input(kInputDimension);
+    for (size_t jj = 0; jj < kInputDimension; jj++)
+      input(jj) = entry_distribution(rng);
+
+    MatrixXf hess(MatrixXf::Zero(kInputDimension, kInputDimension));
+    VectorXf grad(VectorXf::Zero(kInputDimension));
+    cost.Quadraticize(input, &hess, &grad);
+
+    MatrixXf autodiff_hess(MatrixXf::Zero(kInputDimension, kInputDimension));
+    VectorXf autodiff_grad(VectorXf::Zero(kInputDimension));
+    autodiff_cost.Quadraticize(0.0, input, &autodiff_hess, &autodiff_grad);
+
+    const float value = autodiff_cost.Evaluate(0.0, input);
+    if (value > 0.0) num_active++;
+
+    const float scale = 1.0 + autodiff_hess.lpNorm<Eigen::Infinity>() +
+                        autodiff_grad.lpNorm<Eigen::Infinity>();
+    EXPECT_NEAR(cost.Evaluate(input), value, kPrecision * (1.0 + value));
+    EXPECT_LT((grad - autodiff_grad).lpNorm<Eigen::Infinity>(),
+              kPrecision * scale);
+    EXPECT_LT((hess - autodiff_hess).lpNorm<Eigen::Infinity>(),
+              kPrecision * scale);
+  }
+
+  EXPECT_GT(num_active, kNumRandomPoints / 2);
 }
 
 TEST(OrientationFlatCostTest, QuadraticizesCorrectly) {
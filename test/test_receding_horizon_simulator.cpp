@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for the receding horizon simulator on an example problem.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/cost/cost.h>
+#include <ilqgames/examples/receding_horizon_simulator.h>
+#include <ilqgames/examples/two_player_collision_example.h>
+#include <ilqgames/solver/solver_params.h>
+#include <ilqgames/utils/operating_point.h>
+#include <ilqgames/utils/runtime_predictor.h>
+#include <ilqgames/utils/solver_log.h>
+#include <ilqgames/utils/types.h>
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+using namespace ilqgames;
+
+namespace {
+// Simulation parameters.
+static constexpr Time kFinalTime = 2.0;
+static constexpr Time kLongFinalTime = 12.0;
+static constexpr Time kPlannerRuntime = 0.25;
+static constexpr size_t kMaxSolverIters = 100;
+
+// Run the simulator on the example until the given final time, charging solve
+// time with the given model and replanning when triggered (if triggers are
+// provided).
+std::vector<std::shared_ptr<const SolverLog>> Simulate(
+    const SolveTimeModel& solve_time_model,
+    const ReplanningTriggers* replanning_triggers = nullptr,
+    Time final_time = kFinalTime) {
+  // Each simulation resets the initial time for all costs.
+  Cost::ResetInitialTime(0.0);
+
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  TwoPlayerCollisionExample problem(params);
+  return RecedingHorizonSimulator(final_time, kPlannerRuntime, &problem,
+                                  solve_time_model, replanning_triggers);
+}
+
+}  // anonymous namespace
+
+// Check that simulations charged a fixed solve time are reproducible.
+TEST(RecedingHorizonSimulatorTest, SimulatedSolveTimeIsReproducible) {
+  const auto logs1 = Simulate(FixedSolveTimeModel(kPlannerRuntime));
+  const auto logs2 = Simulate(FixedSolveTimeModel(kPlannerRuntime));
+  Cost::ResetInitialTime(0.0);
+
+  ASSERT_GT(logs1.size(), 1);
+  ASSERT_EQ(logs1.size(), logs2.size());
+  for (size_t ii = 0; ii < logs1.size(); ii++) {
+    ASSERT_EQ(logs1[ii]->NumIterates(), logs2[ii]->NumIterates());
+
+    const OperatingPoint& op1 = logs1[ii]->FinalOperatingPoint();
+    const OperatingPoint& op2 = logs2[ii]->FinalOperatingPoint();
+    EXPECT_EQ(op1.t0, op2.t0);
+    ASSERT_EQ(op1.xs.size(), op2.xs.size());
+    for (size_t kk = 0; kk < op1.xs.size(); kk++)
+      EXPECT_TRUE(op1.xs[kk] == op2.xs[kk]);
+  }
+}
+
+// Check that solves charged more than the planner runtime are charged the
+// planner runtime, and that their solutions are not spliced, so the simulation
+// stops once the initial plan runs out.
+TEST(RecedingHorizonSimulatorTest, OverrunningSolvesAreNotSpliced) {
+  const auto logs1 =
+      Simulate(FixedSolveTimeModel(kPlannerRuntime), nullptr, kLongFinalTime);
+  const auto logs2 = Simulate(FixedSolveTimeModel(2.0 * kPlannerRuntime),
+                              nullptr, kLongFinalTime);
+  Cost::ResetInitialTime(0.0);
+
+  ASSERT_GT(logs2.size(), 1);
+  ASSERT_LT(logs2.size(), logs1.size());
+  for (size_t ii = 0; ii < logs2.size(); ii++) {
+    EXPECT_NEAR(logs1[ii]->FinalOperatingPoint().t0,
+                logs2[ii]->FinalOperatingPoint().t0, constants::kSmallNumber);
+  }
+
+  // The initial plan ends at the time horizon, which is shorter than the long
+  // final time.
+  const OperatingPoint& initial = logs2.front()->FinalOperatingPoint();
+  const Time horizon = initial.t0 + logs2.front()->TimeStep() *
+                                        static_cast<Time>(initial.xs.size());
+  ASSERT_LT(horizon, kLongFinalTime);
+  EXPECT_LT(logs2.back()->FinalOperatingPoint().t0, horizon);
+  EXPECT_GT(logs1.back()->FinalOperatingPoint().t0, horizon);
+}
+
+// Check that the per-iteration model charges time per solver iterate.
+TEST(RecedingHorizonSimulatorTest, PerIterationModelChargesIterates) {
+  constexpr Time kTimePerIteration = 0.01;
+  constexpr Time kOverhead = 0.05;
+  const SolveTimeModel model =
+      PerIterationSolveTimeModel(kTimePerIteration, kOverhead);
+
+  SolverLog log(kPlannerRuntime);
+  EXPECT_NEAR(model(log), kOverhead, constants::kSmallNumber);
+
+  constexpr size_t kNumIterates = 3;
+  for (size_t ii = 0; ii < kNumIterates; ii++)
+    log.AddSolverIterate(OperatingPoint(1, 1, 0.0), {}, {}, 0.0, false);
+  EXPECT_NEAR(model(log), kOverhead + kNumIterates * kTimePerIteration,
+              constants::kSmallNumber);
+}
+
+// Check that triggers which always fire reproduce the fixed replanning
+// schedule, and that triggers which seldom fire replan less often.
+TEST(RecedingHorizonSimulatorTest, EventTriggeredReplanning) {
+  const auto scheduled = Simulate(FixedSolveTimeModel(kPlannerRuntime));
+
+  ReplanningTriggers always;
+  always.min_remaining_horizon = constants::kInfinity;
+  const auto always_triggered =
+      Simulate(FixedSolveTimeModel(kPlannerRuntime), &always);
+
+  ReplanningTriggers seldom;
+  seldom.player_distance_thresholds = {1.0};
+  seldom.min_remaining_horizon = 1.0;
+  const auto seldom_triggered =
+      Simulate(FixedSolveTimeModel(kPlannerRuntime), &seldom);
+  Cost::ResetInitialTime(0.0);
+
+  ASSERT_EQ(always_triggered.size(), scheduled.size());
+  for (size_t ii = 0; ii < scheduled.size(); ii++) {
+    const OperatingPoint& op1 = scheduled[ii]->FinalOperatingPoint();
+    const OperatingPoint& op2 = always_triggered[ii]->FinalOperatingPoint();
+    EXPECT_EQ(op1.t0, op2.t0);
+    ASSERT_EQ(op1.xs.size(), op2.xs.size());
+    for (size_t kk = 0; kk < op1.xs.size(); kk++)
+      EXPECT_TRUE(op1.xs[kk] == op2.xs[kk]);
+  }
+
+  EXPECT_GE(seldom_triggered.size(), 1);
+  EXPECT_LT(seldom_triggered.size(), scheduled.size());
+}
+
+// Check that planner runtime budgets cover the target number of iterations at
+// the predicted runtime, within bounds.
+TEST(RecedingHorizonSimulatorTest, BudgetsPredictedIterations) {
+  PlannerRuntimeBudget budget;
+  budget.num_iterations = 5;
+  budget.latency_quantile = 1.0;
+  budget.overhead = 0.01;
+  budget.min_planner_runtime = 0.05;
+  budget.max_planner_runtime = 0.5;
+
+  // Before any iterations are observed, the predictor's initial guess is used.
+  RuntimePredictor predictor;
+  EXPECT_NEAR(BudgetPlannerRuntime(budget, predictor),
+              budget.overhead + 5 * predictor.IterationRuntime(1.0),
+              constants::kSmallNumber);
+
+  // Fast iterations hit the lower bound, and slow ones the upper bound.
+  predictor.Record(SolverPhase::LINEARIZE, 0.001);
+  predictor.Record(SolverPhase::QUADRATICIZE, 0.001);
+  predictor.Record(SolverPhase::LQ_SOLVE, 0.001);
+  predictor.Record(SolverPhase::LINESEARCH, 0.001);
+  EXPECT_EQ(BudgetPlannerRuntime(budget, predictor),
+            budget.min_planner_runtime);
+
+  predictor.Record(SolverPhase::LINESEARCH, 0.05);
+  EXPECT_NEAR(BudgetPlannerRuntime(budget, predictor), 0.01 + 5 * 0.053,
+              constants::kSmallNumber);
+
+  predictor.Record(SolverPhase::LQ_SOLVE, 1.0);
+  EXPECT_EQ(BudgetPlannerRuntime(budget, predictor),
+            budget.max_planner_runtime);
+}
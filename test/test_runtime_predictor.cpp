@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for RuntimePredictor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/utils/runtime_predictor.h>
+#include <ilqgames/utils/types.h>
+
+#include <gtest/gtest.h>
+
+using namespace ilqgames;
+
+namespace {
+// Window length.
+static constexpr size_t kMaxSamples = 10;
+
+// Initial guess for iteration runtime.
+static constexpr Time kInitialGuess = 0.02;
+}  // anonymous namespace
+
+// Check that phase quantiles use the nearest rank within the moving window.
+TEST(RuntimePredictorTest, PhaseQuantilesUseMovingWindow) {
+  RuntimePredictor predictor(kMaxSamples);
+  EXPECT_EQ(predictor.PhaseRuntime(SolverPhase::LQ_SOLVE, 0.5, 1.0), 1.0);
+
+  // Record runtimes 1, ..., 10 out of order.
+  for (size_t ii = 0; ii < kMaxSamples; ii++) {
+    predictor.Record(SolverPhase::LQ_SOLVE,
+                     static_cast<Time>((3 * ii) % kMaxSamples + 1));
+  }
+
+  EXPECT_EQ(predictor.NumSamples(SolverPhase::LQ_SOLVE), kMaxSamples);
+  EXPECT_EQ(predictor.PhaseRuntime(SolverPhase::LQ_SOLVE, 0.0), 1.0);
+  EXPECT_EQ(predictor.PhaseRuntime(SolverPhase::LQ_SOLVE, 0.5), 5.0);
+  EXPECT_EQ(predictor.PhaseRuntime(SolverPhase::LQ_SOLVE, 0.9), 9.0);
+  EXPECT_EQ(predictor.PhaseRuntime(SolverPhase::LQ_SOLVE, 1.0), 10.0);
+
+  // Recording more runtimes should evict the oldest ones, i.e., all of the
+  // original runtimes after a full window.
+  for (size_t ii = 0; ii < kMaxSamples; ii++)
+    predictor.Record(SolverPhase::LQ_SOLVE, 0.5);
+
+  EXPECT_EQ(predictor.NumSamples(SolverPhase::LQ_SOLVE), kMaxSamples);
+  EXPECT_EQ(predictor.PhaseRuntime(SolverPhase::LQ_SOLVE, 1.0), 0.5);
+}
+
+// Check that iteration runtimes sum phase quantiles once every phase has been
+// observed.
+TEST(RuntimePredictorTest, IterationRuntimeSumsPhases) {
+  RuntimePredictor predictor(kMaxSamples);
+  predictor.Record(SolverPhase::LINEARIZE, 1.0);
+  predictor.Record(SolverPhase::QUADRATICIZE, 2.0);
+  predictor.Record(SolverPhase::LQ_SOLVE, 3.0);
+  EXPECT_EQ(predictor.IterationRuntime(0.9, kInitialGuess), kInitialGuess);
+
+  predictor.Record(SolverPhase::LINESEARCH, 4.0);
+  predictor.Record(SolverPhase::LINESEARCH, 8.0);
+  EXPECT_EQ(predictor.IterationRuntime(0.5, kInitialGuess), 10.0);
+  EXPECT_EQ(predictor.IterationRuntime(0.9, kInitialGuess), 14.0);
+
+  predictor.Clear();
+  EXPECT_EQ(predictor.NumSamples(SolverPhase::LINESEARCH), 0);
+  EXPECT_EQ(predictor.IterationRuntime(0.9, kInitialGuess), kInitialGuess);
+}
+
+// Check that a scoped phase is recorded however its scope is left.
+TEST(RuntimePredictorTest, ScopedPhaseRecordsOnEarlyReturn) {
+  RuntimePredictor predictor(kMaxSamples);
+  auto time_phase = [&predictor](bool return_early) {
+    const RuntimePredictor::ScopedPhase linesearch(&predictor,
+                                                   SolverPhase::LINESEARCH);
+    if (return_early) return false;
+    return true;
+  };  // time_phase
+
+  EXPECT_FALSE(time_phase(true));
+  EXPECT_EQ(predictor.NumSamples(SolverPhase::LINESEARCH), 1);
+  EXPECT_TRUE(time_phase(false));
+  EXPECT_EQ(predictor.NumSamples(SolverPhase::LINESEARCH), 2);
+  EXPECT_GE(predictor.PhaseRuntime(SolverPhase::LINESEARCH, 0.0), 0.0);
+}
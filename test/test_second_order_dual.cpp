@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for SecondOrderDual.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/utils/second_order_dual.h>
+#include <ilqgames/utils/types.h>
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cmath>
+
+using namespace ilqgames;
+
+namespace {
+
+// Step size for central differences, in double precision.
+static constexpr double kForwardStep = 1e-4;
+static constexpr float kNumericalPrecision = 1e-3;
+
+// Smooth test function exercising every elementary operation.
+template <typename T>
+T Function(const std::array<T, 3>& x) {
+  using std::atan;
+  using std::atan2;
+  using std::cos;
+  using std::exp;
+  using std::log;
+  using std::pow;
+  using std::sin;
+  using std::sqrt;
+
+  const T r = sqrt(x[0] * x[0] + x[1] * x[1] + 1.0);
+  return x[0] * x[1] / (1.0 + x[2] * x[2]) + sin(x[0]) * exp(0.5 * x[1]) -
+         cos(x[2]) / r + log(r) + atan(x[1] - x[2]) + atan2(x[1], x[0]) +
+         pow(r, 2.5) - 2.0 / r;
+}
+
+// Evaluate the test function in double precision.
+double Evaluate(const Eigen::Vector3d& x) {
+  return Function<double>({x(0), x(1), x(2)});
+}
+
+}  // anonymous namespace
+
+// Check value, gradient, and Hessian against central differences.
+TEST(SecondOrderDualTest, MatchesNumericalDerivatives) {
+  const Eigen::Vector3d x(0.7, -1.3, 0.4);
+
+  std::array<SecondOrderDual<3>, 3> dual_x;
+  for (int ii = 0; ii < 3; ii++)
+    dual_x[ii] = SecondOrderDual<3>::Variable(x(ii), ii);
+  const SecondOrderDual<3> y = Function(dual_x);
+
+  EXPECT_NEAR(y.v, Evaluate(x), kNumericalPrecision);
+
+  for (int ii = 0; ii < 3; ii++) {
+    const Eigen::Vector3d ei = kForwardStep * Eigen::Vector3d::Unit(ii);
+    EXPECT_NEAR(y.g(ii),
+                0.5 * (Evaluate(x + ei) - Evaluate(x - ei)) / kForwardStep,
+                kNumericalPrecision);
+
+    for (int jj = 0; jj < 3; jj++) {
+      const Eigen::Vector3d ej = kForwardStep * Eigen::Vector3d::Unit(jj);
+      const double hess_ij = (Evaluate(x + ei + ej) - Evaluate(x + ei - ej) -
+                              Evaluate(x - ei + ej) + Evaluate(x - ei - ej)) /
+                             (4.0 * kForwardStep * kForwardStep);
+      EXPECT_NEAR(y.FullHessian()(ii, jj), hess_ij, kNumericalPrecision);
+    }
+  }
+}
+
+// Check that nonsmooth functions take the derivative of the active branch.
+TEST(SecondOrderDualTest, NonsmoothFunctionsFollowActiveBranch) {
+  const SecondOrderDual<2> x = SecondOrderDual<2>::Variable(-2.0, 0);
+  const SecondOrderDual<2> y = SecondOrderDual<2>::Variable(3.0, 1);
+
+  const SecondOrderDual<2> abs_x = abs(x);
+  EXPECT_FLOAT_EQ(abs_x.v, 2.0);
+  EXPECT_FLOAT_EQ(abs_x.g(0), -1.0);
+
+  const SecondOrderDual<2> min_xy = min(x * x, y);
+  EXPECT_FLOAT_EQ(min_xy.v, 3.0);
+  EXPECT_FLOAT_EQ(min_xy.g(1), 1.0);
+  EXPECT_TRUE(min_xy.IsLinear());
+
+  const SecondOrderDual<2> max_xy = max(x * x, y);
+  EXPECT_FLOAT_EQ(max_xy.v, 4.0);
+  EXPECT_FLOAT_EQ(max_xy.g(0), -4.0);
+  EXPECT_FLOAT_EQ(max_xy.FullHessian()(0, 0), 2.0);
+}
+
+// Check that the Hessian is only supported on the variables each number
+// depends upon, including when an outer product extends that support.
+TEST(SecondOrderDualTest, TracksSupport) {
+  std::array<SecondOrderDual<4>, 4> x;
+  for (int ii = 0; ii < 4; ii++)
+    x[ii] = SecondOrderDual<4>::Variable(1.0 + ii, ii);
+
+  const SecondOrderDual<4> d = x[0] - x[2];
+  EXPECT_EQ(d.support, 0b0101u);
+  EXPECT_TRUE(d.IsLinear());
+
+  const SecondOrderDual<4> dd = d * d;
+  EXPECT_EQ(dd.hessian_support, 0b0101u);
+
+  // d^2 x1 has Hessian entries 2 x1 in the (0, 2) block and 2 d between
+  // x1 and each of x0 and x2, up to sign.
+  const SecondOrderDual<4> y = dd * x[1];
+  EXPECT_EQ(y.support, 0b0111u);
+  EXPECT_EQ(y.hessian_support, 0b0111u);
+
+  const float x1 = x[1].v;
+  Eigen::Matrix4f expected_hess;
+  expected_hess << 2.0 * x1, 2.0 * d.v, -2.0 * x1, 0.0,  //
+      2.0 * d.v, 0.0, -2.0 * d.v, 0.0,                   //
+      -2.0 * x1, -2.0 * d.v, 2.0 * x1, 0.0,              //
+      0.0, 0.0, 0.0, 0.0;
+  EXPECT_TRUE(y.FullHessian().isApprox(expected_hess));
+  EXPECT_FLOAT_EQ(y.g(3), 0.0);
+}
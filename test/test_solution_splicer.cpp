@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for SolutionSplicer.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/cost/cost.h>
+#include <ilqgames/dynamics/concatenated_dynamical_system.h>
+#include <ilqgames/dynamics/multi_player_integrable_system.h>
+#include <ilqgames/dynamics/single_player_unicycle_4d.h>
+#include <ilqgames/examples/two_player_collision_example.h>
+#include <ilqgames/solver/solution_splicer.h>
+#include <ilqgames/solver/solver_params.h>
+#include <ilqgames/utils/operating_point.h>
+#include <ilqgames/utils/solver_log.h>
+#include <ilqgames/utils/strategy.h>
+#include <ilqgames/utils/types.h>
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace ilqgames;
+
+namespace {
+// Time parameters.
+static constexpr Time kTimeStep = 0.1;
+static constexpr size_t kNumTimeSteps = 20;
+
+// Number of time steps before a new solution which should be retained.
+static constexpr size_t kNumPreviousTimeStepsToSave = 5;
+
+// Dimensions, matching two concatenated unicycles.
+static constexpr Dimension kXDim = 8;
+static const std::vector<Dimension> kUDims = {2, 2};
+
+// Two concatenated unicycles, to integrate through spliced solutions.
+std::unique_ptr<const MultiPlayerIntegrableSystem> TwoUnicycles() {
+  return std::unique_ptr<const MultiPlayerIntegrableSystem>(
+      new ConcatenatedDynamicalSystem(
+          {std::make_shared<SinglePlayerUnicycle4D>(),
+           std::make_shared<SinglePlayerUnicycle4D>()},
+          kTimeStep));
+}
+
+// Create a solver log holding a single random solution starting at the given
+// time.
+std::shared_ptr<const SolverLog> RandomLog(
+    Time t0, size_t num_time_steps = kNumTimeSteps) {
+  OperatingPoint op(num_time_steps, kUDims.size(), t0);
+  std::vector<Strategy> strategies;
+  for (PlayerIndex ii = 0; ii < kUDims.size(); ii++)
+    strategies.emplace_back(num_time_steps, kXDim, kUDims[ii]);
+
+  for (size_t kk = 0; kk < num_time_steps; kk++) {
+    op.xs[kk] = VectorXf::Random(kXDim);
+    for (PlayerIndex ii = 0; ii < kUDims.size(); ii++) {
+      op.us[kk][ii] = VectorXf::Random(kUDims[ii]);
+      strategies[ii].Ps[kk] = MatrixXf::Random(kUDims[ii], kXDim);
+      strategies[ii].alphas[kk] = VectorXf::Random(kUDims[ii]);
+    }
+  }
+
+  std::shared_ptr<SolverLog> log(new SolverLog(kTimeStep));
+  log->AddSolverIterate(op, strategies, std::vector<float>(kUDims.size()),
+                        0.0, true);
+  return log;
+}
+
+// Splice a new solution into contiguous reference copies, by erasing elapsed
+// time steps from the front of each vector.
+void ReferenceSplice(const SolverLog& log, OperatingPoint* op,
+                     std::vector<Strategy>* strategies) {
+  const size_t current_timestep = static_cast<size_t>(
+      1e-4 + (log.FinalOperatingPoint().t0 - op->t0) / kTimeStep);
+  const size_t initial_timestep =
+      (current_timestep < kNumPreviousTimeStepsToSave)
+          ? 0
+          : current_timestep - kNumPreviousTimeStepsToSave;
+
+  op->t0 += initial_timestep * kTimeStep;
+  op->xs.erase(op->xs.begin(), op->xs.begin() + initial_timestep);
+  op->us.erase(op->us.begin(), op->us.begin() + initial_timestep);
+  op->xs.resize(current_timestep - initial_timestep);
+  op->us.resize(current_timestep - initial_timestep);
+  op->xs.insert(op->xs.end(), log.FinalOperatingPoint().xs.begin(),
+                log.FinalOperatingPoint().xs.end());
+  op->us.insert(op->us.end(), log.FinalOperatingPoint().us.begin(),
+                log.FinalOperatingPoint().us.end());
+
+  for (PlayerIndex ii = 0; ii < strategies->size(); ii++) {
+    auto& Ps = (*strategies)[ii].Ps;
+    auto& alphas = (*strategies)[ii].alphas;
+    Ps.erase(Ps.begin(), Ps.begin() + initial_timestep);
+    alphas.erase(alphas.begin(), alphas.begin() + initial_timestep);
+    Ps.resize(current_timestep - initial_timestep);
+    alphas.resize(current_timestep - initial_timestep);
+    Ps.insert(Ps.end(), log.FinalStrategies()[ii].Ps.begin(),
+              log.FinalStrategies()[ii].Ps.end());
+    alphas.insert(alphas.end(), log.FinalStrategies()[ii].alphas.begin(),
+                  log.FinalStrategies()[ii].alphas.end());
+  }
+}
+
+// Copy the entire spliced solution out of the splicer.
+void CopySolution(const SolutionSplicer& splicer, OperatingPoint* op,
+                  std::vector<Strategy>* strategies) {
+  *op = OperatingPoint(splicer.NumTimeSteps(), kUDims.size(), 0.0);
+  strategies->clear();
+  for (PlayerIndex ii = 0; ii < kUDims.size(); ii++)
+    strategies->emplace_back(splicer.NumTimeSteps(), kXDim, kUDims[ii]);
+
+  splicer.CopyTimeSteps(0, splicer.NumTimeSteps(), op, strategies);
+}
+
+}  // anonymous namespace
+
+// Check that repeatedly splicing in new solutions matches splicing contiguous
+// copies, including wrapping around the circular buffer.
+TEST(SolutionSplicerTest, MatchesContiguousSplicing) {
+  std::shared_ptr<const SolverLog> log = RandomLog(0.0);
+  SolutionSplicer splicer(log);
+  OperatingPoint expected_op = log->FinalOperatingPoint();
+  std::vector<Strategy> expected_strategies = log->FinalStrategies();
+
+  // Advance by varying numbers of time steps, some fewer than the number of
+  // previous time steps which are retained.
+  const std::vector<size_t> kAdvances = {1, 3, 7, 12, 2, 9, 15, 4};
+  Time t0 = 0.0;
+  for (size_t advance : kAdvances) {
+    t0 += advance * kTimeStep;
+    log = RandomLog(t0);
+    splicer.Splice(log);
+    ReferenceSplice(*log, &expected_op, &expected_strategies);
+
+    OperatingPoint op(0, kUDims.size(), 0.0);
+    std::vector<Strategy> strategies;
+    CopySolution(splicer, &op, &strategies);
+    EXPECT_NEAR(op.t0, expected_op.t0, constants::kSmallNumber);
+    EXPECT_NEAR(splicer.InitialTime(), expected_op.t0,
+                constants::kSmallNumber);
+    ASSERT_EQ(op.xs.size(), expected_op.xs.size());
+    ASSERT_EQ(splicer.NumTimeSteps(), expected_op.xs.size());
+    ASSERT_EQ(strategies.size(), expected_strategies.size());
+
+    for (size_t kk = 0; kk < op.xs.size(); kk++) {
+      EXPECT_TRUE(op.xs[kk] == expected_op.xs[kk]);
+      EXPECT_TRUE(splicer.State(kk) == expected_op.xs[kk]);
+      for (PlayerIndex ii = 0; ii < kUDims.size(); ii++) {
+        EXPECT_TRUE(op.us[kk][ii] == expected_op.us[kk][ii]);
+        EXPECT_TRUE(strategies[ii].Ps[kk] == expected_strategies[ii].Ps[kk]);
+        EXPECT_TRUE(strategies[ii].alphas[kk] ==
+                    expected_strategies[ii].alphas[kk]);
+      }
+    }
+
+    EXPECT_TRUE(splicer.ContainsTime(t0));
+    EXPECT_FALSE(splicer.ContainsTime(expected_op.t0 - kTimeStep));
+  }
+}
+
+// Check that integrating through the circular buffer matches integrating
+// along a contiguous copy of the spliced solution.
+TEST(SolutionSplicerTest, IntegratesThroughBuffer) {
+  const auto dynamics = TwoUnicycles();
+  std::shared_ptr<const SolverLog> log = RandomLog(0.0);
+  SolutionSplicer splicer(log);
+  splicer.Splice(RandomLog(7.0 * kTimeStep));
+  splicer.Splice(RandomLog(16.0 * kTimeStep));
+
+  OperatingPoint op(0, kUDims.size(), 0.0);
+  std::vector<Strategy> strategies;
+  CopySolution(splicer, &op, &strategies);
+
+  // Integrate over intervals starting at, just after, and between time steps.
+  const VectorXf x0 = VectorXf::Random(kXDim);
+  const std::vector<std::pair<Time, Time>> kIntervals = {
+      {op.t0, op.t0 + 0.35},
+      {op.t0 + 0.02, op.t0 + 0.07},
+      {op.t0 + 0.53, op.t0 + 0.58},
+      {op.t0 + 0.61, op.t0 + 1.44}};
+  for (const auto& interval : kIntervals) {
+    const VectorXf expected = dynamics->Integrate(
+        interval.first, interval.second, x0, op, strategies);
+    const VectorXf x =
+        splicer.Integrate(*dynamics, interval.first, interval.second, x0);
+    EXPECT_LT((x - expected).cwiseAbs().maxCoeff(), constants::kSmallNumber);
+  }
+}
+
+// Check that splicing in a new solution leaves the time steps which are kept
+// in place, rather than shifting them to the front of the buffer.
+TEST(SolutionSplicerTest, SplicingKeepsRetainedTimeStepsInPlace) {
+  constexpr size_t kAdvance = 7;
+  SolutionSplicer splicer(RandomLog(0.0));
+
+  const size_t first_retained = kAdvance - kNumPreviousTimeStepsToSave;
+  std::vector<const float*> retained_data;
+  std::vector<VectorXf> retained_states;
+  for (size_t kk = first_retained; kk < kAdvance; kk++) {
+    retained_data.push_back(splicer.State(kk).data());
+    retained_states.push_back(splicer.State(kk));
+  }
+
+  splicer.Splice(RandomLog(kAdvance * kTimeStep));
+  for (size_t kk = 0; kk < kNumPreviousTimeStepsToSave; kk++) {
+    EXPECT_EQ(splicer.State(kk).data(), retained_data[kk]);
+    EXPECT_TRUE(splicer.State(kk) == retained_states[kk]);
+  }
+}
+
+// Check that setting up the next receding horizon problem from a splicer only
+// writes the time steps which are new to the horizon, so long as the problem's
+// solution is the one spliced in last, and otherwise copies the entire horizon
+// out of the splicer. Time steps which are kept are still shifted to the front
+// of the problem's solution, by swapping.
+TEST(SolutionSplicerTest, ReplanWritesOnlyNewTimeSteps) {
+  constexpr size_t kMaxSolverIters = 100;
+  constexpr size_t kElapsedTimeSteps = 10;
+  constexpr Time kTimeOffset = 0.02;
+  constexpr Time kPlannerRuntime = 0.25;
+
+  SolverParams params;
+  params.max_solver_iters = kMaxSolverIters;
+  Cost::ResetInitialTime(0.0);
+  TwoPlayerCollisionExample problem(params);
+  SolutionSplicer splicer(problem.Solve());
+  const Time time_step = problem.Solver().TimeStep();
+  const size_t num_time_steps = problem.Solver().NumTimeSteps();
+
+  // Set up the next problem from a state along the spliced plan, a number of
+  // time steps after the problem's initial time, and return the number of time
+  // steps by which the initial time advances.
+  auto set_up_next_problem = [&]() {
+    const Time t0 = problem.CurrentOperatingPoint().t0;
+    const size_t kk =
+        kElapsedTimeSteps +
+        static_cast<size_t>(constants::kSmallNumber +
+                            (t0 - splicer.InitialTime()) / time_step);
+    problem.SetUpNextRecedingHorizon(
+        splicer, splicer.State(kk),
+        splicer.InitialTime() + kTimeOffset + kk * time_step,
+        kPlannerRuntime);
+    return static_cast<size_t>(
+        constants::kSmallNumber +
+        (problem.CurrentOperatingPoint().t0 - t0) / time_step);
+  };  // set_up_next_problem
+
+  size_t num_new_time_steps = set_up_next_problem();
+  EXPECT_EQ(problem.NumTimeStepsWritten(), num_new_time_steps);
+  EXPECT_LT(problem.NumTimeStepsWritten(), num_time_steps);
+
+  // Once the problem is solved again, its solution differs from the spliced
+  // plan until that solution is spliced in.
+  std::shared_ptr<const SolverLog> log = problem.Solve();
+  set_up_next_problem();
+  EXPECT_EQ(problem.NumTimeStepsWritten(), num_time_steps);
+
+  log = problem.Solve();
+  splicer.Splice(log);
+  num_new_time_steps = set_up_next_problem();
+  EXPECT_EQ(problem.NumTimeStepsWritten(), num_new_time_steps);
+  EXPECT_LT(problem.NumTimeStepsWritten(), num_time_steps);
+
+  Cost::ResetInitialTime(0.0);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2019, The Regents of the University of California (Regents).
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    1. Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *
+ *    2. Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ *    3. Neither the name of the copyright holder nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS AS IS
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Please contact the author(s) of this library if you have any questions.
+ * Authors: David Fridovich-Keil   ( dfk@eecs.berkeley.edu )
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Tests for StrategyExecutor.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <ilqgames/solver/strategy_executor.h>
+#include <ilqgames/utils/operating_point.h>
+#include <ilqgames/utils/strategy.h>
+#include <ilqgames/utils/types.h>
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace ilqgames;
+
+namespace {
+// Time parameters.
+static constexpr Time kTimeStep = 0.1;
+static constexpr Time kInitialTime = 1.0;
+static constexpr size_t kNumTimeSteps = 10;
+
+// Dimensions.
+static constexpr Dimension kXDim = 4;
+static const std::vector<Dimension> kUDims = {2, 1};
+
+// Create a random operating point and strategies.
+void RandomSolution(OperatingPoint* op, std::vector<Strategy>* strategies) {
+  *op = OperatingPoint(kNumTimeSteps, kUDims.size(), kInitialTime);
+  strategies->clear();
+  for (PlayerIndex ii = 0; ii < kUDims.size(); ii++)
+    strategies->emplace_back(kNumTimeSteps, kXDim, kUDims[ii]);
+
+  for (size_t kk = 0; kk < kNumTimeSteps; kk++) {
+    op->xs[kk] = VectorXf::Random(kXDim);
+    for (PlayerIndex ii = 0; ii < kUDims.size(); ii++) {
+      op->us[kk][ii] = VectorXf::Random(kUDims[ii]);
+      (*strategies)[ii].Ps[kk] = MatrixXf::Random(kUDims[ii], kXDim);
+      (*strategies)[ii].alphas[kk] = VectorXf::Random(kUDims[ii]);
+    }
+  }
+}
+
+}  // anonymous namespace
+
+// Check that controls match strategies at time steps, and interpolate
+// between them.
+TEST(StrategyExecutorTest, MatchesStrategies) {
+  OperatingPoint op(0, 0, 0.0);
+  std::vector<Strategy> strategies;
+  RandomSolution(&op, &strategies);
+
+  StrategyExecutor executor(kTimeStep);
+  VectorXf u(kUDims[0]);
+  EXPECT_FALSE(executor.Control(kInitialTime, op.xs[0], 0, &u));
+
+  executor.Publish(op, strategies);
+  EXPECT_EQ(executor.NumPublished(), 1);
+  EXPECT_FALSE(executor.ContainsTime(kInitialTime - 0.5 * kTimeStep));
+  EXPECT_FALSE(executor.ContainsTime(kInitialTime + kNumTimeSteps * kTimeStep));
+
+  const VectorXf x = VectorXf::Random(kXDim);
+  for (PlayerIndex ii = 0; ii < kUDims.size(); ii++) {
+    const Strategy& strategy = strategies[ii];
+    u.resize(kUDims[ii]);
+
+    for (size_t kk = 0; kk < kNumTimeSteps; kk++) {
+      const Time t = kInitialTime + kk * kTimeStep;
+      ASSERT_TRUE(executor.ContainsTime(t));
+      ASSERT_TRUE(executor.Control(t, x, ii, &u));
+      EXPECT_LT((u - strategy(kk, x - op.xs[kk], op.us[kk][ii]))
+                    .lpNorm<Eigen::Infinity>(),
+                constants::kSmallNumber);
+
+      if (kk + 1 == kNumTimeSteps) {
+        EXPECT_FALSE(executor.Control(t + 0.5 * kTimeStep, x, ii, &u));
+        continue;
+      }
+
+      // Interpolate a quarter of the way to the next time step.
+      ASSERT_TRUE(executor.Control(t + 0.25 * kTimeStep, x, ii, &u));
+      const VectorXf x_ref = 0.75 * op.xs[kk] + 0.25 * op.xs[kk + 1];
+      const VectorXf u_ref = 0.75 * op.us[kk][ii] + 0.25 * op.us[kk + 1][ii];
+      const VectorXf alpha =
+          0.75 * strategy.alphas[kk] + 0.25 * strategy.alphas[kk + 1];
+      EXPECT_LT(
+          (u - (u_ref - strategy.Ps[kk] * (x - x_ref) - alpha))
+              .lpNorm<Eigen::Infinity>(),
+          constants::kSmallNumber);
+    }
+  }
+}
+
+// Check that readers always see a complete solution while another thread
+// publishes new ones.
+TEST(StrategyExecutorTest, ReadersSeeConsistentSolutions) {
+  constexpr size_t kNumSolutions = 200;
+
+  // Solutions with zero gains, in which every control is the given constant.
+  auto constant_solution = [](float value, OperatingPoint* op,
+                              std::vector<Strategy>* strategies) {
+    RandomSolution(op, strategies);
+    for (size_t kk = 0; kk < kNumTimeSteps; kk++) {
+      for (PlayerIndex ii = 0; ii < kUDims.size(); ii++) {
+        op->us[kk][ii].setConstant(value);
+        (*strategies)[ii].Ps[kk].setZero();
+        (*strategies)[ii].alphas[kk].setZero();
+      }
+    }
+  };  // constant_solution
+
+  OperatingPoint op(0, 0, 0.0);
+  std::vector<Strategy> strategies;
+  constant_solution(0.0, &op, &strategies);
+
+  StrategyExecutor executor(kTimeStep);
+  executor.Publish(op, strategies);
+
+  std::atomic<bool> is_done(false);
+  std::thread publisher([&]() {
+    OperatingPoint next_op(0, 0, 0.0);
+    std::vector<Strategy> next_strategies;
+    for (size_t ii = 1; ii <= kNumSolutions; ii++) {
+      constant_solution(static_cast<float>(ii), &next_op, &next_strategies);
+      executor.Publish(next_op, next_strategies);
+    }
+    is_done = true;
+  });
+
+  // All controls read at once must come from the same solution, and solutions
+  // must never go back in time.
+  std::vector<VectorXf> us = {VectorXf(kUDims[0]), VectorXf(kUDims[1])};
+  const VectorXf x = VectorXf::Zero(kXDim);
+  float last_value = 0.0;
+  while (!is_done) {
+    ASSERT_TRUE(executor.Controls(kInitialTime + 0.35, x, &us));
+    const float value = us[1](0);
+    EXPECT_EQ(us[0](0), value);
+    EXPECT_EQ(us[0](1), value);
+    EXPECT_GE(value, last_value);
+    last_value = value;
+  }
+
+  publisher.join();
+  EXPECT_EQ(executor.NumPublished(), kNumSolutions + 1);
+  ASSERT_TRUE(executor.Controls(kInitialTime, x, &us));
+  EXPECT_EQ(us[0](0), static_cast<float>(kNumSolutions));
+}